@@ -1,9 +1,43 @@
 #include "Prism.hpp"
+#include <filesystem>
 #include <iostream>
+#include <string>
+
+// Usage: prism_demo [scene.yml | scene.prsnap] [--save-snapshot <file.prsnap>] [--memory-report]
+//                   [--estimate]
+// Scenes with an `animation` block render their frames to ./data/output/<scene name>/.
+// --estimate prints the predicted cost of the render instead of rendering.
+int main(int argc, char* argv[]) {
+    std::filesystem::path scene_path = argc > 1 ? argv[1] : "./data/input/scene.yml";
 
-int main() {
     try {
-        Prism::SceneParser("./data/input/scene.yml").parse().render();
+        Prism::Scene scene = scene_path.extension() == ".prsnap"
+                                 ? Prism::Scene::load_snapshot(scene_path)
+                                 : Prism::SceneParser(scene_path.string()).parse();
+
+        bool estimate = false;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--save-snapshot" && i + 1 < argc) {
+                scene.save_snapshot(argv[++i]);
+            } else if (arg == "--memory-report") {
+                std::cout << scene.memoryReport();
+            } else if (arg == "--estimate") {
+                estimate = true;
+            }
+        }
+
+        if (estimate) {
+            std::cout << scene.estimateRenderCost(scene.getRenderSettings());
+            return 0;
+        }
+
+        if (scene.getAnimation().frameCount() > 0) {
+            scene.renderSequence(scene.getAnimation(),
+                                 "./data/output/" + scene_path.stem().string());
+        } else {
+            scene.render();
+        }
 
     } catch (const std::exception& e) {
         Prism::Style::logError(e.what());
@@ -11,4 +45,4 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
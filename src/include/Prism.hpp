@@ -1,8 +1,11 @@
 #ifdef PRISM_BUILD_CORE
+#include "Prism/core/aabb.hpp"
 #include "Prism/core/color.hpp"
 #include "Prism/core/material.hpp"
 #include "Prism/core/matrix.hpp"
+#include "Prism/core/memory_report.hpp"
 #include "Prism/core/point.hpp"
+#include "Prism/core/random.hpp"
 #include "Prism/core/ray.hpp"
 #include "Prism/core/style.hpp"
 #include "Prism/core/utils.hpp"
@@ -12,15 +15,30 @@
 #ifdef PRISM_BUILD_OBJECTS
 #include "Prism/objects/Colormap.hpp"
 #include "Prism/objects/ObjReader.hpp"
+#include "Prism/objects/geometry_cache.hpp"
 #include "Prism/objects/mesh.hpp"
+#include "Prism/objects/mesh_proxy.hpp"
 #include "Prism/objects/objects.hpp"
+#include "Prism/objects/out_of_core_mesh.hpp"
 #include "Prism/objects/plane.hpp"
 #include "Prism/objects/sphere.hpp"
 #include "Prism/objects/triangle.hpp"
 #endif // PRISM_BUILD_OBJECTS
 
 #ifdef PRISM_BUILD_SCENE
+#include "Prism/scene/animation.hpp"
+#include "Prism/scene/aov.hpp"
 #include "Prism/scene/camera.hpp"
+#include "Prism/scene/checkpoint.hpp"
+#include "Prism/scene/denoiser.hpp"
+#include "Prism/scene/framebuffer.hpp"
+#include "Prism/scene/incremental.hpp"
+#include "Prism/scene/light_tree.hpp"
+#include "Prism/scene/render_cost.hpp"
+#include "Prism/scene/render_settings.hpp"
+#include "Prism/scene/trace_context.hpp"
 #include "Prism/scene/scene.hpp"
 #include "Prism/scene/scene_parser.hpp"
+#include "Prism/scene/shadow_map.hpp"
+#include "Prism/scene/visibility_buffer.hpp"
 #endif
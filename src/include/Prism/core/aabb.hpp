@@ -0,0 +1,120 @@
+#ifndef PRISM_AABB_HPP_
+#define PRISM_AABB_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/matrix.hpp"
+#include "Prism/core/point.hpp"
+#include "Prism/core/ray.hpp"
+#include "Prism/core/vector.hpp"
+
+namespace Prism {
+
+/**
+ * @class AABB
+ * @brief Represents an axis-aligned bounding box in 3D space.
+ * The box is defined by its minimum and maximum corners. A default-constructed box is empty (its
+ * minimum is greater than its maximum), so it can be grown by expanding it with points or boxes.
+ * Unbounded objects, such as planes, are described by AABB::infinite().
+ */
+class PRISM_EXPORT AABB {
+  public:
+    /**
+     * @brief Constructs an empty bounding box.
+     */
+    AABB();
+
+    /**
+     * @brief Constructs a bounding box from its minimum and maximum corners.
+     * @param min The corner with the smallest coordinates.
+     * @param max The corner with the largest coordinates.
+     */
+    AABB(const Point3& min, const Point3& max);
+
+    /**
+     * @brief Creates a bounding box that contains all of space.
+     */
+    static AABB infinite();
+
+    /**
+     * @brief Checks whether the box contains no point at all.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Checks whether the box has finite extent in every axis.
+     */
+    bool isFinite() const;
+
+    /**
+     * @brief Grows the box to contain a point.
+     * @param p The point to include.
+     */
+    void expand(const Point3& p);
+
+    /**
+     * @brief Grows the box to contain another box.
+     * @param other The box to include.
+     */
+    void expand(const AABB& other);
+
+    /**
+     * @brief Checks whether this box overlaps another box.
+     * @param other The box to test against.
+     * @return True if the boxes share at least one point.
+     */
+    bool overlaps(const AABB& other) const;
+
+    /**
+     * @brief Checks whether a point lies inside the box (boundary included).
+     */
+    bool contains(const Point3& p) const;
+
+    /**
+     * @brief Gets the distance from a point to the closest point of the box.
+     * @return 0 for points inside the box.
+     */
+    double distanceTo(const Point3& p) const;
+
+    /**
+     * @brief Gets the center of the box.
+     */
+    Point3 center() const;
+
+    /**
+     * @brief Gets the vector from the minimum to the maximum corner.
+     */
+    Vector3 diagonal() const;
+
+    /**
+     * @brief Computes the bounding box of this box after a transformation.
+     * @param m A 4x4 transformation matrix.
+     * @return The axis-aligned box enclosing the eight transformed corners.
+     */
+    AABB transformed(const Matrix& m) const;
+
+    /**
+     * @brief Checks whether a ray crosses the box within a distance range (slab test).
+     * @param ray The ray to test.
+     * @param t_min The minimum distance along the ray.
+     * @param t_max The maximum distance along the ray.
+     * @return True if part of the segment [t_min, t_max] of the ray lies inside the box.
+     */
+    bool hit(const Ray& ray, double t_min, double t_max) const;
+
+    /**
+     * @brief Computes the distance range over which a ray lies inside the box.
+     * @param ray The ray to test.
+     * @param t_min On input, the minimum distance along the ray; on output, the entry distance.
+     * @param t_max On input, the maximum distance along the ray; on output, the exit distance.
+     * @return True if the ray crosses the box within the given range.
+     */
+    bool clip(const Ray& ray, double& t_min, double& t_max) const;
+
+    Point3 min; ///< The corner with the smallest coordinates
+    Point3 max; ///< The corner with the largest coordinates
+};
+
+} // namespace Prism
+
+#endif // PRISM_AABB_HPP_
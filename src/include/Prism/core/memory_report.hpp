@@ -0,0 +1,66 @@
+#ifndef PRISM_MEMORY_REPORT_HPP_
+#define PRISM_MEMORY_REPORT_HPP_
+
+#include "prism_export.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+namespace Prism {
+
+class Matrix;   // Forward declaration of Matrix class
+class Material; // Forward declaration of Material class
+
+/**
+ * @struct MemoryReport
+ * @brief A breakdown of the bytes held by a scene, by category.
+ * Objects add their own footprint through Object::accountMemory(). Data shared between objects
+ * (materials, caches) is counted once, the first time it is seen through countOnce().
+ */
+struct PRISM_EXPORT MemoryReport {
+    size_t geometry = 0;     ///< Vertex positions, normals and primitive parameters
+    size_t indices = 0;      ///< Face index arrays
+    size_t acceleration = 0; ///< Bounding boxes, cluster tables and other culling structures
+    size_t transforms = 0;   ///< Transformation matrices and their inverses
+    size_t materials = 0;    ///< Material definitions
+    size_t framebuffer = 0;  ///< The rendered image
+    size_t other = 0;        ///< Object headers, lights and the camera
+
+    /**
+     * @brief Gets the sum of all categories.
+     */
+    size_t total() const;
+
+    /**
+     * @brief Checks whether shared data is being counted for the first time.
+     * @param shared The address of the shared data.
+     * @return True the first time an address is passed, false afterwards.
+     */
+    bool countOnce(const void* shared);
+
+    /**
+     * @brief Counts a matrix (its header and its element storage) as transform data.
+     */
+    void addTransform(const Matrix& matrix);
+
+    /**
+     * @brief Counts a material, unless it was already counted for another object.
+     */
+    void addMaterial(const Material* material);
+
+    /**
+     * @brief Formats the report as one line per category, sizes in KiB.
+     */
+    std::string toString() const;
+
+  private:
+    std::unordered_set<const void*> counted_; ///< Shared data that was already counted
+};
+
+PRISM_EXPORT std::ostream& operator<<(std::ostream& os, const MemoryReport& report);
+
+} // namespace Prism
+
+#endif // PRISM_MEMORY_REPORT_HPP_
@@ -0,0 +1,111 @@
+#ifndef PRISM_RANDOM_HPP_
+#define PRISM_RANDOM_HPP_
+
+#include "prism_export.h"
+
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @class Rng
+ * @brief A small, fast pseudo-random number generator (PCG32).
+ * Renders must be reproducible, so random decisions never come from a global generator. Instead,
+ * each pixel derives its own generator from the render seed and its coordinates with forPixel(),
+ * which makes the result independent of the order (or the thread) in which pixels are rendered.
+ */
+class PRISM_EXPORT Rng {
+  public:
+    /**
+     * @brief Constructs a generator.
+     * @param seed The starting state.
+     * @param stream Selects one of 2^63 independent sequences for the same seed.
+     */
+    explicit Rng(uint64_t seed = 0, uint64_t stream = 0) : state(0), increment((stream << 1) | 1) {
+        nextUInt();
+        state += seed;
+        nextUInt();
+    }
+
+    /**
+     * @brief Creates the generator of a pixel.
+     * @param seed The seed of the render.
+     * @param x The column of the pixel.
+     * @param y The row of the pixel.
+     * @param round Distinguishes successive batches of samples of the same pixel.
+     */
+    static Rng forPixel(uint64_t seed, int x, int y, uint32_t round = 0) {
+        uint64_t pixel = (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) |
+                         static_cast<uint32_t>(x);
+        return Rng(mix(seed ^ mix(pixel)), round);
+    }
+
+    /**
+     * @brief Gets the next 32 random bits.
+     */
+    uint32_t nextUInt() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    /**
+     * @brief Gets a uniformly distributed number in [0, 1).
+     */
+    double nextDouble() {
+        return nextUInt() * (1.0 / 4294967296.0);
+    }
+
+  private:
+    // SplitMix64 finalizer, spreads nearby seeds (e.g. neighbouring pixels) apart
+    static uint64_t mix(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state;     ///< Current state of the generator
+    uint64_t increment; ///< Selects the sequence; always odd
+};
+
+/**
+ * @brief Generates stratified, jittered positions inside the unit square.
+ * Square counts use a jittered grid; other counts use one jittered stratum per sample on each
+ * axis, with the strata of the second axis shuffled (n-rooks sampling).
+ * @param count The number of positions.
+ * @param rng The generator of the jitter.
+ * @param offsets Cleared, then receives the positions.
+ */
+inline void stratifiedOffsets(int count, Rng& rng,
+                              std::vector<std::pair<double, double>>& offsets) {
+    offsets.clear();
+    int grid = static_cast<int>(std::lround(std::sqrt(static_cast<double>(count))));
+    if (grid * grid == count) {
+        for (int j = 0; j < grid; ++j) {
+            for (int i = 0; i < grid; ++i) {
+                offsets.emplace_back((i + rng.nextDouble()) / grid, (j + rng.nextDouble()) / grid);
+            }
+        }
+        return;
+    }
+
+    std::vector<int> rows(count);
+    std::iota(rows.begin(), rows.end(), 0);
+    for (int i = count - 1; i > 0; --i) {
+        std::swap(rows[i], rows[rng.nextUInt() % static_cast<uint32_t>(i + 1)]);
+    }
+    for (int i = 0; i < count; ++i) {
+        offsets.emplace_back((i + rng.nextDouble()) / count, (rows[i] + rng.nextDouble()) / count);
+    }
+}
+
+} // namespace Prism
+
+#endif // PRISM_RANDOM_HPP_
@@ -0,0 +1,145 @@
+#ifndef PRISM_GEOMETRY_CACHE_HPP_
+#define PRISM_GEOMETRY_CACHE_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/point.hpp"
+#include "Prism/core/vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct GeometryCluster
+ * @brief A spatially compact group of triangles paged in as one unit by the GeometryCache.
+ * Triangles are stored de-indexed (three positions and three normals each), so a cluster can be
+ * intersected without any other part of its mesh being resident.
+ */
+struct PRISM_EXPORT GeometryCluster {
+    std::vector<Point3> vertices; ///< Three consecutive positions per triangle
+    std::vector<Vector3> normals; ///< Three consecutive vertex normals per triangle
+
+    /**
+     * @brief Gets the number of bytes this cluster accounts for in the cache budget.
+     */
+    size_t byteSize() const;
+};
+
+/**
+ * @class GeometryCache
+ * @brief A bounded, thread-safe cache of geometry clusters with least-recently-used eviction.
+ *
+ * Out-of-core meshes page their clusters in through this cache. When the resident size exceeds the
+ * budget, the least recently used clusters are dropped. Clusters are handed out as shared
+ * pointers, so a cluster evicted while a ray is still intersecting it stays alive until that ray is
+ * done: eviction never invalidates an ongoing traversal. The budget therefore bounds the cached
+ * data; clusters pinned by in-flight rays may briefly exceed it.
+ */
+class PRISM_EXPORT GeometryCache {
+  public:
+    /**
+     * @struct Stats
+     * @brief Residency and miss statistics of the cache.
+     */
+    struct Stats {
+        uint64_t hits = 0;              ///< Requests served from resident clusters
+        uint64_t misses = 0;            ///< Requests that had to load a cluster
+        uint64_t evictions = 0;         ///< Clusters dropped to stay within the budget
+        size_t resident_bytes = 0;      ///< Bytes of cluster data currently resident
+        size_t resident_clusters = 0;   ///< Number of clusters currently resident
+        size_t peak_resident_bytes = 0; ///< Largest resident size observed
+        size_t budget_bytes = 0;        ///< The configured budget
+
+        /**
+         * @brief Gets the fraction of requests that missed the cache.
+         */
+        double missRate() const {
+            uint64_t total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(misses) / static_cast<double>(total);
+        }
+    };
+
+    using Loader = std::function<std::shared_ptr<const GeometryCluster>()>;
+
+    /**
+     * @brief Constructs a cache with a byte budget.
+     * @param budget_bytes The maximum number of bytes of resident cluster data.
+     */
+    explicit GeometryCache(size_t budget_bytes = kDefaultBudget);
+
+    /**
+     * @brief Gets the cache shared by all out-of-core meshes.
+     */
+    static GeometryCache& instance();
+
+    /**
+     * @brief Changes the budget, evicting clusters immediately if needed.
+     * @param budget_bytes The maximum number of bytes of resident cluster data.
+     */
+    void setBudget(size_t budget_bytes);
+
+    /**
+     * @brief Gets the configured budget in bytes.
+     */
+    size_t budget() const;
+
+    /**
+     * @brief Gets a cluster, loading it on a miss.
+     * @param owner A unique identifier of the mesh the cluster belongs to.
+     * @param cluster The index of the cluster within its mesh.
+     * @param load Loads the cluster from backing storage. Called without the cache lock held.
+     * @return The resident cluster. The caller keeps it alive for as long as it holds the pointer.
+     */
+    std::shared_ptr<const GeometryCluster> acquire(uint64_t owner, uint32_t cluster,
+                                                   const Loader& load);
+
+    /**
+     * @brief Drops every resident cluster of a mesh.
+     * @param owner The identifier of the mesh.
+     */
+    void evictOwner(uint64_t owner);
+
+    /**
+     * @brief Drops every resident cluster.
+     */
+    void clear();
+
+    /**
+     * @brief Gets a copy of the current statistics.
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Resets the hit, miss and eviction counters (residency is kept).
+     */
+    void resetStats();
+
+    static constexpr size_t kDefaultBudget = size_t(512) << 20; ///< 512 MiB
+
+  private:
+    struct Entry {
+        uint64_t key;
+        std::shared_ptr<const GeometryCluster> cluster;
+        size_t bytes;
+    };
+
+    static uint64_t makeKey(uint64_t owner, uint32_t cluster);
+    void evictToBudget(); // Requires mutex_ to be held
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_; ///< Most recently used at the front
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    Stats stats_;
+};
+
+} // namespace Prism
+
+#endif // PRISM_GEOMETRY_CACHE_HPP_
@@ -7,6 +7,7 @@
 #include "Prism/core/point.hpp"
 #include "Prism/core/ray.hpp"
 #include "Prism/objects/ObjReader.hpp"
+#include "Prism/objects/mesh_lod.hpp"
 #include "Prism/objects/objects.hpp"
 #include "Prism/objects/triangle.hpp"
 
@@ -43,6 +44,18 @@ class PRISM_EXPORT Mesh : public Object {
      */
     explicit Mesh(ObjReader& reader);
 
+    /**
+     * @brief Constructs a Mesh object from flat geometry arrays.
+     * @param vertices The vertex positions of the mesh.
+     * @param normals The vertex normals of the mesh.
+     * @param faces The triangles of the mesh, as indices into vertices and normals.
+     * @param material The material of the mesh.
+     * This constructor is used when the geometry does not come from an OBJ file, e.g. when a scene
+     * is restored from a binary snapshot.
+     */
+    Mesh(std::vector<Point3> vertices, std::vector<Vector3> normals,
+         std::vector<ObjReader::FaceIndices> faces, std::shared_ptr<Material> material);
+
     /**
      * @brief Checks if a ray intersects with the mesh.
      * @param ray The ray to test for intersection with the mesh.
@@ -56,15 +69,123 @@ class PRISM_EXPORT Mesh : public Object {
      */
     virtual bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
 
+    /**
+     * @brief Gets the world-space bounding box of the mesh.
+     */
+    AABB boundingBox() const override;
+
+    /**
+     * @brief Emits the triangles of the current level of detail; primitives are face indices.
+     */
+    Tessellation tessellate(const TriangleSink& sink) const override;
+
+    /**
+     * @brief Checks if a ray hits one face of the current level of detail.
+     */
+    bool hitPrimitive(const Ray& ray, uint32_t primitive, double t_min, double t_max,
+                      HitRecord& rec) const override;
+
+    /**
+     * @brief Adds the memory held by the mesh to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
     void setMaterial(std::shared_ptr<Material> new_material);
 
+    /**
+     * @brief Gets the material of the mesh.
+     * @return A shared pointer to the mesh material.
+     */
+    std::shared_ptr<Material> getMaterial() const override;
+
+    /**
+     * @brief Gets the vertex positions of the mesh, in object space.
+     */
+    const std::vector<Point3>& getVertices() const;
+
+    /**
+     * @brief Gets the vertex normals of the mesh, in object space.
+     */
+    const std::vector<Vector3>& getNormals() const;
+
+    /**
+     * @brief Gets the triangles of the mesh, as indices into the vertex and normal arrays.
+     */
+    const std::vector<ObjReader::FaceIndices>& getFaces() const;
+
+    /**
+     * @brief Gets the bounding box of the mesh vertices, in object space.
+     */
+    const AABB& getLocalBounds() const;
+
+    /**
+     * @brief Generates simplified levels of detail with simplifyMesh().
+     * @param count The number of levels to add after the coarsest existing one.
+     * @param ratio The number of triangles of each level relative to the previous one.
+     * Stops early once a level has too few triangles to simplify further.
+     */
+    void generateLevels(int count, double ratio = 0.25);
+
+    /**
+     * @brief Adds a level of detail coarser than the existing ones (e.g. read from a file).
+     */
+    void addLevel(MeshLevel level);
+
+    /**
+     * @brief Sets how the level of detail is chosen.
+     * @throws std::runtime_error if the pinned level does not exist.
+     * Pinning a level makes it the geometry of the mesh and frees the other levels.
+     */
+    void setLodSettings(const LodSettings& settings);
+
+    /**
+     * @brief Gets how the level of detail is chosen.
+     */
+    const LodSettings& getLodSettings() const;
+
+    /**
+     * @brief Chooses the level of detail from the projected size of the mesh.
+     */
+    void setViewpoint(const Point3& eye, double pixel_angle) override;
+
+    /**
+     * @brief Gets the number of levels of detail, the full mesh included.
+     */
+    size_t levelCount() const;
+
+    /**
+     * @brief Gets the level of detail that rays intersect.
+     */
+    size_t currentLevel() const;
+
+    /**
+     * @brief Gets the number of triangles of a level of detail.
+     */
+    size_t levelFaceCount(size_t level) const;
+
+    /**
+     * @brief Gets the geometry of a simplified level of detail.
+     * @param level The level, from 1 (the finest simplified level) to levelCount() - 1.
+     * @throws std::out_of_range if the level does not exist.
+     */
+    const MeshLevel& getLevel(size_t level) const;
+
   private:
-    std::vector<std::shared_ptr<Point3>> points;   ///< Points that define the vertices of the mesh
-    std::vector<std::shared_ptr<Vector3>> normals; ///< Normals for each vertex in the mesh
-    std::vector<MeshTriangle>
-        mesh; ///< Triangles that make up the mesh, each defined by three points
+    void computeBounds();
+
+    // Completes a hit found on the object-space ray: world-space point, distance and normal
+    bool finishHit(const Ray& ray, const Ray& transformed_ray, double t_min, double t_max,
+                   HitRecord& rec) const;
+
+    std::vector<Point3> vertices;               ///< Points that define the vertices of the mesh
+    std::vector<Vector3> normals;               ///< Normals for each vertex in the mesh
+    std::vector<ObjReader::FaceIndices> faces; ///< Triangles that make up the mesh, as indices
+    AABB bounds; ///< Object-space bounding box of the vertices, used to skip missed meshes
     std::shared_ptr<Material>
         material; ///< Material properties of the mesh, defining how it interacts with light
+    std::vector<MeshLevel> levels; ///< Simplified levels of detail, from finest to coarsest
+    LodSettings lod;               ///< How the level of detail is chosen
+    size_t level = 0;              ///< Level intersected by rays, 0 for the full mesh
 };
 
 } // namespace Prism
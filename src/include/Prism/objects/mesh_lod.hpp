@@ -0,0 +1,61 @@
+#ifndef PRISM_MESH_LOD_HPP_
+#define PRISM_MESH_LOD_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/point.hpp"
+#include "Prism/core/vector.hpp"
+#include "Prism/objects/ObjReader.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct MeshLevel
+ * @brief The geometry of one level of detail of a mesh: vertex positions, vertex normals and
+ * triangles indexing both.
+ */
+struct PRISM_EXPORT MeshLevel {
+    std::vector<Point3> vertices;
+    std::vector<Vector3> normals;
+    std::vector<ObjReader::FaceIndices> faces;
+
+    /**
+     * @brief Reads a level from an OBJ file (the file's materials are ignored).
+     * @throws std::runtime_error if the file has no triangles.
+     */
+    static MeshLevel fromObj(const std::string& path);
+};
+
+/**
+ * @struct LodSettings
+ * @brief Controls how a mesh chooses among its levels of detail.
+ * The level is chosen per object from the camera: the bounding sphere of the mesh is projected
+ * on the image, and the finest level whose triangles still cover about `triangle_pixels` pixels
+ * each is used. Pinning a level keeps only that one in memory.
+ */
+struct PRISM_EXPORT LodSettings {
+    double triangle_pixels = 0.5; ///< Smallest projected pixels per triangle of the chosen level
+    int pinned = -1;              ///< Level used whatever the camera (0 is the full mesh), or -1
+};
+
+/**
+ * @brief Simplifies a triangle mesh by quadric error edge collapses (Garland and Heckbert).
+ * @param mesh The mesh to simplify.
+ * @param target_faces The number of triangles to stop at.
+ * @return The simplified mesh, with one normal per vertex.
+ *
+ * Vertices at the same position are welded first, so meshes whose faces do not share vertices
+ * simplify as well. Every vertex accumulates the quadric of the planes of its triangles, and the
+ * edge whose collapse to the point minimizing the combined quadric adds the least error is
+ * collapsed first. Boundary edges are held in place by extra planes perpendicular to their
+ * triangle, and collapses that would flip a triangle are rejected. The normals of the original
+ * vertices merged into a simplified vertex are averaged, so smooth shading carries over.
+ */
+PRISM_EXPORT MeshLevel simplifyMesh(const MeshLevel& mesh, size_t target_faces);
+
+} // namespace Prism
+
+#endif // PRISM_MESH_LOD_HPP_
@@ -0,0 +1,109 @@
+#ifndef PRISM_MESH_PROXY_HPP_
+#define PRISM_MESH_PROXY_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/aabb.hpp"
+#include "Prism/core/material.hpp"
+#include "Prism/core/ray.hpp"
+#include "Prism/objects/mesh.hpp"
+#include "Prism/objects/objects.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace Prism {
+
+/**
+ * @class MeshProxy
+ * @brief A lightweight stand-in for a Mesh that loads its geometry on demand.
+ * The proxy only knows the object-space bounding box of the mesh. The OBJ file is read the first
+ * time a ray reaches those bounds, so meshes that are never seen are never loaded. Loading is
+ * guarded by a std::once_flag: when several render threads reach the proxy at the same time, only
+ * one of them loads the mesh and the others wait for it.
+ */
+class PRISM_EXPORT MeshProxy : public Object {
+  public:
+    /**
+     * @brief Constructs a MeshProxy for an OBJ file with known bounds.
+     * @param path The file path to the OBJ file containing the mesh data.
+     * @param bounds The object-space bounding box of the mesh.
+     * @param material An optional material that overrides the one from the OBJ/MTL files.
+     */
+    MeshProxy(std::filesystem::path path, const AABB& bounds,
+              std::shared_ptr<Material> material = nullptr);
+
+    /**
+     * @brief Reads the object-space bounds of an OBJ file through a bounds cache.
+     * @param path The file path to the OBJ file.
+     * @return The bounding box of the vertices of the OBJ file.
+     * The bounds are read from the `<path>.bounds` cache header when it matches the size and
+     * modification time of the OBJ file. Otherwise the vertex positions of the OBJ file are
+     * scanned (without building any geometry) and the cache is rewritten for the next run.
+     */
+    static AABB readBounds(const std::filesystem::path& path);
+
+    /**
+     * @brief Checks if a ray intersects with the proxied mesh.
+     * @param ray The ray to test for intersection with the mesh.
+     * @param t_min The minimum distance for a valid hit.
+     * @param t_max The maximum distance for a valid hit.
+     * @param rec The hit record to be filled with intersection details if a hit occurs.
+     * @return True if the ray intersects the mesh. Rays that miss the proxy bounds never cause the
+     * mesh to be loaded.
+     */
+    bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
+
+    /**
+     * @brief Gets the world-space bounding box of the proxy.
+     */
+    AABB boundingBox() const override;
+
+    /**
+     * @brief Emits the triangles of the mesh, only once it is loaded (tessellating never loads
+     * it).
+     */
+    Tessellation tessellate(const TriangleSink& sink) const override;
+
+    /**
+     * @brief Checks if a ray hits one face of the mesh.
+     */
+    bool hitPrimitive(const Ray& ray, uint32_t primitive, double t_min, double t_max,
+                      HitRecord& rec) const override;
+
+    /**
+     * @brief Adds the memory held by the proxy and its loaded mesh to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
+    /**
+     * @brief Checks whether the geometry has been loaded already.
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Gets the proxied mesh, loading it first if needed.
+     * @return The fully loaded Mesh, with the proxy transformation applied.
+     */
+    const Mesh& geometry() const;
+
+  protected:
+    void transformChanged() override;
+
+  private:
+    void load() const;
+
+    std::filesystem::path path;         ///< The OBJ file holding the geometry
+    AABB bounds;                        ///< Object-space bounds declared for the geometry
+    std::shared_ptr<Material> material; ///< Material override, or null to keep the OBJ material
+
+    mutable std::once_flag load_flag;        ///< Ensures the geometry is loaded exactly once
+    mutable std::unique_ptr<Mesh> mesh;      ///< The geometry, once loaded
+    mutable std::atomic<bool> loaded{false}; ///< Set once the geometry is ready to be used
+};
+
+} // namespace Prism
+
+#endif // PRISM_MESH_PROXY_HPP_
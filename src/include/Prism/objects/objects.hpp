@@ -3,11 +3,15 @@
 
 #include "prism_export.h"
 
+#include "Prism/core/aabb.hpp"
 #include "Prism/core/matrix.hpp"
+#include "Prism/core/memory_report.hpp"
 #include "Prism/core/point.hpp"
 #include "Prism/core/ray.hpp"
 #include "Prism/core/vector.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 
 namespace Prism {
@@ -34,6 +38,22 @@ struct PRISM_EXPORT HitRecord {
     }
 };
 
+/**
+ * @brief Receives the world-space triangles of a tessellated object (see Object::tessellate()),
+ * with the index of the primitive each one stands for.
+ */
+using TriangleSink = std::function<void(uint32_t primitive, const Point3& p1, const Point3& p2,
+                                        const Point3& p3)>;
+
+/**
+ * @brief How the triangles emitted by Object::tessellate() relate to the surface of the object.
+ */
+enum class Tessellation {
+    None,      ///< The object cannot be tessellated; nothing was emitted
+    Exact,     ///< The triangles are the surface
+    Enclosing, ///< The triangles enclose a curved surface, seen on or behind them from outside
+};
+
 /**
  * @class Object
  * @brief Abstract base class for all objects in the scene.
@@ -55,6 +75,71 @@ class PRISM_EXPORT Object {
      */
     virtual bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const = 0;
 
+    /**
+     * @brief Gets the world-space bounding box of the object.
+     * @return An AABB enclosing the object after its transformation. The default implementation
+     * returns AABB::infinite(), which is correct (if conservative) for any object.
+     */
+    virtual AABB boundingBox() const {
+        return AABB::infinite();
+    }
+
+    /**
+     * @brief Covers the object with world-space triangles, for rasterization.
+     * @param sink Receives the triangles.
+     * @return How the triangles cover the object, Tessellation::None if it cannot be tessellated
+     * (e.g. it is unbounded, or its geometry is not resident). A ray through a triangle finds its
+     * hit with hitPrimitive() on the triangle's primitive. The default implementation returns
+     * Tessellation::None.
+     */
+    virtual Tessellation tessellate(const TriangleSink& sink) const {
+        (void)sink;
+        return Tessellation::None;
+    }
+
+    /**
+     * @brief Checks if a ray hits one primitive of the object.
+     * @param primitive A primitive index emitted by tessellate().
+     * The other parameters and the result are those of hit(). The default implementation tests
+     * the whole object, which suits objects tessellated into a single primitive.
+     */
+    virtual bool hitPrimitive(const Ray& ray, uint32_t primitive, double t_min, double t_max,
+                              HitRecord& rec) const {
+        (void)primitive;
+        return hit(ray, t_min, t_max, rec);
+    }
+
+    /**
+     * @brief Adds the memory held by the object to a report.
+     * @param report The report to add to.
+     * The default implementation counts the transformation matrices and the object header only;
+     * objects that own geometry or materials override it to count them as well.
+     */
+    virtual void accountMemory(MemoryReport& report) const {
+        accountTransforms(report);
+    }
+
+    /**
+     * @brief Gets the material the object's hits are shaded with.
+     * @return The material, or null when the object has none of its own (e.g. its faces come
+     * with the materials of their file). The default implementation returns null.
+     */
+    virtual std::shared_ptr<Material> getMaterial() const {
+        return nullptr;
+    }
+
+    /**
+     * @brief Tells the object where it is seen from, before rendering.
+     * @param eye The position of the camera, in world space.
+     * @param pixel_angle The angle covered by one pixel of the image, in radians.
+     * Called by the scene whenever the camera or the object moves. Objects with several levels of
+     * detail choose one from it; the default implementation does nothing.
+     */
+    virtual void setViewpoint(const Point3& eye, double pixel_angle) {
+        (void)eye;
+        (void)pixel_angle;
+    }
+
     /**
      * @brief Gets the transformation matrix of the object.
      * @param The transformation matrix.
@@ -64,6 +149,21 @@ class PRISM_EXPORT Object {
         transform = new_transform;
         inverseTransform = transform.inverse();
         inverseTransposeTransform = inverseTransform.transpose();
+        transformChanged();
+    }
+
+    /**
+     * @brief Sets the transformation matrix of the object together with its precomputed inverse.
+     * @param new_transform The transformation matrix.
+     * @param new_inverse The inverse of new_transform.
+     * Used when the inverse is already known (e.g. restored from a scene snapshot), to avoid
+     * recomputing Matrix::inverse() for every object.
+     */
+    void setTransform(const Matrix& new_transform, const Matrix& new_inverse) {
+        transform = new_transform;
+        inverseTransform = new_inverse;
+        inverseTransposeTransform = inverseTransform.transpose();
+        transformChanged();
     }
 
     /**
@@ -76,7 +176,32 @@ class PRISM_EXPORT Object {
         return transform;
     }
 
+    /**
+     * @brief Gets the inverse of the transformation matrix of the object.
+     * @return The inverse transformation matrix, mapping world space to object space.
+     */
+    Matrix getInverseTransform() const {
+        return inverseTransform;
+    }
+
   protected:
+    /**
+     * @brief Called after the transformation of the object has changed.
+     * Objects that cache data derived from their transformation override this to refresh it.
+     */
+    virtual void transformChanged() {
+    }
+
+    /**
+     * @brief Counts the transformation matrices and the base object header in a report.
+     */
+    void accountTransforms(MemoryReport& report) const {
+        report.other += sizeof(Object) - 3 * sizeof(Matrix);
+        report.addTransform(transform);
+        report.addTransform(inverseTransform);
+        report.addTransform(inverseTransposeTransform);
+    }
+
     Matrix transform = Matrix::identity(4);        ///< Transformation matrix for the object
     Matrix inverseTransform = Matrix::identity(4); ///< Inverse of the transformation matrix
     Matrix inverseTransposeTransform =
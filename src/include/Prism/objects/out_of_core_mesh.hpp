@@ -0,0 +1,155 @@
+#ifndef PRISM_OUT_OF_CORE_MESH_HPP_
+#define PRISM_OUT_OF_CORE_MESH_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/aabb.hpp"
+#include "Prism/core/material.hpp"
+#include "Prism/core/ray.hpp"
+#include "Prism/objects/geometry_cache.hpp"
+#include "Prism/objects/mesh.hpp"
+#include "Prism/objects/objects.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @class OutOfCoreMesh
+ * @brief A triangle mesh whose geometry lives in a backing file and is paged in on demand.
+ *
+ * The triangles are sorted along a Morton curve and split into clusters of neighbouring triangles,
+ * which are written to a binary backing file. Only the cluster table (bounds and file offsets) is
+ * kept in memory; the clusters themselves are read through a GeometryCache, which keeps the
+ * resident geometry within its budget. Rays visit the clusters they cross front to back and stop
+ * as soon as the next cluster starts beyond the closest hit, so clusters hidden behind others are
+ * rarely paged in.
+ */
+class PRISM_EXPORT OutOfCoreMesh : public Object {
+  public:
+    static constexpr size_t kDefaultClusterTriangles = 256; ///< Triangles per cluster
+
+    /**
+     * @brief Opens an existing backing file.
+     * @param backing_path The cluster file written by build() or fromObj().
+     * @param cache The cache clusters are paged through.
+     * @throws std::runtime_error If the file is missing or is not a valid cluster file.
+     */
+    explicit OutOfCoreMesh(std::filesystem::path backing_path,
+                           GeometryCache& cache = GeometryCache::instance());
+
+    ~OutOfCoreMesh() override;
+
+    OutOfCoreMesh(const OutOfCoreMesh&) = delete;
+    OutOfCoreMesh& operator=(const OutOfCoreMesh&) = delete;
+
+    /**
+     * @brief Writes the geometry of a mesh to a backing file and opens it.
+     * @param mesh The in-memory mesh to convert. Its transformation is not copied.
+     * @param backing_path Where to write the cluster file.
+     * @param cluster_triangles The maximum number of triangles per cluster.
+     * @param cache The cache clusters are paged through.
+     */
+    static std::unique_ptr<OutOfCoreMesh>
+    build(const Mesh& mesh, const std::filesystem::path& backing_path,
+          size_t cluster_triangles = kDefaultClusterTriangles,
+          GeometryCache& cache = GeometryCache::instance());
+
+    /**
+     * @brief Opens the backing file of an OBJ file, building it first if needed.
+     * @param obj_path The OBJ file holding the geometry.
+     * @param cluster_triangles The maximum number of triangles per cluster.
+     * @param cache The cache clusters are paged through.
+     * The backing file is `<obj_path>.prclusters`. It is reused when it was built from the same
+     * OBJ file (same size and modification time) with the same cluster size, so the OBJ is only
+     * parsed on the first run.
+     */
+    static std::unique_ptr<OutOfCoreMesh>
+    fromObj(const std::filesystem::path& obj_path,
+            size_t cluster_triangles = kDefaultClusterTriangles,
+            GeometryCache& cache = GeometryCache::instance());
+
+    /**
+     * @brief Checks if a ray intersects with the mesh.
+     * @param ray The ray to test for intersection with the mesh.
+     * @param t_min The minimum distance for a valid hit.
+     * @param t_max The maximum distance for a valid hit.
+     * @param rec The hit record to be filled with intersection details if a hit occurs.
+     * @return True if the ray intersects with the mesh within the specified distance range.
+     */
+    bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
+
+    /**
+     * @brief Gets the world-space bounding box of the mesh.
+     */
+    AABB boundingBox() const override;
+
+    /**
+     * @brief Adds the memory held by the mesh outside of the geometry cache to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
+    void setMaterial(std::shared_ptr<Material> new_material);
+
+    /**
+     * @brief Gets the material of the mesh.
+     */
+    std::shared_ptr<Material> getMaterial() const override;
+
+    /**
+     * @brief Gets the bounding box of the mesh, in object space.
+     */
+    const AABB& getLocalBounds() const;
+
+    /**
+     * @brief Gets the path of the backing file.
+     */
+    const std::filesystem::path& getBackingPath() const;
+
+    /**
+     * @brief Gets the number of clusters in the backing file.
+     */
+    size_t clusterCount() const;
+
+    /**
+     * @brief Gets the number of triangles of the mesh.
+     */
+    size_t triangleCount() const;
+
+    /**
+     * @brief Gets a cluster, paging it in through the cache if needed.
+     * @param index The index of the cluster, in Morton order.
+     */
+    std::shared_ptr<const GeometryCluster> cluster(size_t index) const;
+
+  private:
+    struct ClusterInfo {
+        AABB bounds;             ///< Object-space bounds of the cluster triangles
+        uint64_t offset;         ///< Byte offset of the cluster data in the backing file
+        uint32_t triangle_count; ///< Number of triangles in the cluster
+    };
+
+    static void write(const Mesh& mesh, const std::filesystem::path& backing_path,
+                      size_t cluster_triangles, uint64_t source_size, int64_t source_mtime);
+    std::shared_ptr<const GeometryCluster> loadCluster(size_t index) const;
+
+    std::filesystem::path backing_path;  ///< The cluster file holding the geometry
+    GeometryCache* cache;                ///< The cache clusters are paged through
+    uint64_t cache_id;                   ///< Identifies the clusters of this mesh in the cache
+    std::vector<ClusterInfo> clusters;   ///< The cluster table, in Morton order
+    size_t triangle_count = 0;           ///< Total number of triangles
+    AABB bounds;                         ///< Object-space bounding box of the mesh
+    std::shared_ptr<Material> material;  ///< Material of the mesh
+
+    mutable std::mutex file_mutex; ///< Serializes reads from the backing file
+    mutable std::ifstream file;    ///< The open backing file
+};
+
+} // namespace Prism
+
+#endif // PRISM_OUT_OF_CORE_MESH_HPP_
@@ -37,6 +37,26 @@ class PRISM_EXPORT Plane : public Object {
      */
     virtual bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
 
+    /**
+     * @brief Adds the memory held by the plane to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
+    /**
+     * @brief Gets the point on the plane, in object space.
+     */
+    Point3 getPoint() const;
+
+    /**
+     * @brief Gets the normal vector of the plane, in object space.
+     */
+    Vector3 getNormal() const;
+
+    /**
+     * @brief Gets the material of the plane.
+     */
+    std::shared_ptr<Material> getMaterial() const override;
+
   private:
     Point3 point_on_plane; ///< A point on the plane
     Vector3 normal;        ///< The normal vector of the plane
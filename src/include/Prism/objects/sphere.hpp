@@ -41,6 +41,36 @@ class PRISM_EXPORT Sphere : public Object {
      */
     virtual bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
 
+    /**
+     * @brief Gets the world-space bounding box of the sphere.
+     */
+    AABB boundingBox() const override;
+
+    /**
+     * @brief Encloses the sphere in a polyhedron of latitude-longitude quads, as primitive 0.
+     */
+    Tessellation tessellate(const TriangleSink& sink) const override;
+
+    /**
+     * @brief Adds the memory held by the sphere to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
+    /**
+     * @brief Gets the center of the sphere, in object space.
+     */
+    Point3 getCenter() const;
+
+    /**
+     * @brief Gets the radius of the sphere, in object space.
+     */
+    double getRadius() const;
+
+    /**
+     * @brief Gets the material of the sphere.
+     */
+    std::shared_ptr<Material> getMaterial() const override;
+
   private:
     Point3 center; ///< The center point of the sphere
     double radius; ///< The radius of the sphere
@@ -57,6 +57,12 @@ class PRISM_EXPORT Triangle : public Object {
      */
     Point3 getPoint3() const;
 
+    /**
+     * @brief Gets the material of the triangle.
+     * @return A shared pointer to the triangle material.
+     */
+    std::shared_ptr<Material> getMaterial() const override;
+
     /**
      * @brief Checks if a ray intersects with the triangle.
      * @param ray The Ray to test for intersection with the triangle.
@@ -70,6 +76,21 @@ class PRISM_EXPORT Triangle : public Object {
      */
     virtual bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override;
 
+    /**
+     * @brief Gets the world-space bounding box of the triangle.
+     */
+    AABB boundingBox() const override;
+
+    /**
+     * @brief Emits the triangle itself, as primitive 0.
+     */
+    Tessellation tessellate(const TriangleSink& sink) const override;
+
+    /**
+     * @brief Adds the memory held by the triangle to a report.
+     */
+    void accountMemory(MemoryReport& report) const override;
+
   private:
     Point3 point1; ///< The first vertex of the triangle
     Point3 point2; ///< The second vertex of the triangle
@@ -158,6 +179,26 @@ class PRISM_EXPORT MeshTriangle {
     std::shared_ptr<Vector3> normal3; ///< The normal vector at the third point
 };
 
+/**
+ * @brief Checks if a ray intersects a triangle with per-vertex normals.
+ * @param ray The Ray to test, in the same space as the vertices.
+ * @param p1 The first vertex of the triangle.
+ * @param p2 The second vertex of the triangle.
+ * @param p3 The third vertex of the triangle.
+ * @param n1 The normal vector at the first vertex.
+ * @param n2 The normal vector at the second vertex.
+ * @param n3 The normal vector at the third vertex.
+ * @param t_min The minimum distance for a valid hit.
+ * @param t_max The maximum distance for a valid hit.
+ * @param rec The HitRecord whose t and normal are filled upon a collision.
+ * @return True if the ray intersects the triangle within the specified distance range.
+ * This is the Möller-Trumbore test shared by MeshTriangle and Mesh, which stores its triangles as
+ * indices into flat vertex and normal arrays.
+ */
+PRISM_EXPORT bool hitTriangle(const Ray& ray, const Point3& p1, const Point3& p2, const Point3& p3,
+                              const Vector3& n1, const Vector3& n2, const Vector3& n3,
+                              double t_min, double t_max, HitRecord& rec);
+
 } // namespace Prism
 
 #endif // PRISM_TRIANGLE_HPP_
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef PRISM_ANIMATION_HPP_
+#define PRISM_ANIMATION_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/matrix.hpp"
+#include "Prism/core/point.hpp"
+#include "Prism/core/vector.hpp"
+#include "Prism/scene/camera.hpp"
+
+#include <vector>
+
+namespace Prism {
+
+class Scene; // Forward declaration of Scene class
+
+/**
+ * @struct CameraKey
+ * @brief The camera position and target at a keyframe.
+ */
+struct PRISM_EXPORT CameraKey {
+    double frame = 0.0;
+    Point3 lookfrom;
+    Point3 lookat;
+};
+
+/**
+ * @struct TransformKey
+ * @brief The animated transformation of an object at a keyframe.
+ * The object is scaled, then rotated about `axis`, then translated, on top of the transformation
+ * it has in the scene file: `T * R * S * base`.
+ */
+struct PRISM_EXPORT TransformKey {
+    double frame = 0.0;
+    Vector3 translation = Vector3(0, 0, 0);
+    Vector3 axis = Vector3(0, 1, 0);
+    double angle = 0.0; ///< Rotation about `axis`, in radians
+    Vector3 scale = Vector3(1, 1, 1);
+};
+
+/**
+ * @class Animation
+ * @brief Keyframed camera and object transformations over a sequence of frames.
+ *
+ * Between keyframes, positions, scales and angles are interpolated linearly; before the first
+ * and after the last keyframe, the nearest keyframe holds. An animation only changes the camera
+ * and object transformations, so the geometry of the scene, and the acceleration structures built
+ * over it in object space, stay untouched from frame to frame (see Scene::renderSequence()).
+ */
+class PRISM_EXPORT Animation {
+  public:
+    /**
+     * @brief A keyed object: its index in the scene, its transformation in the scene file and its
+     * keyframes, sorted by frame.
+     */
+    struct Track {
+        size_t object;
+        Matrix base;
+        std::vector<TransformKey> keys;
+    };
+
+    /**
+     * @brief Sets the number of frames of the sequence.
+     */
+    void setFrameCount(int count);
+
+    /**
+     * @brief Gets the number of frames of the sequence (0 if there is no animation).
+     */
+    int frameCount() const {
+        return frame_count_;
+    }
+
+    /**
+     * @brief Sets the keyframes of the camera.
+     * @param keys The keyframes, in any order.
+     */
+    void setCameraKeys(std::vector<CameraKey> keys);
+
+    /**
+     * @brief Animates an object.
+     * @param object The index of the object in the scene.
+     * @param base The transformation of the object in the scene file.
+     * @param keys The keyframes, in any order.
+     */
+    void addTrack(size_t object, const Matrix& base, std::vector<TransformKey> keys);
+
+    /**
+     * @brief Gets the camera at a frame.
+     * @param base The camera of the scene, which provides the viewport, resolution and up vector.
+     * @param frame The frame, possibly between keyframes.
+     */
+    Camera cameraAt(const Camera& base, double frame) const;
+
+    /**
+     * @brief Gets the transformation of a keyed object at a frame.
+     */
+    static Matrix transformAt(const Track& track, double frame);
+
+    /**
+     * @brief Moves the camera and the keyed objects of a scene to a frame.
+     * @param scene The scene the animation was made for.
+     * @param frame The frame.
+     * @param base_camera The camera of the scene before the animation was first applied.
+     */
+    void apply(Scene& scene, double frame, const Camera& base_camera) const;
+
+    /**
+     * @brief Gets the keyframes of the camera, sorted by frame.
+     */
+    const std::vector<CameraKey>& cameraKeys() const {
+        return camera_keys_;
+    }
+
+    /**
+     * @brief Gets the keyed objects.
+     */
+    const std::vector<Track>& tracks() const {
+        return tracks_;
+    }
+
+  private:
+    int frame_count_ = 0;                ///< Number of frames of the sequence
+    std::vector<CameraKey> camera_keys_; ///< Camera keyframes, sorted by frame
+    std::vector<Track> tracks_;          ///< Keyed objects
+};
+
+} // namespace Prism
+
+#endif // PRISM_ANIMATION_HPP_
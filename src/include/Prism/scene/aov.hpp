@@ -0,0 +1,30 @@
+#ifndef PRISM_AOV_HPP_
+#define PRISM_AOV_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/scene/denoiser.hpp"
+#include "Prism/scene/render_settings.hpp"
+
+#include <filesystem>
+
+namespace Prism {
+
+/**
+ * @brief Writes the selected channels of resolved first-hit buffers as an OpenEXR image.
+ * @param path The file to write (conventionally `*.exr`).
+ * @param buffers The per-pixel features of the image, after GuideBuffers::resolve().
+ * @param settings The channels to write; the id channels need buffers constructed with ids.
+ * @throws std::runtime_error if no channel is selected, the buffers lack the ids asked for or
+ * the file cannot be written.
+ *
+ * The file is a single-part, uncompressed scanline OpenEXR image with one 32-bit float channel
+ * per plane, which compositing applications read directly. Ids are stored as floats, exact up to
+ * 2^24.
+ */
+PRISM_EXPORT void writeAovs(const std::filesystem::path& path, const GuideBuffers& buffers,
+                            const AovSettings& settings);
+
+} // namespace Prism
+
+#endif // PRISM_AOV_HPP_
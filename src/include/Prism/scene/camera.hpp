@@ -106,6 +106,37 @@ class PRISM_EXPORT Camera {
         int current_x;        ///< Current column (x-coordinate) of the pixel
     };
 
+    /**
+     * @brief Gets the same view at another resolution.
+     * @param factor The factor applied to the image width and height (at least one pixel each).
+     * @return A camera with the same position, orientation and viewport, so pixel (x, y) of the
+     * original covers the area of pixels [x * factor, (x + 1) * factor) of the new one.
+     */
+    Camera scaled(double factor) const;
+
+    /**
+     * @brief Gets the ray through an arbitrary point of the image.
+     * @param x The horizontal image coordinate, in pixels from the left edge.
+     * @param y The vertical image coordinate, in pixels from the top edge.
+     * @return The ray from the camera position through that point of the view plane. Pixel (i, j)
+     * spans [i, i + 1) x [j, j + 1), so rayAt(i + 0.5, j + 0.5) is the ray through its center.
+     */
+    Ray rayAt(double x, double y) const {
+        Point3 target =
+            pixel_00_loc + (pixel_delta_u * (x - 0.5)) - (pixel_delta_v * (y - 0.5));
+        return Ray(pos, target);
+    }
+
+    /**
+     * @brief Maps a point to the image, the inverse of rayAt().
+     * @param p The point, in world space.
+     * @param x Receives the horizontal image coordinate of the point, if it is in front.
+     * @param y Receives the vertical image coordinate of the point, if it is in front.
+     * @return The depth of the point: its distance from the camera along the viewing direction.
+     * Points with a depth of zero or less are not in front of the camera and are not mapped.
+     */
+    double project(const Point3& p, double& x, double& y) const;
+
     /**
      * @brief Returns a const iterator to the beginning of the camera's pixel rays.
      * @return A CameraIterator pointing to the first pixel ray.
@@ -0,0 +1,94 @@
+#ifndef PRISM_CHECKPOINT_HPP_
+#define PRISM_CHECKPOINT_HPP_
+
+#include "prism_export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct TileRecord
+ * @brief The saved state of a finished tile: its per-pixel values, row by row, and the number of
+ * camera samples traced for it.
+ */
+struct PRISM_EXPORT TileRecord {
+    uint64_t samples = 0;
+    std::vector<float> values;
+};
+
+/**
+ * @class RenderCheckpoint
+ * @brief A sidecar file that records the finished tiles of a render, so an interrupted render can
+ * resume where it stopped.
+ *
+ * The file is a journal: a header holding the fingerprint of the render (see Scene::render()) and
+ * its number of tiles, followed by one record per finished tile. Finished tiles are queued with
+ * add() and appended by flush(), so each flush only writes the tiles finished since the last one.
+ * Every record carries a checksum: a record cut short by an interruption is dropped on resume,
+ * along with anything after it.
+ */
+class PRISM_EXPORT RenderCheckpoint {
+  public:
+    /**
+     * @brief Constructs a checkpoint; nothing is read or written until resume() or flush().
+     * @param path The checkpoint file.
+     * @param fingerprint Identifies the scene and settings; files written for another render are
+     * discarded.
+     * @param tile_count The number of tiles of the render.
+     */
+    RenderCheckpoint(std::filesystem::path path, uint64_t fingerprint, size_t tile_count);
+
+    /**
+     * @brief Reads the tiles finished by an earlier run of the same render.
+     * @param restore Called with the index and saved state of every finished tile.
+     * @return The number of tiles restored, 0 if the file is missing or belongs to another render.
+     */
+    size_t resume(const std::function<void(size_t tile, const TileRecord& record)>& restore);
+
+    /**
+     * @brief Checks whether a tile was restored by resume() or added since.
+     */
+    bool isFinished(size_t tile) const {
+        return finished_[tile] != 0;
+    }
+
+    /**
+     * @brief Queues a finished tile, to be written by the next flush().
+     */
+    void add(size_t tile, const TileRecord& record);
+
+    /**
+     * @brief Appends the queued tiles to the file, writing its header first if it is new.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void flush();
+
+    /**
+     * @brief Gets the number of finished tiles.
+     */
+    size_t finishedCount() const {
+        return finished_count_;
+    }
+
+    /**
+     * @brief Hashes bytes with 64-bit FNV-1a, continuing from `hash`.
+     */
+    static uint64_t hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+  private:
+    std::filesystem::path path_;
+    uint64_t fingerprint_;
+    std::vector<uint8_t> finished_;
+    size_t finished_count_ = 0;
+    std::vector<char> pending_; ///< Serialized records not written yet
+    bool has_header_ = false;   ///< Whether the file holds the header of this render
+};
+
+} // namespace Prism
+
+#endif // PRISM_CHECKPOINT_HPP_
@@ -0,0 +1,109 @@
+#ifndef PRISM_DENOISER_HPP_
+#define PRISM_DENOISER_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/color.hpp"
+#include "Prism/core/vector.hpp"
+#include "Prism/scene/framebuffer.hpp"
+#include "Prism/scene/render_settings.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct GuideBuffers
+ * @brief Per-pixel features of the first surface seen through each pixel, which guide the
+ * denoiser: the distance to the surface, its normal and its albedo (material color).
+ *
+ * Camera samples add their first hit with add(), and resolve() turns the sums into per-pixel
+ * averages. Pixels whose samples escaped the scene have a depth and normal of 0 and the ambient
+ * color as albedo. Channels are stored as separate float planes, row by row, so the filter reads
+ * them with contiguous loads. The same buffers hold the AOV channels of a render (see
+ * writeAovs()), which may also include the object and material ids of the first sample.
+ */
+struct PRISM_EXPORT GuideBuffers {
+    /**
+     * @brief Constructs empty buffers for an image.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @param ids Whether to also keep the object and material id planes.
+     */
+    GuideBuffers(int width, int height, bool ids = false);
+
+    int width;
+    int height;
+    bool has_ids;                    ///< Whether the id planes are kept
+    std::vector<float> depth;        ///< Distance along the camera ray
+    std::vector<float> normal[3];    ///< Shading normal (x, y, z)
+    std::vector<float> albedo[3];    ///< Material color (r, g, b)
+    std::vector<float> object_id;    ///< Index of the object plus 1, 0 for the background
+    std::vector<float> material_id;  ///< Number of the material, 0 for the background
+    std::vector<uint32_t> count;     ///< Samples added to each pixel since the last clear()
+
+    /**
+     * @brief Records the ids of the first hit of a pixel; ids of later samples are ignored, as
+     * they cannot be averaged. Must be called before add() for the same sample.
+     */
+    void addIds(size_t pixel, uint32_t object, uint32_t material) {
+        if (count[pixel] == 0) {
+            object_id[pixel] = static_cast<float>(object);
+            material_id[pixel] = static_cast<float>(material);
+        }
+    }
+
+    /**
+     * @brief Adds the first hit of a camera sample.
+     * @param pixel The index of the pixel, row by row.
+     */
+    void add(size_t pixel, double distance, const Vector3& surface_normal, const Color& color) {
+        depth[pixel] += static_cast<float>(distance);
+        normal[0][pixel] += static_cast<float>(surface_normal.x);
+        normal[1][pixel] += static_cast<float>(surface_normal.y);
+        normal[2][pixel] += static_cast<float>(surface_normal.z);
+        albedo[0][pixel] += static_cast<float>(color.r);
+        albedo[1][pixel] += static_cast<float>(color.g);
+        albedo[2][pixel] += static_cast<float>(color.b);
+        count[pixel]++;
+    }
+
+    /**
+     * @brief Averages the samples of every pixel and renormalizes the normals.
+     */
+    void resolve();
+
+    /**
+     * @brief Resets every pixel, to collect the features of another image of the same size.
+     */
+    void clear();
+
+    /**
+     * @brief Resets one pixel, to collect its features again.
+     * @param pixel The index of the pixel, row by row.
+     */
+    void clearPixel(size_t pixel);
+};
+
+/**
+ * @brief Removes sampling noise from a rendered image with an edge-avoiding à-trous filter.
+ * @param image The image to filter in place.
+ * @param guides The resolved features of the image's pixels.
+ * @param settings The number of levels and the edge-stopping parameters.
+ * @throws std::runtime_error if the guide buffers do not match the image size.
+ *
+ * Each level convolves the image with a B3-spline kernel whose taps are spread 2^level pixels
+ * apart, so a few levels cover a wide footprint. The 5x5 kernel is applied as a 5-tap pass along
+ * the rows followed by one along the columns, 10 taps per pixel instead of 25, and each pass runs
+ * over whole rows of float planes so the compiler vectorizes it. Every tap is weighted
+ * by how similar its color, normal, relative depth and albedo are to the center pixel's, so the
+ * filter smooths noise within a surface without blurring across geometric or texture edges. The
+ * color tolerance halves at every level, as the noise left after each pass is smaller.
+ */
+PRISM_EXPORT void denoise(Framebuffer& image, const GuideBuffers& guides,
+                          const DenoiseSettings& settings);
+
+} // namespace Prism
+
+#endif // PRISM_DENOISER_HPP_
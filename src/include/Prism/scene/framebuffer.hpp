@@ -0,0 +1,103 @@
+#ifndef PRISM_FRAMEBUFFER_HPP_
+#define PRISM_FRAMEBUFFER_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/color.hpp"
+
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @brief Converts a color component in [0, 1] to an 8-bit value.
+ */
+PRISM_EXPORT int convert_color(double f);
+
+/**
+ * @brief Writes a color as three 8-bit values, as used in the P3 PPM format.
+ */
+PRISM_EXPORT std::ostream& operator<<(std::ostream& os, const Color& color);
+
+/**
+ * @struct ImageRegion
+ * @brief A rectangle of pixels: columns [x, x + width) and rows [y, y + height).
+ */
+struct PRISM_EXPORT ImageRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    /**
+     * @brief Gets the number of pixels in the region.
+     */
+    size_t area() const {
+        return static_cast<size_t>(width) * static_cast<size_t>(height);
+    }
+};
+
+/**
+ * @class Framebuffer
+ * @brief A rendered image, stored row by row from the top-left pixel.
+ */
+class PRISM_EXPORT Framebuffer {
+  public:
+    /**
+     * @brief Constructs a black image.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     */
+    Framebuffer(int width, int height);
+
+    int width() const {
+        return width_;
+    }
+
+    int height() const {
+        return height_;
+    }
+
+    Color& at(int x, int y) {
+        return pixels_[static_cast<size_t>(y) * width_ + x];
+    }
+
+    const Color& at(int x, int y) const {
+        return pixels_[static_cast<size_t>(y) * width_ + x];
+    }
+
+    /**
+     * @brief Gets all pixels, row by row.
+     */
+    const std::vector<Color>& pixels() const {
+        return pixels_;
+    }
+
+    /**
+     * @brief Writes the image as a PPM file.
+     * @param path The file to write.
+     * @param binary Whether to write the compact binary (P6) format, about ten times faster to
+     * write and read than the default plain-text (P3) one.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writePPM(const std::filesystem::path& path, bool binary = false) const;
+
+    /**
+     * @brief Reads an image written by writePPM() (or any 8-bit P3 or P6 PPM file).
+     * @param path The file to read.
+     * @return The image; writing it again reproduces the same 8-bit values.
+     * @throws std::runtime_error if the file cannot be read or is not an 8-bit PPM image.
+     */
+    static Framebuffer readPPM(const std::filesystem::path& path);
+
+  private:
+    int width_;                 ///< Width of the image in pixels
+    int height_;                ///< Height of the image in pixels
+    std::vector<Color> pixels_; ///< Pixel colors, row by row
+};
+
+} // namespace Prism
+
+#endif // PRISM_FRAMEBUFFER_HPP_
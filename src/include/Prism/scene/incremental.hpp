@@ -0,0 +1,140 @@
+#ifndef PRISM_INCREMENTAL_HPP_
+#define PRISM_INCREMENTAL_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/aabb.hpp"
+#include "Prism/core/ray.hpp"
+#include "Prism/scene/framebuffer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Prism {
+
+class Material; // Forward declaration of Material class
+
+/**
+ * @struct RayDependencies
+ * @brief Records what the rays of an image region depended on.
+ *
+ * Every ray traced for the region (camera, secondary and shadow rays) adds the object and
+ * material it hit, and the segment of space it crossed before stopping. The region's pixels can
+ * only change if one of those objects or materials is edited, or if an object moves into one of
+ * those segments.
+ */
+struct PRISM_EXPORT RayDependencies {
+    struct Segment {
+        Ray ray;      ///< The traced ray
+        double t_max; ///< Distance at which the ray stopped, infinite if it escaped the scene
+    };
+
+    std::vector<uint32_t> objects;          ///< Indices of the objects hit, sorted once finished
+    std::vector<const Material*> materials; ///< Materials shaded, sorted once finished
+    std::vector<Segment> segments;          ///< Unobstructed parts of the traced rays
+
+    /**
+     * @brief Records a ray that hit an object.
+     * @param ray The ray.
+     * @param t The distance of the hit.
+     * @param object The index of the object in the scene.
+     * @param material The material at the hit, or null for shadow rays.
+     */
+    void addHit(const Ray& ray, double t, uint32_t object, const Material* material) {
+        segments.push_back({ray, t});
+        // Consecutive rays mostly hit the same object, which keeps the lists short until finish()
+        if (objects.empty() || objects.back() != object) {
+            objects.push_back(object);
+        }
+        if (material && (materials.empty() || materials.back() != material)) {
+            materials.push_back(material);
+        }
+    }
+
+    /**
+     * @brief Records a ray that reached its end (a light, or infinity) without hitting anything.
+     */
+    void addSegment(const Ray& ray, double t_max) {
+        segments.push_back({ray, t_max});
+    }
+
+    /**
+     * @brief Sorts and deduplicates the objects and materials, once the region is rendered.
+     */
+    void finish();
+
+    /**
+     * @brief Forgets everything recorded.
+     */
+    void clear();
+
+    /**
+     * @brief Checks whether a ray of the region hit an object.
+     */
+    bool dependsOn(uint32_t object) const;
+
+    /**
+     * @brief Checks whether a ray of the region shaded a material.
+     */
+    bool dependsOn(const Material* material) const;
+
+    /**
+     * @brief Checks whether a ray of the region crossed a box before it stopped.
+     */
+    bool crosses(const AABB& bounds) const;
+
+    /**
+     * @brief Gets the memory held by the record, in bytes.
+     */
+    size_t byteSize() const;
+};
+
+/**
+ * @struct IncrementalState
+ * @brief The image of the last incremental render with the dependencies of each of its tiles.
+ * Kept by Scene between renderIncremental() calls; edits made through the Scene update API mark
+ * the tiles they can affect as dirty.
+ */
+struct PRISM_EXPORT IncrementalState {
+    /**
+     * @brief Splits an image into tiles.
+     * @param width The width of the image in pixels.
+     * @param height The height of the image in pixels.
+     * @param tile_size The side of the square tiles; tiles on the right and bottom edges may be
+     * smaller.
+     */
+    IncrementalState(int width, int height, int tile_size);
+
+    /**
+     * @brief Gets the pixels covered by a tile.
+     */
+    ImageRegion tile(size_t index) const;
+
+    /**
+     * @brief Marks every tile whose rays hit an object or crossed a box.
+     * @param object The index of the object.
+     * @param bounds The world bounds of the object, after its edit.
+     */
+    void invalidate(uint32_t object, const AABB& bounds);
+
+    /**
+     * @brief Marks every tile whose rays shaded a material.
+     */
+    void invalidate(const Material* material);
+
+    /**
+     * @brief Counts the tiles waiting to be re-rendered.
+     */
+    size_t dirtyCount() const;
+
+    Framebuffer image;                   ///< The image, up to date except for dirty tiles
+    int tile_size;                       ///< Side of the tiles in pixels
+    int tiles_x;                         ///< Number of tile columns
+    int tiles_y;                         ///< Number of tile rows
+    std::vector<RayDependencies> tiles;  ///< Dependencies of each tile, row by row
+    std::vector<uint8_t> dirty;          ///< Whether each tile must be re-rendered
+};
+
+} // namespace Prism
+
+#endif // PRISM_INCREMENTAL_HPP_
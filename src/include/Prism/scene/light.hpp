@@ -3,20 +3,44 @@
 
 #include "prism_export.h"
 
+#include "Prism/core/aabb.hpp"
 #include "Prism/core/color.hpp"
 #include "Prism/core/point.hpp"
+#include "Prism/core/vector.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Prism {
 
+/**
+ * @enum LightShape
+ * @brief The shape of the emitting surface of a light.
+ */
+enum class LightShape {
+    Point,     ///< A single point: hard shadows
+    Rectangle, ///< A parallelogram centered at the position, spanned by edge_u and edge_v
+    Sphere,    ///< A sphere of radius sphere_radius centered at the position
+};
+
 /**
  * @class Light
- * @brief Represents a point light source in the scene.
+ * @brief Represents a light source in the scene: a point light, or a rectangle or sphere area
+ * light that casts soft shadows.
+ *
+ * Area lights are shaded as if all their light came from their center; their extent only decides
+ * which fraction of the light a shading point sees (see Scene and ShadowSettings).
  */
 class PRISM_EXPORT Light {
   public:
     Point3 position; ///< The position of the light in 3D space.
     Color
         color; ///< The color of the light, typically used to determine how it illuminates objects.
+    double radius = 0.0; ///< Influence radius; points farther away are not lit. 0 means unlimited
+    LightShape shape = LightShape::Point; ///< Shape of the emitting surface
+    Vector3 edge_u;                       ///< First edge of a rectangle light
+    Vector3 edge_v;                       ///< Second edge of a rectangle light
+    double sphere_radius = 0.0;           ///< Radius of a sphere light
 
     /**
      * @brief Default constructor that initializes the light with default values.
@@ -25,7 +49,117 @@ class PRISM_EXPORT Light {
      * - Color: White (1, 1, 1)
      * - Intensity: 1.0
      */
-    Light(const Point3& pos, const Color& col) : position(pos), color(col) {
+    Light(const Point3& pos, const Color& col, double influence_radius = 0.0)
+        : position(pos), color(col), radius(influence_radius) {
+    }
+
+    /**
+     * @brief Creates a rectangle area light.
+     * @param center The center of the rectangle.
+     * @param u The first edge of the rectangle (its full length, not half).
+     * @param v The second edge of the rectangle.
+     * @param col The color of the light.
+     * @param influence_radius The influence radius, 0 meaning unlimited.
+     */
+    static Light rectangle(const Point3& center, const Vector3& u, const Vector3& v,
+                           const Color& col, double influence_radius = 0.0) {
+        Light light(center, col, influence_radius);
+        light.shape = LightShape::Rectangle;
+        light.edge_u = u;
+        light.edge_v = v;
+        return light;
+    }
+
+    /**
+     * @brief Creates a sphere area light.
+     * @param center The center of the sphere.
+     * @param size The radius of the sphere.
+     * @param col The color of the light.
+     * @param influence_radius The influence radius, 0 meaning unlimited.
+     */
+    static Light sphere(const Point3& center, double size, const Color& col,
+                        double influence_radius = 0.0) {
+        Light light(center, col, influence_radius);
+        light.shape = LightShape::Sphere;
+        light.sphere_radius = size;
+        return light;
+    }
+
+    /**
+     * @brief Checks whether the light has an extent, and therefore casts soft shadows.
+     */
+    bool isArea() const {
+        return shape != LightShape::Point;
+    }
+
+    /**
+     * @brief Picks a point of the light, as seen from a shading point.
+     * @param from The shading point; sphere lights are sampled on their disk facing it.
+     * @param s A number in [0, 1) along the first dimension of the light.
+     * @param t A number in [0, 1) along the second dimension of the light.
+     * @return The position for point lights, otherwise a point of the emitting surface. A uniform
+     * (s, t) gives points uniformly distributed over the rectangle or disk.
+     */
+    Point3 samplePoint(const Point3& from, double s, double t) const {
+        if (shape == LightShape::Rectangle) {
+            return position + edge_u * (s - 0.5) + edge_v * (t - 0.5);
+        }
+        if (shape == LightShape::Sphere) {
+            Vector3 axis = (position - from).normalize();
+            Vector3 helper = std::abs(axis.x) < 0.9 ? Vector3(1, 0, 0) : Vector3(0, 1, 0);
+            Vector3 tangent = axis.cross(helper).normalize();
+            Vector3 bitangent = axis.cross(tangent);
+            double r = sphere_radius * std::sqrt(s);
+            double phi = 6.283185307179586 * t; // 2 pi t
+            return position + tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi));
+        }
+        return position;
+    }
+
+    /**
+     * @brief Gets the bounding box of the emitting surface.
+     */
+    AABB bounds() const {
+        AABB box(position, position);
+        if (shape == LightShape::Rectangle) {
+            for (double s : {-0.5, 0.5}) {
+                for (double t : {-0.5, 0.5}) {
+                    box.expand(position + edge_u * s + edge_v * t);
+                }
+            }
+        } else if (shape == LightShape::Sphere) {
+            Vector3 extent(sphere_radius, sphere_radius, sphere_radius);
+            box.expand(position + (-extent));
+            box.expand(position + extent);
+        }
+        return box;
+    }
+
+    /**
+     * @brief Gets the largest color component, an upper bound of the light's contribution.
+     */
+    double power() const {
+        return std::max(color.r, std::max(color.g, color.b));
+    }
+
+    /**
+     * @brief Gets the attenuation of the light at a distance.
+     * @param distance The distance from the light.
+     * @param influence_radius The influence radius, 0 meaning unlimited.
+     * @return 1 for unlimited lights. Otherwise a smooth window, (1 - (d/r)^4)^2, that fades to 0
+     * at the influence radius; it decreases with the distance and increases with the radius.
+     */
+    static double falloff(double distance, double influence_radius) {
+        if (influence_radius <= 0.0) {
+            return 1.0;
+        }
+        if (distance >= influence_radius) {
+            return 0.0;
+        }
+        double ratio = distance / influence_radius;
+        double ratio2 = ratio * ratio;
+        double window = 1.0 - ratio2 * ratio2;
+        return window * window;
     }
 };
 
@@ -0,0 +1,81 @@
+#ifndef PRISM_LIGHT_TREE_HPP_
+#define PRISM_LIGHT_TREE_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/aabb.hpp"
+#include "Prism/core/point.hpp"
+#include "Prism/scene/light.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @class LightTree
+ * @brief A bounding volume hierarchy over the point lights of a scene.
+ *
+ * Each node stores the bounds of its light positions, their total power (largest color
+ * component) and their largest influence radius. Together these bound the contribution of all the
+ * lights of a subtree to any shading point, which lets a shading point either skip whole subtrees
+ * (collect()) or pick lights in proportion to their estimated contribution (sample()), in
+ * logarithmic rather than linear time in the number of lights.
+ */
+class PRISM_EXPORT LightTree {
+  public:
+    /**
+     * @brief Builds the hierarchy.
+     * @param lights The lights of the scene; the tree refers to them by index.
+     */
+    explicit LightTree(const std::vector<std::unique_ptr<Light>>& lights);
+
+    /**
+     * @brief Finds the lights that can noticeably light a point.
+     * @param p The shading point.
+     * @param threshold Subtrees whose contribution bound is below this are skipped. With 0, only
+     * the lights whose influence radius does not reach p are skipped, which is exact.
+     * @param out Receives the indices of the lights, in increasing order.
+     */
+    void collect(const Point3& p, double threshold, std::vector<uint32_t>& out) const;
+
+    /**
+     * @brief Picks a light in proportion to its estimated contribution to a point.
+     * @param p The shading point.
+     * @param u A uniform random number in [0, 1).
+     * @param light Receives the index of the chosen light.
+     * @param pdf Receives the probability with which that light was chosen.
+     * @return False if no light can reach p.
+     */
+    bool sample(const Point3& p, double u, uint32_t& light, double& pdf) const;
+
+    /**
+     * @brief Gets the number of lights in the tree.
+     */
+    size_t size() const {
+        return light_count;
+    }
+
+  private:
+    struct Node {
+        AABB bounds;         ///< Bounds of the light positions
+        double power;        ///< Sum of the light powers
+        double radius;       ///< Largest influence radius, infinite if any light is unlimited
+        uint32_t left;       ///< Index of the left child (inner nodes)
+        uint32_t right;      ///< Index of the right child (inner nodes)
+        uint32_t light;      ///< Index of the light (leaves)
+        bool leaf;
+    };
+
+    uint32_t build(const std::vector<std::unique_ptr<Light>>& lights,
+                   std::vector<uint32_t>& order, size_t begin, size_t end);
+    double importance(const Node& node, const Point3& p) const;
+
+    std::vector<Node> nodes; ///< Nodes of the tree, the root first
+    size_t light_count = 0;  ///< Number of lights in the tree
+};
+
+} // namespace Prism
+
+#endif // PRISM_LIGHT_TREE_HPP_
@@ -0,0 +1,69 @@
+#ifndef PRISM_RENDER_COST_HPP_
+#define PRISM_RENDER_COST_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/scene/framebuffer.hpp"
+#include "Prism/scene/trace_context.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct RegionCost
+ * @brief The estimated cost of a rectangle of the image.
+ */
+struct PRISM_EXPORT RegionCost {
+    ImageRegion region;
+    size_t sampled_pixels = 0;   ///< Pixels of the region that were traced
+    double seconds = 0.0;        ///< Estimated single-thread time of the whole region
+    double rays_per_pixel = 0.0; ///< Average rays traced per sampled pixel
+};
+
+/**
+ * @struct RenderCostEstimate
+ * @brief The predicted cost of a render, extrapolated from a sample of its pixels (see
+ * Scene::estimateRenderCost()).
+ *
+ * Counts and times cover the whole image. The image is divided into a grid of regions, each
+ * estimated from its own sampled pixels (or from the image average if none was sampled), so
+ * expensive parts of the image (mirrors, glass, dense geometry) stand out in `regions`.
+ */
+struct PRISM_EXPORT RenderCostEstimate {
+    int width = 0;                   ///< Width of the image in pixels
+    int height = 0;                  ///< Height of the image in pixels
+    size_t sampled_pixels = 0;       ///< Pixels traced for the estimate
+    double sample_seconds = 0.0;     ///< Time taken by the estimate itself
+    TraceStats rays;                 ///< Extrapolated ray counts
+    uint64_t camera_samples = 0;     ///< Extrapolated camera samples (adaptive sampling adds more)
+    double seconds = 0.0;            ///< Extrapolated single-thread time of tracing the image
+    double slowest_tile = 0.0;       ///< Extrapolated time of the most expensive tile
+    double raster_seconds = 0.0;     ///< Time of building the visibility buffer, on one thread
+    std::vector<RegionCost> regions; ///< The grid of regions, most expensive first
+
+    /**
+     * @brief Predicts the wall time of tracing the image with tiles spread over threads.
+     * @param threads The number of threads; values below 1 count as 1.
+     * @return The single-thread time divided among the threads, but no less than the time of the
+     * slowest tile, which one thread has to trace alone, plus the time of building the visibility
+     * buffer, which is not spread over threads.
+     */
+    double wallSeconds(int threads) const;
+
+    /**
+     * @brief Formats the estimate: totals, wall times for 1 to 64 threads and the costliest
+     * regions.
+     */
+    std::string toString() const;
+};
+
+PRISM_EXPORT std::ostream& operator<<(std::ostream& os, const RenderCostEstimate& estimate);
+
+} // namespace Prism
+
+#endif // PRISM_RENDER_COST_HPP_
@@ -0,0 +1,244 @@
+#ifndef PRISM_RENDER_SETTINGS_HPP_
+#define PRISM_RENDER_SETTINGS_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/scene/framebuffer.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct SamplingSettings
+ * @brief Controls adaptive anti-aliasing.
+ * Every pixel first receives `min_samples` stratified, jittered samples. Pixels whose luminance
+ * is still uncertain (standard error above `variance_threshold`), or that differ from a
+ * neighbour by more than `contrast_threshold` after the first batch, receive further batches of
+ * `min_samples` samples, up to `max_samples`. With a single sample per pixel, the ray goes
+ * through the pixel center exactly as without anti-aliasing.
+ */
+struct PRISM_EXPORT SamplingSettings {
+    int min_samples = 1;              ///< Samples every pixel receives
+    int max_samples = 1;              ///< Upper bound of samples for a refined pixel
+    double variance_threshold = 0.01; ///< Refine while the standard error of luminance is above
+    double contrast_threshold = 0.1;  ///< Refine pixels this much brighter/darker than a neighbour
+
+    /**
+     * @brief Checks whether any pixel can receive more than one sample.
+     */
+    bool isAdaptive() const {
+        return max_samples > 1;
+    }
+};
+
+/**
+ * @enum LightSelection
+ * @brief How shading points choose the lights they evaluate.
+ */
+enum class LightSelection {
+    All,    ///< Every light, with a shadow ray each (lights out of their influence radius skipped)
+    Tree,   ///< The lights whose contribution bound from the light tree is significant
+    Sample, ///< A fixed number of lights, sampled in proportion to their estimated contribution
+};
+
+/**
+ * @struct LightSettings
+ * @brief Controls the many-light mode.
+ * With `Tree`, a threshold of 0 is exact: only lights whose influence radius does not reach the
+ * shading point are skipped. Higher thresholds also skip groups of lights whose combined
+ * contribution bound is below it. With `Sample`, each shading point evaluates `samples` lights
+ * picked from the light tree and weights them by the inverse of their probability, so the cost
+ * no longer depends on the number of lights, at the price of noise.
+ */
+struct PRISM_EXPORT LightSettings {
+    LightSelection selection = LightSelection::All; ///< How lights are chosen
+    double threshold = 0.0;                         ///< Contribution bound below which to skip
+    int samples = 4;                                ///< Lights evaluated per shading point
+};
+
+/**
+ * @struct ShadowSettings
+ * @brief Controls the shadow rays of area lights.
+ * Each shading point first traces `min_samples` shadow rays to stratified points of the light. If
+ * they all agree (the light is fully visible or fully hidden), that answer is kept; otherwise the
+ * point is in a penumbra and up to `max_samples` rays in total estimate the visible fraction.
+ */
+struct PRISM_EXPORT ShadowSettings {
+    int min_samples = 4;  ///< Shadow rays every shading point traces to an area light
+    int max_samples = 32; ///< Upper bound of shadow rays in a penumbra
+};
+
+/**
+ * @struct ShadowMapSettings
+ * @brief Controls the approximate shadows of point lights.
+ * When enabled, each point light gets a depth cubemap (see ShadowCubemap), built once by ray
+ * casting from the light and reused by later renders while the light and the geometry do not
+ * change. Shadow tests of point lights become filtered lookups in it instead of shadow rays.
+ * Higher resolutions sharpen the shadows and cost more to build; `bias` trades shadow acne on
+ * surfaces facing the light at an angle for shadows that detach from their occluders. Area
+ * lights keep their shadow rays.
+ */
+struct PRISM_EXPORT ShadowMapSettings {
+    bool enabled = false; ///< Whether point lights use shadow maps
+    int resolution = 256; ///< Texels along each side of the faces of the cubemaps
+    double bias = 0.005;  ///< Depth tolerance, relative to the distance from the light
+    int filter = 1;       ///< Radius of the filter in texels (1 averages 3x3 texels)
+};
+
+/**
+ * @enum Integrator
+ * @brief How camera rays are turned into colors.
+ * `Whitted` is the full renderer. The other modes shade the first hit of each camera ray only and
+ * trace no secondary rays; all but `Direct` trace no shadow rays either, so they run at the speed
+ * of primary visibility, for layout checks of large scenes.
+ */
+enum class Integrator {
+    Whitted, ///< Direct light with shadows, specular reflection and refraction, recursively
+    Albedo,  ///< The material color of the surface, unlit
+    Normals, ///< The shading normal, mapped from [-1, 1] to [0, 1] per component
+    Depth,   ///< Grey from white at the camera to black far away (see `depth_scale`)
+    Ambient, ///< Emission plus the ambient term only
+    Direct,  ///< Emission and direct light with shadows, without reflection or refraction
+};
+
+/**
+ * @struct DenoiseSettings
+ * @brief Controls the denoising pass applied to rendered images (see denoise()).
+ * Each sigma is the difference from the center pixel at which a tap loses most of its weight:
+ * `color_sigma` in RGB units at the first level, `normal_sigma` in normal vector length,
+ * `depth_sigma` relative to the depth of the center pixel and `albedo_sigma` in RGB units.
+ */
+struct PRISM_EXPORT DenoiseSettings {
+    bool enabled = false;       ///< Whether renderImage() and renderSequence() denoise
+    int levels = 4;             ///< Filter passes; the footprint doubles with each one
+    double color_sigma = 0.5;   ///< Color tolerance at the first level, halved at each level
+    double normal_sigma = 0.3;  ///< Normal tolerance
+    double depth_sigma = 0.05;  ///< Relative depth tolerance
+    double albedo_sigma = 0.1;  ///< Albedo tolerance
+};
+
+/**
+ * @struct ProgressiveSettings
+ * @brief Controls progressive rendering.
+ * A progressive render first traces 1 pixel in 16, then 1 in 4, then the rest, each pass going
+ * through the tiles from the center of the image outwards. Previews, with every missing pixel
+ * filled from the nearest traced one of its block, are delivered after each of the two coarse
+ * passes and whenever `interval` seconds went by since the last one. render() writes them to
+ * `preview`, or to `preview.ppm` in the output directory if it is empty.
+ */
+struct PRISM_EXPORT ProgressiveSettings {
+    bool enabled = false;          ///< Whether images are rendered progressively
+    double interval = 5.0;         ///< Seconds between previews (0 after every tile)
+    std::filesystem::path preview; ///< File that render() keeps replacing with the last preview
+};
+
+/**
+ * @struct AovSettings
+ * @brief Selects the arbitrary output variables (AOVs) written alongside the image.
+ * The channels come from the first hit of the camera samples, collected during the same pass that
+ * traces the image, and are written to `file` as a multi-channel float OpenEXR image (see
+ * writeAovs()). render() writes them next to the image if `file` is empty.
+ */
+struct PRISM_EXPORT AovSettings {
+    bool depth = false;         ///< Distance to the first hit (`Z`)
+    bool normal = false;        ///< Shading normal in world space (`N.X`, `N.Y`, `N.Z`)
+    bool albedo = false;        ///< Material color (`albedo.R`, `albedo.G`, `albedo.B`)
+    bool object_id = false;     ///< Index of the object plus 1, 0 for the background (`objectId`)
+    bool material_id = false;   ///< Number of the material, 0 for the background (`materialId`)
+    std::filesystem::path file; ///< The OpenEXR file to write
+
+    /**
+     * @brief Checks whether any channel is selected.
+     */
+    bool any() const {
+        return depth || normal || albedo || object_id || material_id;
+    }
+};
+
+/**
+ * @struct CheckpointSettings
+ * @brief Controls the checkpoint of long renders (see RenderCheckpoint).
+ * With a `file`, the image is traced tile by tile and the finished tiles are appended to it every
+ * `interval` seconds. A render of the same scene with the same settings that finds the file skips
+ * the tiles it holds, and render() deletes it once the image is written. Progressive and
+ * multi-view renders are not checkpointed. With adaptive sampling, neighbour contrast is only
+ * measured within a tile, so the image can differ slightly from one rendered without checkpoint.
+ */
+struct PRISM_EXPORT CheckpointSettings {
+    std::filesystem::path file; ///< The checkpoint file, none if empty
+    double interval = 30.0;     ///< Seconds between writes (0 after every tile)
+};
+
+/**
+ * @struct RenderSettings
+ * @brief Parameters of a render that are independent of the scene content.
+ *
+ * Every secondary ray carries the weight with which its color enters the pixel (the product of
+ * the reflectance, transmittance and specular factors along its path). Since traced colors are
+ * clamped to [0, 1], that weight bounds the change the ray can make to the pixel. Rays weighted
+ * below `min_contribution` are not traced; 0.5 / 255 keeps every pixel within one 8-bit step of
+ * the full result. With `russian_roulette`, rays weighted below `roulette_threshold` are traced
+ * with a probability proportional to their weight and scaled up when they survive, which trades
+ * noise for speed without the darkening of a hard cutoff.
+ *
+ * Rays are traced by an iterative integrator that keeps pending hits on an explicit stack of at
+ * most `max_depth` frames instead of the call stack. `recursive_trace` selects the recursive
+ * reference implementation, which produces the same image.
+ *
+ * `resolution_scale` renders the camera's view at a fraction (or multiple) of its resolution,
+ * for previews. `regions` restricts the render to pixel rectangles, given in pixels of the
+ * camera's full resolution and scaled along with the image; every other pixel is left untouched.
+ * With `crop`, the image only covers the bounding rectangle of the regions. With a `composite`
+ * image, render() traces the regions into a copy of it instead of a black image.
+ *
+ * With a `deadline`, the render picks the quality of each tile from its measured cost. A first
+ * pass traces one pixel per 4x4 block of the image at the cheapest level (one sample per pixel,
+ * one bounce, one shadow ray per area light) and fills the blocks with it; it ignores the
+ * deadline, so no pixel stays black. A second pass traces the same pixels at the full depth and
+ * shadow sampling while time allows, to measure how much slower that level is on each tile. Then
+ * every tile, from the center outwards, is traced in full at the best level (cheapest, full depth
+ * and shadows, or full sampling) at which all the remaining tiles fit in the time left, or at the
+ * cheapest level while tiles still fit one by one, predictions being corrected by the times
+ * measured so far. Tiles that no longer fit keep the blocks of the first passes. Deadline renders
+ * are neither progressive nor checkpointed.
+ *
+ * With `rasterize`, the triangles of the objects that can be tessellated (triangles, meshes and
+ * spheres, see Object::tessellate()) are first rasterized into a VisibilityBuffer at the camera's
+ * resolution. A camera ray through a pixel center then only tests the primitives the buffer shows
+ * around that pixel and the objects that were not rasterized, and falls back to the other
+ * objects when the hit it finds lies behind the buffer; the image is the same as without it.
+ * Jittered and secondary rays are traced as usual.
+ */
+struct PRISM_EXPORT RenderSettings {
+    int max_depth = 5;                ///< Maximum number of bounces of a camera ray
+    SamplingSettings sampling;        ///< Anti-aliasing parameters
+    uint64_t seed = 0;                ///< Seed of the per-pixel random number generators
+    double min_contribution = 0.0;    ///< Skip rays whose weight is below this (0 traces all)
+    bool russian_roulette = false;    ///< Randomly terminate low-weight rays
+    double roulette_threshold = 0.05; ///< Weight below which Russian roulette applies
+    bool recursive_trace = false;     ///< Use the recursive reference integrator
+    LightSettings lights;             ///< Many-light parameters
+    ShadowSettings shadows;           ///< Area light shadow parameters
+    ShadowMapSettings shadow_maps;    ///< Point light shadow map parameters
+    int tile_size = 16;               ///< Side of render tiles and culling blocks, in pixels
+    DenoiseSettings denoise;          ///< Denoising pass parameters
+    double resolution_scale = 1.0;    ///< Factor applied to the camera's image size
+    std::vector<ImageRegion> regions; ///< Pixel rectangles to render, the whole image if empty
+    bool crop = true;                 ///< Output only the bounding rectangle of the regions
+    std::filesystem::path composite;  ///< Image that render() traces the regions into, if any
+    ProgressiveSettings progressive;  ///< Progressive render parameters
+    Integrator integrator = Integrator::Whitted; ///< How camera rays are shaded
+    double depth_scale = 10.0;        ///< Distance shown mid-grey by the Depth integrator
+    AovSettings aovs;                 ///< Extra channels written with the image
+    int threads = 0;                  ///< Threads of multi-view renders, 0 for one per core
+    CheckpointSettings checkpoint;    ///< Tile checkpoint of long renders
+    double deadline = 0.0;            ///< Wall-clock budget of the render in seconds, 0 for none
+    bool rasterize = false;           ///< Find the first hits of camera rays by rasterization
+};
+
+} // namespace Prism
+
+#endif // PRISM_RENDER_SETTINGS_HPP_
@@ -4,19 +4,35 @@
 #include "prism_export.h"
 
 #include "Prism/core/color.hpp"
+#include "Prism/core/memory_report.hpp"
 #include "Prism/objects/objects.hpp"
+#include "Prism/scene/animation.hpp"
 #include "Prism/scene/camera.hpp"
+#include "Prism/scene/framebuffer.hpp"
+#include "Prism/scene/incremental.hpp"
 #include "Prism/scene/light.hpp"
+#include "Prism/scene/render_cost.hpp"
+#include "Prism/scene/render_settings.hpp"
+#include "Prism/scene/trace_context.hpp"
+#include "Prism/scene/visibility_buffer.hpp"
 
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace Prism {
 
 PRISM_EXPORT std::filesystem::path generate_filename();
 
+/**
+ * @brief Receives the previews of a progressive render (see ProgressiveSettings).
+ */
+using PreviewCallback = std::function<void(const Framebuffer& preview)>;
+
 /**
  * @class Scene
  * @brief Represents a 3D scene containing objects and a camera for rendering.
@@ -45,6 +61,20 @@ class PRISM_EXPORT Scene {
      */
     void addObject(std::unique_ptr<Object> object);
 
+    /**
+     * @brief Reserves storage for additional objects.
+     * @param count The number of objects about to be added.
+     * Used by bulk loaders that know the object count up front, to avoid repeated reallocation of
+     * the object list while streaming large scenes.
+     */
+    void reserveObjects(size_t count);
+
+    /**
+     * @brief Gets the number of objects in the scene.
+     * @return The number of objects added so far.
+     */
+    size_t objectCount() const;
+
     /**
      * @brief Adds a light source to the scene.
      * @param light The Light object to be added to the scene.
@@ -53,26 +83,360 @@ class PRISM_EXPORT Scene {
      */
     void addLight(std::unique_ptr<Light> light);
 
+    /**
+     * @brief Breaks down the memory held by the scene by category.
+     * @return The bytes held by the objects, lights, camera and the image being rendered.
+     * Materials shared between objects are counted once. Lazily loaded meshes only count their
+     * geometry once it has been loaded, and out-of-core meshes count the full budget of the
+     * geometry cache.
+     */
+    MemoryReport memoryReport() const;
+
+    /**
+     * @brief Sets a hard limit on the memory held by the scene.
+     * @param bytes The budget in bytes, or 0 for no limit.
+     * @throws std::runtime_error if the scene already exceeds the budget.
+     * Once set, every object and light added to the scene is accounted for, and addObject() or
+     * addLight() throw as soon as the budget is exceeded, so an oversized scene fails while it is
+     * being loaded instead of in the middle of a render.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Gets the memory budget in bytes (0 when unlimited).
+     */
+    size_t memoryBudget() const;
+
     /**
      * @brief Renders the scene from the camera's perspective.
-     * This method iterates over all objects in the scene, checks for ray-object intersections, and
-     * generates the final image. The rendered image is saved to a file with a timestamped filename.
-     * The rendering process involves casting rays from the camera through each pixel of the
-     * viewport and checking for hits with the objects.
+     * This method renders the scene with its render settings (see renderImage()) and saves the
+     * image to a file with a timestamped filename. If the scene has named cameras, all of them are
+     * rendered instead (see renderViews()), each to a file suffixed with the camera's name.
+     */
+    void render();
+
+    /**
+     * @brief Renders the scene into an image.
+     * @param settings The render parameters (bounce depth, anti-aliasing, ray tree pruning, seed).
+     * @param stats If not null, receives the number of rays traced, pruned and terminated.
+     * @return The rendered image.
+     * Without anti-aliasing, one ray is traced through the center of each pixel. With adaptive
+     * sampling, every pixel receives `min_samples` stratified, jittered samples, and further
+     * batches are only traced for pixels that are noisy or contrast with a neighbour (see
+     * SamplingSettings). Sample positions come from per-pixel generators seeded by
+     * `settings.seed`, so the same settings always produce the same image. With
+     * `settings.denoise.enabled`, the depth, normal and albedo of the first hit of every camera
+     * sample are collected along the way and guide a denoising pass over the image (see
+     * denoise()), which lets few samples per pixel or per area light stand in for many.
+     *
+     * The image has the camera's resolution times `settings.resolution_scale`. With
+     * `settings.regions`, only those rectangles are traced, through the same camera mapping as
+     * the whole image, so their pixels match the full render; with `settings.crop` the image is
+     * the bounding rectangle of the regions, otherwise untraced pixels are black.
+     *
+     * With `settings.progressive.enabled`, the image is traced in coarse-to-fine passes over tiles
+     * ordered from the center outwards, and `preview` (if set) receives reconstructed images of
+     * the render so far. Without adaptive sampling, every pixel is still traced exactly once with
+     * the same rays, so the final image is the same; with it, the coarse passes add one sample
+     * per 4 pixels and neighbours are only compared within a tile.
+     *
+     * With AOV channels selected in `settings.aovs`, the features of the first hit of the camera
+     * samples are collected during the same pass and written to `settings.aovs.file`, at the size
+     * of the returned image (see writeAovs()); it throws std::runtime_error if no file is set.
+     */
+    Framebuffer renderImage(const RenderSettings& settings, TraceStats* stats = nullptr,
+                            const PreviewCallback& preview = nullptr) const;
+
+    /**
+     * @brief Renders the regions of the settings into an existing image.
+     * @param image The image to composite into, at the camera's resolution scaled by
+     * `settings.resolution_scale`; pixels outside the regions are left untouched.
+     * @param settings The render parameters, including the regions to trace.
+     * @param stats If not null, receives the number of rays traced, pruned and terminated.
+     * @param preview Receives the previews of a progressive render, if set.
+     * @throws std::runtime_error if the image size does not match the camera or no region
+     * overlaps the image.
+     * Each pixel is traced with the same rays and random streams as in renderImage(), so
+     * re-rendering a region of a finished image, or assembling an image from separate region
+     * renders, gives the same result as a single full render. The only exception is adaptive
+     * sampling, which compares neighbouring pixels within a region only.
+     */
+    void renderInto(Framebuffer& image, const RenderSettings& settings,
+                    TraceStats* stats = nullptr, const PreviewCallback& preview = nullptr) const;
+
+    /**
+     * @brief Renders the scene from several cameras at once.
+     * @param cameras The views to render, e.g. a stereo pair, the faces of a cubemap or the
+     * stations of a turntable.
+     * @param settings The render parameters, shared by all views.
+     * @param stats If not null, receives the rays traced for all views together.
+     * @param names The names of the views, which suffix their AOV files (defaults to the index of
+     * each view).
+     * @return One image per camera, in the same order.
+     * @throws std::runtime_error if there are no cameras, the names do not match the cameras, or
+     * AOV channels are selected without an AOV file.
+     *
+     * Every view is split into tiles of `tile_size` pixels, and the tiles of all views are
+     * interleaved in a single work list that `settings.threads` threads take tiles from, so the
+     * views are traced concurrently against the same scene and a thread is never left idle while
+     * another view still has work. Objects with levels of detail use the level required by the
+     * view nearest to them, and are set back to the level of the scene camera afterwards; as this
+     * changes the objects, the scene must not be rendered from another thread meanwhile. Pixels
+     * are traced as by renderImage(), except that adaptive sampling only compares neighbours
+     * within a tile. Regions and progressive previews apply to single renders only; denoising is
+     * applied to every view, and AOVs are written for every view to `settings.aovs.file` with
+     * `_<name>` appended to its stem.
+     */
+    std::vector<Framebuffer> renderViews(const std::vector<Camera>& cameras,
+                                         const RenderSettings& settings,
+                                         TraceStats* stats = nullptr,
+                                         const std::vector<std::string>& names = {});
+
+    /**
+     * @brief Estimates the cost of a render by tracing a sample of its pixels.
+     * @param settings The render parameters to estimate.
+     * @param fraction The fraction of the pixels to trace.
+     * @param time_limit Seconds after which sampling stops, whatever the fraction reached.
+     * @return The ray counts, single-thread and per-thread times and costliest regions of the
+     * whole image, extrapolated from the sample.
+     *
+     * The image (at the settings' resolution scale) is divided into square cells of about
+     * 1 / `fraction` pixels, and one pixel at a random position in each cell is traced with the
+     * full settings, so the sample covers the whole image evenly. Cells are visited in random
+     * order, so stopping at the time limit still leaves an evenly spread sample. Each pixel is
+     * timed and its rays counted; sampling is done on one thread. Regions, progressive, deadline
+     * and checkpoint settings are ignored. With `rasterize`, the visibility buffer is built in
+     * full before sampling, and the time it took is reported apart, since the build is not
+     * spread over threads.
+     */
+    RenderCostEstimate estimateRenderCost(const RenderSettings& settings, double fraction = 0.005,
+                                          double time_limit = 5.0) const;
+
+    /**
+     * @brief Renders the scene with its render settings, re-tracing only what changed.
+     * @param stats If not null, receives the work done by this call.
+     * @return The image, owned by the scene until its next edit or incremental render.
+     *
+     * The image is split into tiles of `tile_size` pixels, and the first call traces all of them
+     * while recording, per tile, the objects and materials its rays hit (secondary and shadow
+     * rays included) and the segments of space they crossed (see RayDependencies). Edits made
+     * through updateObject() and updateMaterial() then mark the tiles they can affect, and later
+     * calls only re-trace those. Adaptive sampling compares neighbouring pixels within a tile
+     * only, so a tile always renders the same whether the rest of the image is re-traced or not.
+     * Changing the camera, the render settings, or adding objects or lights discards the
+     * recorded state. Shadow maps are not used: point lights always trace shadow rays, whose
+     * segments are recorded like any other.
+     */
+    const Framebuffer& renderIncremental(TraceStats* stats = nullptr);
+
+    /**
+     * @brief Renders the frames of an animation back to back.
+     * @param animation The keyframes; its object indices refer to this scene.
+     * @param output_dir The directory that receives `frame_0000.ppm`, `frame_0001.ppm`, ...
+     * @param stats If not null, receives the rays traced over the whole sequence.
+     * @throws std::runtime_error if the animation has no frames or a frame cannot be written.
+     *
+     * The scene stays resident for the whole sequence: each frame only moves the camera and sets
+     * the transformation of the keyed objects, whose geometry stays in object space, so nothing is
+     * reloaded or rebuilt. The trace context, light tree and image buffers are set up once, and
+     * each frame is encoded and written on a background thread while the next one is traced.
+     * Shadow maps are rebuilt only on frames that move objects.
+     * Afterwards, even when a frame fails, the camera and the keyed objects are back to their
+     * state in the scene file. With AOV channels selected, each frame's channels are written to
+     * `frame_0000.exr`, ... Frames are always traced in full: progressive, checkpoint and deadline
+     * settings are ignored, with a warning.
+     */
+    void renderSequence(const Animation& animation, const std::filesystem::path& output_dir,
+                        TraceStats* stats = nullptr);
+
+    /**
+     * @brief Edits an object of the scene.
+     * @param index The index of the object, in the order it was added.
+     * @param edit Applies the change (e.g. a new transform) to the object.
+     * @throws std::runtime_error if there is no object with that index.
+     * After the edit, tiles of the incremental render whose rays hit the object or cross its new
+     * bounding box are re-traced by the next renderIncremental().
+     */
+    void updateObject(size_t index, const std::function<void(Object&)>& edit);
+
+    /**
+     * @brief Edits a material of the scene.
+     * @param material The material, as shared by the objects that use it.
+     * @param edit Applies the change to the material.
+     * After the edit, tiles of the incremental render whose rays shaded the material are
+     * re-traced by the next renderIncremental().
+     */
+    void updateMaterial(const std::shared_ptr<Material>& material,
+                        const std::function<void(Material&)>& edit);
+
+    /**
+     * @brief Sets the parameters used by render().
+     */
+    void setRenderSettings(const RenderSettings& settings);
+
+    /**
+     * @brief Gets the parameters used by render().
+     */
+    const RenderSettings& getRenderSettings() const;
+
+    /**
+     * @brief Sets the animation of the scene file, rendered by renderSequence().
+     */
+    void setAnimation(const Animation& animation);
+
+    /**
+     * @brief Gets the animation of the scene file (an animation without frames if it has none).
+     */
+    const Animation& getAnimation() const;
+
+    /**
+     * @brief Replaces the camera used to view the scene.
+     * @param camera The new camera.
+     * Allows re-rendering a loaded scene from other viewpoints without rebuilding it. Objects with
+     * levels of detail choose them again for the new viewpoint.
+     */
+    void setCamera(Camera camera);
+
+    /**
+     * @brief Gets the camera used to view the scene.
+     */
+    const Camera& getCamera() const;
+
+    /**
+     * @brief Adds a named camera, for rendering several views of the scene (see renderViews()).
+     * @param name The name of the camera, unique within the scene.
+     * @param camera The camera.
+     * @throws std::runtime_error if the scene already has a camera with that name.
+     */
+    void addCamera(const std::string& name, Camera camera);
+
+    /**
+     * @brief Gets a named camera.
+     * @throws std::runtime_error if the scene has no camera with that name.
+     */
+    const Camera& getCamera(const std::string& name) const;
+
+    /**
+     * @brief Gets the names of the named cameras, in the order they were added.
+     */
+    std::vector<std::string> cameraNames() const;
+
+    /**
+     * @brief Writes the committed scene to a binary snapshot file.
+     * @param path The path of the snapshot file to write (conventionally `*.prsnap`).
+     * @throws std::runtime_error if the file cannot be written or the scene holds an object type
+     * that cannot be stored in a snapshot.
+     *
+     * The snapshot is a single flat file made of fixed-size little-endian records: camera, named
+     * cameras, render settings, ambient light, memory budget, material table, lights, objects
+     * (with their transform and its precomputed inverse), pooled mesh geometry, levels of detail
+     * included, and the animation.
+     * Out-of-core meshes are stored by the path of their backing file, which must still exist
+     * when the snapshot is loaded. Every section is 8-byte aligned and addressed by offsets from
+     * the file header, so the file can be memory-mapped and read in place.
+     */
+    void save_snapshot(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Restores a scene previously written with save_snapshot().
+     * @param path The path of the snapshot file.
+     * @return The restored Scene, ready to be rendered.
+     * @throws std::runtime_error if the file cannot be read, is truncated, or was written by an
+     * incompatible version of Prism.
+     *
+     * Loading does not touch the original YAML, OBJ or MTL files and does not invert any
+     * transformation matrix.
      */
-    void render() const;
+    static Scene load_snapshot(const std::filesystem::path& path);
 
   private:
-    Color trace(const Ray& ray, int depth) const;
+    void renderRegions(const Camera& camera, const std::vector<ImageRegion>& regions,
+                       Framebuffer& image, const ImageRegion& frame, const RenderSettings& settings,
+                       TraceStats* stats, const PreviewCallback& preview) const;
+
+    size_t renderRegion(const Camera& camera, const ImageRegion& region, Framebuffer& image,
+                        const ImageRegion& frame, TraceContext& context, bool show_progress) const;
+
+    size_t renderProgressive(const Camera& camera, const std::vector<ImageRegion>& regions,
+                             Framebuffer& image, const ImageRegion& frame, TraceContext& context,
+                             const PreviewCallback& preview) const;
+
+    size_t renderDeadline(const Camera& camera, const std::vector<ImageRegion>& regions,
+                          Framebuffer& image, const ImageRegion& frame,
+                          TraceContext& context) const;
+
+    size_t renderCheckpointed(const Camera& camera, const std::vector<ImageRegion>& regions,
+                              Framebuffer& image, const ImageRegion& frame,
+                              TraceContext& context) const;
+
+    Color tracePixel(const Camera& camera, int x, int y, const ImageRegion& frame,
+                     TraceContext& context) const;
+
+    Color traceCamera(const Ray& ray, TraceContext& context) const;
+
+    Color shadeFirstHit(const Ray& ray, TraceContext& context) const;
+
+    Color trace(const Ray& ray, int depth, double weight, TraceContext& context) const;
+
+    Color traceIterative(const Ray& ray, int depth, double weight, TraceContext& context) const;
+
+    Bounce bounce(const Ray& ray, const HitRecord& rec, double weight,
+                  TraceContext& context) const;
+
+    Color directLight(const Ray& ray, const HitRecord& rec, TraceContext& context) const;
+
+    void shadeLight(const Light& light, double scale, const HitRecord& rec,
+                    const Vector3& view_dir, TraceContext& context, Color& surface_color) const;
+
+    double visibility(const Light& light, const HitRecord& rec, TraceContext& context) const;
+
+    static Color combine(const Bounce& bounce, const Color children[2]);
+
+    void recordGuide(const HitRecord* rec, TraceContext& context) const;
+
+    void numberMaterials(TraceContext& context) const;
+
+    bool admitSecondary(double weight, TraceContext& context, double& traced_weight,
+                        double& scale) const;
+
+    bool is_occluded(const Point3& from, const Point3& to, TraceContext* context) const;
+
+    bool hit_closest(const Ray& ray, double t_min, double t_max, HitRecord& rec,
+                     TraceContext* context = nullptr,
+                     const std::vector<uint32_t>* candidates = nullptr) const;
+
+    bool hitCamera(const Ray& ray, HitRecord& rec, TraceContext& context) const;
+
+    void recordHit(const Ray& ray, bool hit_anything, double closest_t, size_t closest,
+                   const HitRecord& rec, TraceContext& context) const;
+
+    void cullObjects(const Camera& camera, const ImageRegion& block,
+                     std::vector<uint32_t>& candidates) const;
+
+    std::unique_ptr<VisibilityBuffer> rasterizeView(const Camera& camera, const ImageRegion& frame,
+                                                    const RenderSettings& settings) const;
+
+    void updateViewpoint(Object& object, const Camera& camera);
+
+    ShadowMaps prepareShadowMaps(const RenderSettings& settings) const;
 
-    bool is_in_shadow(const std::unique_ptr<Light>& light, const HitRecord& rec) const;
+    void accountSceneMemory(MemoryReport& report) const;
 
-    bool hit_closest(const Ray& ray, double t_min, double t_max, HitRecord& rec) const;
+    void enforceMemoryBudget() const;
 
-    std::vector<std::unique_ptr<Object>> objects_; ///< Collection of objects in the scene
-    std::vector<std::unique_ptr<Light>> lights_;   ///< Collection of light sources in the scene
-    Color ambient_color_ = Color(0.1, 0.1, 0.1);   ///< Ambient color for the scene
-    Camera camera_;                                ///< The camera used to view the scene
+    std::vector<std::unique_ptr<Object>> objects_;  ///< Collection of objects in the scene
+    std::vector<std::unique_ptr<Light>> lights_;    ///< Collection of light sources in the scene
+    Color ambient_color_ = Color(0.1, 0.1, 0.1);    ///< Ambient color for the scene
+    Camera camera_;                                 ///< The camera used to view the scene
+    std::vector<std::pair<std::string, Camera>> cameras_; ///< Named cameras, in insertion order
+    RenderSettings settings_;                       ///< Parameters used by render()
+    Animation animation_;                           ///< Animation of the scene file, if any
+    size_t memory_budget_ = 0;                      ///< Hard memory limit in bytes, 0 if none
+    std::unique_ptr<IncrementalState> incremental_; ///< State of renderIncremental(), if any
+    MemoryReport load_usage_; ///< Memory accounted so far while the scene is being built
+    std::unique_ptr<ShadowMapCache> shadow_maps_ =
+        std::make_unique<ShadowMapCache>(); ///< Shadow maps kept from one render to the next
+    uint64_t geometry_version_ = 0;         ///< Bumped whenever an object is added or changed
 };
 } // namespace Prism
 
@@ -5,6 +5,7 @@
 
 #include "prism_export.h"
 
+#include "Prism/scene/animation.hpp"
 #include "Prism/scene/scene.hpp"
 
 #include <string>
@@ -16,6 +17,58 @@ namespace Prism {
  * @brief Reads and parses a scene description from a YAML file.
  * The SceneParser class is responsible for reading a YAML file that describes a 3D scene, including
  * camera settings, materials, and objects. It constructs a Scene object that can be rendered.
+ *
+ * Besides one map per object, the 'objects' list accepts bulk blocks that create many primitives
+ * sharing a material and transform:
+ * - `type: spheres` with packed `centers: [x0, y0, z0, x1, ...]` and either `radii: [r0, r1, ...]`
+ *   or a shared `radius`, or `file: <path>` pointing to raw float32 records `[cx, cy, cz, r]`.
+ * - `type: triangles` with packed `vertices: [x1, y1, z1, x2, ..., z3, ...]` (9 values per
+ *   triangle), or `file: <path>` pointing to raw float32 records of 9 values.
+ *
+ * Raw files are little-endian, relative to the scene file, and are streamed in fixed-size chunks,
+ * so objects are created while reading and memory stays bounded by the scene itself.
+ *
+ * A `mesh` object with `lazy: true` becomes a MeshProxy: its OBJ file is only loaded when a ray
+ * first reaches its object-space `bounds: {min: [...], max: [...]}`. Without `bounds`, they are
+ * read from the `<obj>.bounds` cache header (created on the first run).
+ *
+ * A `mesh` object with `out_of_core: true` becomes an OutOfCoreMesh: its triangles are split into
+ * clusters of `cluster_size` triangles (default 256) stored in `<obj>.prclusters`, and paged in
+ * through the shared GeometryCache. The top-level `geometry_cache: {budget_mb: N}` sets the budget
+ * of that cache.
+ *
+ * The optional top-level `render` block sets the RenderSettings of the scene: `max_depth`, `seed`,
+ * `tile_size`, `samples` (either a fixed count per pixel or an adaptive range
+ * `{min, max, variance_threshold, contrast_threshold}`) and the ray tree pruning parameters
+ * `min_contribution`, `russian_roulette` and `roulette_threshold`. Its `lights` sub-block,
+ * `{mode: all | tree | sample, threshold, samples}`, selects how shading points pick lights
+ * (see LightSettings); `mode` defaults to `tree` when the block is present. Its `shadows`
+ * sub-block, `{min_samples, max_samples}`, sets the adaptive shadow rays of area lights (see
+ * ShadowSettings). `shadow_maps`, a boolean or `{enabled, resolution, bias, filter}`, replaces
+ * the shadow rays of point lights with cubemap lookups (see ShadowMapSettings). `threads` sets
+ * the worker threads of multi-view renders (0, the default, uses one per core). `checkpoint`, a
+ * file name or `{file, interval}`, checkpoints long renders (see CheckpointSettings); the file is
+ * relative to the scene file. `deadline` bounds the render time in seconds, lowering its quality
+ * as needed (see RenderSettings). `rasterize: true` finds the first hits of camera rays through a
+ * rasterized visibility buffer (see RenderSettings).
+ *
+ * Besides the main `camera`, the optional top-level `cameras` list adds named cameras
+ * `{name, lookfrom, lookat, ...}` that render the same scene in one pass (see
+ * Scene::renderViews()); keys a named camera leaves out are taken from `camera`. Without `camera`,
+ * the first named camera is also the main one.
+ *
+ * A light may set an influence `radius`, beyond which it contributes nothing. Lights without one
+ * reach the whole scene. Its `type` is `point` (the default), `rectangle`, centered at `position`
+ * and spanned by the edges `u` and `v`, or `sphere`, of radius `size`.
+ *
+ * The optional top-level `memory_budget_mb` sets a hard limit on the memory held by the scene
+ * (see Scene::setMemoryBudget()): parsing stops with an error as soon as it is exceeded.
+ *
+ * The optional top-level `animation` block defines a sequence of `frames` (see Animation):
+ * `camera` is a list of keyframes `{frame, lookfrom, lookat}`, and `objects` a list of
+ * `{name, keys}`, where `name` refers to the `name` of an object and each key is
+ * `{frame, translate, rotate: {axis, angle}, scale}` (angle in degrees, scale a number or a
+ * vector), applied on top of the object's `transform`.
  */
 class PRISM_EXPORT SceneParser {
   public:
@@ -32,8 +85,18 @@ class PRISM_EXPORT SceneParser {
      */
     Scene parse();
 
+    /**
+     * @brief Gets the animation defined by the last parsed scene file.
+     * @return The keyframes of the `animation` block, or an animation without frames if the file
+     * has none. The parsed scene holds the same animation (see Scene::getAnimation()).
+     */
+    const Animation& animation() const {
+        return animation_;
+    }
+
   private:
     std::string filePath; ///< The path to the YAML file containing the scene description
+    Animation animation_; ///< Animation of the last parsed scene
 };
 
 } // namespace Prism
@@ -0,0 +1,131 @@
+#ifndef PRISM_SHADOW_MAP_HPP_
+#define PRISM_SHADOW_MAP_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/point.hpp"
+#include "Prism/core/ray.hpp"
+#include "Prism/core/vector.hpp"
+#include "Prism/scene/light.hpp"
+#include "Prism/scene/render_settings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @class ShadowCubemap
+ * @brief The distance from a point light to the nearest surface in every direction, stored on the
+ * six faces of a cube centered at the light.
+ *
+ * Each texel holds the distance to the first hit of a ray cast from the light through the texel's
+ * center (infinity if it escapes). A point is lit if it is no farther from the light than the
+ * surface recorded in its direction, up to a bias; lookups average that test over a square of
+ * neighbouring texels (percentage-closer filtering), which softens the stair-stepped edges of
+ * the texels into a short gradient.
+ */
+class PRISM_EXPORT ShadowCubemap {
+  public:
+    /**
+     * @brief Builds the cubemap of a light by ray casting.
+     * @param center The position of the light.
+     * @param resolution The number of texels along each side of a face.
+     * @param cast Returns the distance to the first hit of a ray, or infinity. It is called from
+     * several threads at once.
+     * @throws std::runtime_error if the resolution is not positive.
+     */
+    ShadowCubemap(const Point3& center, int resolution,
+                  const std::function<double(const Ray&)>& cast);
+
+    /**
+     * @brief Estimates the fraction of a light that reaches a point.
+     * @param p The point to test.
+     * @param normal The unit normal of the surface at `p`, which scales the tolerance with the
+     * slope of the surface as seen from the light.
+     * @param bias The depth tolerance, relative to the distance from the light. The footprint of
+     * the filter, scaled by the slope, is always added to it.
+     * @param filter The radius of the filter in texels (0 tests a single texel).
+     * @return The fraction of the filter's texels that see the point, in [0, 1].
+     */
+    double visibility(const Point3& p, const Vector3& normal, double bias, int filter) const;
+
+    /**
+     * @brief Gets the position of the light the cubemap was built from.
+     */
+    const Point3& center() const {
+        return center_;
+    }
+
+    /**
+     * @brief Gets the number of texels along each side of a face.
+     */
+    int resolution() const {
+        return resolution_;
+    }
+
+    /**
+     * @brief Gets the bytes held by the depths.
+     */
+    size_t memoryBytes() const {
+        return depth_.capacity() * sizeof(float);
+    }
+
+  private:
+    // Face of a direction (0-5 for +x, -x, +y, -y, +z, -z) and its coordinates in [-1, 1]
+    static int project(const Vector3& direction, double& u, double& v);
+
+    // Direction through coordinates (u, v) of a face
+    static Vector3 unproject(int face, double u, double v);
+
+    Point3 center_;
+    int resolution_;
+    std::vector<float> depth_; ///< Distances, face by face, row by row
+};
+
+/**
+ * @brief The shadow maps of the point lights of a render, by light.
+ */
+using ShadowMaps = std::unordered_map<const Light*, std::shared_ptr<const ShadowCubemap>>;
+
+/**
+ * @class ShadowMapCache
+ * @brief Keeps the shadow maps of a scene's lights from one render to the next.
+ *
+ * A map is rebuilt only when its light moved, the resolution changed or the geometry changed,
+ * which the scene signals by passing a new geometry version; renders of a static scene (e.g. the
+ * frames of a camera animation) reuse the same maps.
+ */
+class PRISM_EXPORT ShadowMapCache {
+  public:
+    /**
+     * @brief Gets the maps of every point light, building the missing or outdated ones.
+     * @param lights The lights of the scene; area lights get no map.
+     * @param settings The resolution of the maps.
+     * @param geometry_version Changes whenever the geometry of the scene changes.
+     * @param cast Returns the distance to the first hit of a ray, or infinity.
+     * @return The maps, which stay valid for as long as they are held.
+     */
+    ShadowMaps prepare(const std::vector<std::unique_ptr<Light>>& lights,
+                       const ShadowMapSettings& settings, uint64_t geometry_version,
+                       const std::function<double(const Ray&)>& cast);
+
+    /**
+     * @brief Gets the bytes held by the cached maps.
+     */
+    size_t memoryBytes() const;
+
+  private:
+    mutable std::mutex mutex_;
+    ShadowMaps maps_;
+    uint64_t geometry_version_ = 0;
+};
+
+} // namespace Prism
+
+#endif // PRISM_SHADOW_MAP_HPP_
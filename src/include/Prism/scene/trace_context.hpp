@@ -0,0 +1,117 @@
+#ifndef PRISM_TRACE_CONTEXT_HPP_
+#define PRISM_TRACE_CONTEXT_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/color.hpp"
+#include "Prism/core/material.hpp"
+#include "Prism/core/point.hpp"
+#include "Prism/core/random.hpp"
+#include "Prism/core/vector.hpp"
+#include "Prism/scene/render_settings.hpp"
+#include "Prism/scene/shadow_map.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct TraceStats
+ * @brief Counts the work done (and avoided) while tracing rays.
+ */
+struct PRISM_EXPORT TraceStats {
+    uint64_t rays = 0;        ///< Rays traced, camera rays included
+    uint64_t pruned = 0;      ///< Secondary rays skipped because their contribution was too small
+    uint64_t terminated = 0;  ///< Secondary rays stopped by Russian roulette
+    uint64_t shadow_rays = 0; ///< Shadow rays traced towards area lights
+
+    TraceStats& operator+=(const TraceStats& other) {
+        rays += other.rays;
+        pruned += other.pruned;
+        terminated += other.terminated;
+        shadow_rays += other.shadow_rays;
+        return *this;
+    }
+};
+
+/**
+ * @struct Bounce
+ * @brief The outcome of shading one hit: its local color and the secondary rays it spawns.
+ * Both integrators of Scene build a Bounce for each hit and combine the colors of its secondary
+ * rays the same way, so they produce the same image.
+ */
+struct PRISM_EXPORT Bounce {
+    enum class Kind {
+        Absorb,   ///< No secondary rays
+        Transmit, ///< Transparent surface: reflected ray and, unless reflection is total, refracted
+        Reflect,  ///< Mirror-like surface: reflected ray
+    };
+
+    Kind kind = Kind::Absorb;
+    Color local;              ///< Emitted plus directly lit color at the hit
+    double opacity = 1.0;     ///< Opacity of the material (Transmit)
+    double reflectance = 0.0; ///< Fresnel reflectance at the hit (Transmit)
+    Color ks;                 ///< Specular reflectivity of the material (Reflect)
+    int count = 0;            ///< Number of secondary rays
+    Point3 origins[2];        ///< Origins of the secondary rays
+    Vector3 directions[2];    ///< Directions of the secondary rays
+    double weights[2] = {0.0, 0.0}; ///< Path weights of the secondary rays
+};
+
+/**
+ * @struct TraceFrame
+ * @brief A pending hit of the iterative integrator, waiting for the colors of its secondary rays.
+ */
+struct PRISM_EXPORT TraceFrame {
+    Bounce bounce;       ///< The shaded hit
+    int depth = 0;       ///< Remaining depth at the hit
+    int next = 0;        ///< Index of the next secondary ray to trace
+    bool waiting = false; ///< Whether the secondary ray `next - 1` is being traced
+    double scale = 1.0;  ///< Russian roulette compensation of the ray being traced
+    Color children[2];   ///< Colors of the secondary rays traced so far
+};
+
+/**
+ * @struct TraceContext
+ * @brief The state shared by all the rays spawned from one camera sample.
+ */
+class LightTree;        // Forward declaration of LightTree class
+struct RayDependencies; // Forward declaration of RayDependencies struct
+struct GuideBuffers;    // Forward declaration of GuideBuffers struct
+class VisibilityBuffer; // Forward declaration of VisibilityBuffer class
+
+struct PRISM_EXPORT TraceContext {
+    /**
+     * @brief Constructs the context of a render.
+     * @param settings The render parameters; they must outlive the context.
+     */
+    explicit TraceContext(const RenderSettings& settings) : settings(settings) {
+    }
+
+    const RenderSettings& settings; ///< Depth, pruning and roulette parameters
+    Rng rng;                        ///< Random decisions of the current sample
+    TraceStats stats;               ///< Work counters, accumulated over the render
+    std::vector<TraceFrame> stack;  ///< Frames of the iterative integrator, reused between rays
+    const LightTree* light_tree = nullptr; ///< Light hierarchy of the many-light modes
+    const ShadowMaps* shadow_maps = nullptr; ///< Point light shadow maps, if enabled
+    const std::vector<uint32_t>* camera_objects = nullptr; ///< Objects camera rays of the
+                                                           ///< current pixel may hit, or all
+    const VisibilityBuffer* visibility = nullptr; ///< Rasterized first hits, if enabled
+    const std::vector<std::pair<uint32_t, uint32_t>>* camera_primitives =
+        nullptr; ///< Rasterized (object, primitive) pairs near the current pixel, if any
+    double camera_depth = 0.0; ///< Depth of the visibility buffer at the current pixel
+    std::vector<uint32_t> light_indices;  ///< Lights selected for the current shading point
+    std::vector<std::pair<double, double>> shadow_offsets; ///< Area light samples, reused
+    RayDependencies* dependencies = nullptr; ///< Receives what the rays hit (incremental renders)
+    GuideBuffers* guides = nullptr; ///< Receives the first hit of camera rays (denoised renders)
+    size_t guide_pixel = 0;         ///< Index of the pixel the current camera sample belongs to
+    uint32_t hit_object = 0;        ///< Index of the object of the last hit found
+    std::unordered_map<const Material*, uint32_t> material_ids; ///< Numbers of the id AOV
+};
+
+} // namespace Prism
+
+#endif // PRISM_TRACE_CONTEXT_HPP_
@@ -0,0 +1,140 @@
+#ifndef PRISM_VISIBILITY_BUFFER_HPP_
+#define PRISM_VISIBILITY_BUFFER_HPP_
+
+#include "prism_export.h"
+
+#include "Prism/core/point.hpp"
+#include "Prism/objects/objects.hpp"
+#include "Prism/scene/camera.hpp"
+#include "Prism/scene/framebuffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Prism {
+
+/**
+ * @struct VisibilitySample
+ * @brief The nearest rasterized surface at the center of a pixel.
+ */
+struct PRISM_EXPORT VisibilitySample {
+    static constexpr uint32_t kNone = UINT32_MAX; ///< Object of pixels nothing was drawn into
+
+    uint32_t object = kNone; ///< Index of the object, kNone if none
+    uint32_t primitive = 0;  ///< Primitive of the object (see Object::tessellate())
+    float b1 = 0.0f;         ///< Barycentric weight of the triangle's second vertex
+    float b2 = 0.0f;         ///< Barycentric weight of the triangle's third vertex
+    float depth = 0.0f;      ///< Distance along the viewing direction, infinity if none
+};
+
+/**
+ * @class VisibilityBuffer
+ * @brief The first surface seen through each pixel center of a camera, found by rasterizing the
+ * objects' triangles into a depth buffer.
+ *
+ * Objects are tessellated (see Object::tessellate()), clipped against a near plane in front of
+ * the camera and drawn with perspective-correct depth and barycentrics. Coverage is widened by a
+ * hundredth of a pixel so that rounding never leaves a gap between the triangles of a surface.
+ *
+ * The buffer is meant as a hint that a renderer confirms with exact ray tests. Every drawn
+ * object that a ray through a pixel center hits lies at or behind the depth stored for that
+ * pixel: its triangles are its surface, or enclose it and the camera is outside of them.
+ */
+class PRISM_EXPORT VisibilityBuffer {
+  public:
+    /**
+     * @brief Constructs an empty buffer.
+     * @param camera The camera whose pixel centers are sampled.
+     * @param region The pixels the buffer covers.
+     */
+    VisibilityBuffer(const Camera& camera, const ImageRegion& region);
+
+    /**
+     * @brief Rasterizes an object.
+     * @param index The index the samples of the object report.
+     * @param object The object.
+     * @return False if nothing was drawn: the object cannot be tessellated, or its triangles
+     * enclose it and the camera may be inside of them.
+     */
+    bool add(uint32_t index, const Object& object);
+
+    /**
+     * @brief Rasterizes a world-space triangle.
+     * @param object The index of the object it belongs to.
+     * @param primitive The primitive of the object it belongs to.
+     */
+    void rasterize(uint32_t object, uint32_t primitive, const Point3& p1, const Point3& p2,
+                   const Point3& p3);
+
+    /**
+     * @brief Checks whether an object was drawn by add().
+     */
+    bool covers(uint32_t object) const {
+        return object < covered_.size() && covered_[object];
+    }
+
+    /**
+     * @brief Gets the sample of a pixel.
+     * @param x The column of the pixel, in image coordinates (inside the region).
+     * @param y The row of the pixel, in image coordinates (inside the region).
+     */
+    VisibilitySample at(int x, int y) const;
+
+    /**
+     * @brief Gets the depth of a point, comparable to the depth of the samples.
+     */
+    double depthOf(const Point3& p) const {
+        double x;
+        double y;
+        return camera_.project(p, x, y);
+    }
+
+    /**
+     * @brief Gets the pixels the buffer covers.
+     */
+    const ImageRegion& region() const {
+        return region_;
+    }
+
+    /**
+     * @brief Gets the number of triangles drawn so far, after near clipping.
+     */
+    size_t triangleCount() const {
+        return triangles_;
+    }
+
+    /**
+     * @brief Gets the bytes held by the buffer.
+     */
+    size_t memoryBytes() const;
+
+  private:
+    // A clipped vertex: image coordinates, depth and barycentrics within its source triangle
+    struct Vertex {
+        double x;
+        double y;
+        double depth;
+        double b1;
+        double b2;
+    };
+
+    void drawTriangle(uint32_t object, uint32_t primitive, const Vertex& v0, const Vertex& v1,
+                      const Vertex& v2);
+
+    Camera camera_;
+    ImageRegion region_;
+    size_t triangles_ = 0;
+    std::vector<uint8_t> covered_; ///< Whether each object index was drawn
+    // One entry per pixel, row by row; kept as separate arrays so the inner loop of the
+    // rasterizer reads and writes contiguous values
+    std::vector<float> depth_;
+    std::vector<uint32_t> object_;
+    std::vector<uint32_t> primitive_;
+    std::vector<float> b1_;
+    std::vector<float> b2_;
+};
+
+} // namespace Prism
+
+#endif // PRISM_VISIBILITY_BUFFER_HPP_
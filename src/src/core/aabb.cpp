@@ -0,0 +1,114 @@
+#include "Prism/core/aabb.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Prism {
+
+AABB::AABB()
+    : min(INFINITY, INFINITY, INFINITY), max(-INFINITY, -INFINITY, -INFINITY) {
+}
+
+AABB::AABB(const Point3& min, const Point3& max) : min(min), max(max) {
+}
+
+AABB AABB::infinite() {
+    return AABB(Point3(-INFINITY, -INFINITY, -INFINITY), Point3(INFINITY, INFINITY, INFINITY));
+}
+
+bool AABB::isEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+bool AABB::isFinite() const {
+    return !isEmpty() && std::isfinite(min.x) && std::isfinite(min.y) && std::isfinite(min.z) &&
+           std::isfinite(max.x) && std::isfinite(max.y) && std::isfinite(max.z);
+}
+
+void AABB::expand(const Point3& p) {
+    min = Point3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+    max = Point3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+}
+
+void AABB::expand(const AABB& other) {
+    if (other.isEmpty()) {
+        return;
+    }
+    expand(other.min);
+    expand(other.max);
+}
+
+bool AABB::overlaps(const AABB& other) const {
+    return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y &&
+           max.y >= other.min.y && min.z <= other.max.z && max.z >= other.min.z;
+}
+
+bool AABB::contains(const Point3& p) const {
+    return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z &&
+           p.z <= max.z;
+}
+
+double AABB::distanceTo(const Point3& p) const {
+    double dx = std::max(std::max(min.x - p.x, 0.0), p.x - max.x);
+    double dy = std::max(std::max(min.y - p.y, 0.0), p.y - max.y);
+    double dz = std::max(std::max(min.z - p.z, 0.0), p.z - max.z);
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+Point3 AABB::center() const {
+    return Point3((min.x + max.x) * 0.5, (min.y + max.y) * 0.5, (min.z + max.z) * 0.5);
+}
+
+Vector3 AABB::diagonal() const {
+    return max - min;
+}
+
+AABB AABB::transformed(const Matrix& m) const {
+    if (!isFinite()) {
+        return isEmpty() ? AABB() : infinite();
+    }
+    AABB result;
+    for (int i = 0; i < 8; ++i) {
+        Point3 corner((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+        result.expand(m * corner);
+    }
+    return result;
+}
+
+bool AABB::hit(const Ray& ray, double t_min, double t_max) const {
+    return clip(ray, t_min, t_max);
+}
+
+bool AABB::clip(const Ray& ray, double& t_min, double& t_max) const {
+    const Point3 origin = ray.origin();
+    const Vector3 direction = ray.direction();
+    const double o[3] = {origin.x, origin.y, origin.z};
+    const double d[3] = {direction.x, direction.y, direction.z};
+    const double lo[3] = {min.x, min.y, min.z};
+    const double hi[3] = {max.x, max.y, max.z};
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (d[axis] == 0.0) {
+            // Parallel to the slab: either always inside it or never
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) {
+                return false;
+            }
+            continue;
+        }
+        const double inv_d = 1.0 / d[axis];
+        double t0 = (lo[axis] - o[axis]) * inv_d;
+        double t1 = (hi[axis] - o[axis]) * inv_d;
+        if (inv_d < 0.0) {
+            std::swap(t0, t1);
+        }
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+        if (t_max < t_min) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Prism
@@ -0,0 +1,50 @@
+#include "Prism/core/memory_report.hpp"
+
+#include "Prism/core/material.hpp"
+#include "Prism/core/matrix.hpp"
+
+#include <iomanip>
+#include <utility>
+#include <sstream>
+
+namespace Prism {
+
+size_t MemoryReport::total() const {
+    return geometry + indices + acceleration + transforms + materials + framebuffer + other;
+}
+
+bool MemoryReport::countOnce(const void* shared) {
+    return shared != nullptr && counted_.insert(shared).second;
+}
+
+void MemoryReport::addTransform(const Matrix& matrix) {
+    transforms += sizeof(Matrix) + matrix.getRows() * matrix.getCols() * sizeof(double);
+}
+
+void MemoryReport::addMaterial(const Material* material) {
+    if (countOnce(material)) {
+        // Materials are held through shared_ptr, so their control block is counted too
+        materials += sizeof(Material) + 2 * sizeof(long);
+    }
+}
+
+std::string MemoryReport::toString() const {
+    const std::pair<const char*, size_t> rows[] = {
+        {"geometry", geometry},     {"indices", indices},         {"acceleration", acceleration},
+        {"transforms", transforms}, {"materials", materials},     {"framebuffer", framebuffer},
+        {"other", other},           {"total", total()}};
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    for (const auto& row : rows) {
+        ss << std::left << std::setw(14) << row.first << std::right << std::setw(12)
+           << static_cast<double>(row.second) / 1024.0 << " KiB\n";
+    }
+    return ss.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryReport& report) {
+    return os << report.toString();
+}
+
+} // namespace Prism
@@ -0,0 +1,117 @@
+#include "Prism/objects/geometry_cache.hpp"
+
+#include <algorithm>
+
+namespace Prism {
+
+size_t GeometryCluster::byteSize() const {
+    return sizeof(GeometryCluster) + vertices.capacity() * sizeof(Point3) +
+           normals.capacity() * sizeof(Vector3);
+}
+
+GeometryCache::GeometryCache(size_t budget_bytes) {
+    stats_.budget_bytes = budget_bytes;
+}
+
+GeometryCache& GeometryCache::instance() {
+    static GeometryCache cache;
+    return cache;
+}
+
+void GeometryCache::setBudget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.budget_bytes = budget_bytes;
+    evictToBudget();
+}
+
+size_t GeometryCache::budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.budget_bytes;
+}
+
+uint64_t GeometryCache::makeKey(uint64_t owner, uint32_t cluster) {
+    return (owner << 32) | cluster;
+}
+
+std::shared_ptr<const GeometryCluster> GeometryCache::acquire(uint64_t owner, uint32_t cluster,
+                                                              const Loader& load) {
+    const uint64_t key = makeKey(owner, cluster);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            ++stats_.hits;
+            return it->second->cluster;
+        }
+        ++stats_.misses;
+    }
+
+    // Load without holding the lock, so other threads keep hitting resident clusters
+    std::shared_ptr<const GeometryCluster> loaded = load();
+    const size_t bytes = loaded->byteSize();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        // Another thread loaded the same cluster in the meantime
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->cluster;
+    }
+    lru_.push_front(Entry{key, loaded, bytes});
+    index_[key] = lru_.begin();
+    stats_.resident_bytes += bytes;
+    stats_.resident_clusters++;
+    stats_.peak_resident_bytes = std::max(stats_.peak_resident_bytes, stats_.resident_bytes);
+    evictToBudget();
+    return loaded;
+}
+
+void GeometryCache::evictToBudget() {
+    // The most recently used cluster always stays, even if it alone exceeds the budget
+    while (stats_.resident_bytes > stats_.budget_bytes && lru_.size() > 1) {
+        const Entry& victim = lru_.back();
+        stats_.resident_bytes -= victim.bytes;
+        stats_.resident_clusters--;
+        stats_.evictions++;
+        index_.erase(victim.key);
+        lru_.pop_back();
+    }
+}
+
+void GeometryCache::evictOwner(uint64_t owner) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if ((it->key >> 32) == owner) {
+            stats_.resident_bytes -= it->bytes;
+            stats_.resident_clusters--;
+            index_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GeometryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    stats_.resident_bytes = 0;
+    stats_.resident_clusters = 0;
+}
+
+GeometryCache::Stats GeometryCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void GeometryCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.evictions = 0;
+    stats_.peak_resident_bytes = stats_.resident_bytes;
+}
+
+} // namespace Prism
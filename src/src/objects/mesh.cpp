@@ -3,6 +3,8 @@
 #include "Prism/core/matrix.hpp"
 
 #include <cmath>
+#include <stdexcept>
+#include <string>
 
 namespace Prism {
 // TODO: Implementar BVH aqui
@@ -10,54 +12,121 @@ namespace Prism {
 Mesh::Mesh(std::filesystem::path& path) {
     ObjReader reader(path.string());
     material = std::move(reader.curMaterial);
+    faces = std::move(reader.faces);
 
+    vertices.reserve(reader.vertices.size());
     for (auto& point : reader.vertices) {
-        points.emplace_back(std::make_shared<Point3>(point[0], point[1], point[2]));
+        vertices.emplace_back(point[0], point[1], point[2]);
     }
 
+    normals.reserve(reader.normals.size());
     for (auto& normal : reader.normals) {
-        normals.emplace_back(std::make_shared<Vector3>(normal[0], normal[1], normal[2]));
+        normals.emplace_back(normal[0], normal[1], normal[2]);
     }
 
-    for (auto& face : reader.faces) {
-        mesh.emplace_back(points[face.vertex_indices[0]], points[face.vertex_indices[1]],
-                          points[face.vertex_indices[2]], normals[face.normal_indices[0]],
-                          normals[face.normal_indices[1]], normals[face.normal_indices[2]]);
-    }
+    computeBounds();
 };
 
-Mesh::Mesh(ObjReader& reader) : material(std::move(reader.curMaterial)) {
-
+Mesh::Mesh(ObjReader& reader)
+    : faces(std::move(reader.faces)), material(std::move(reader.curMaterial)) {
+    vertices.reserve(reader.vertices.size());
     for (auto& point : reader.vertices) {
-        points.emplace_back(std::make_shared<Point3>(point[0], point[1], point[2]));
+        vertices.emplace_back(point[0], point[1], point[2]);
     }
 
+    normals.reserve(reader.normals.size());
     for (auto& normal : reader.normals) {
-        normals.emplace_back(std::make_shared<Vector3>(normal[0], normal[1], normal[2]));
+        normals.emplace_back(normal[0], normal[1], normal[2]);
     }
 
-    for (auto& face : reader.faces) {
-        mesh.emplace_back(points[face.vertex_indices[0]], points[face.vertex_indices[1]],
-                          points[face.vertex_indices[2]], normals[face.normal_indices[0]],
-                          normals[face.normal_indices[1]], normals[face.normal_indices[2]]);
-    }
+    computeBounds();
 };
 
+Mesh::Mesh(std::vector<Point3> vertices, std::vector<Vector3> normals,
+           std::vector<ObjReader::FaceIndices> faces, std::shared_ptr<Material> material)
+    : vertices(std::move(vertices)), normals(std::move(normals)), faces(std::move(faces)),
+      material(std::move(material)) {
+    computeBounds();
+}
+
+void Mesh::computeBounds() {
+    bounds = AABB();
+    for (const auto& vertex : vertices) {
+        bounds.expand(vertex);
+    }
+}
+
 bool Mesh::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
     Ray transformed_ray = ray.transform(inverseTransform);
 
+    double box_t_min = t_min;
+    double box_t_max = INFINITY;
+    if (!bounds.clip(transformed_ray, box_t_min, box_t_max)) {
+        return false;
+    }
+
+    const std::vector<Point3>& points = level == 0 ? vertices : levels[level - 1].vertices;
+    const std::vector<Vector3>& point_normals = level == 0 ? normals : levels[level - 1].normals;
+    const std::vector<ObjReader::FaceIndices>& triangles =
+        level == 0 ? faces : levels[level - 1].faces;
+
     rec.t = t_max;
-    for (const auto& triangle : mesh) {
-        triangle.hit(transformed_ray, t_min, rec.t, rec);
+    for (const auto& face : triangles) {
+        const auto& v = face.vertex_indices;
+        const auto& n = face.normal_indices;
+        hitTriangle(transformed_ray, points[v[0]], points[v[1]], points[v[2]],
+                    point_normals[n[0]], point_normals[n[1]], point_normals[n[2]], t_min, rec.t,
+                    rec);
     }
+    return finishHit(ray, transformed_ray, t_min, t_max, rec);
+}
 
-    Point3 world_p;
-    double world_t = INFINITY;
+bool Mesh::hitPrimitive(const Ray& ray, uint32_t primitive, double t_min, double t_max,
+                        HitRecord& rec) const {
+    const std::vector<Point3>& points = level == 0 ? vertices : levels[level - 1].vertices;
+    const std::vector<Vector3>& point_normals = level == 0 ? normals : levels[level - 1].normals;
+    const std::vector<ObjReader::FaceIndices>& triangles =
+        level == 0 ? faces : levels[level - 1].faces;
+    if (primitive >= triangles.size()) {
+        return false;
+    }
 
-    if (rec.t < t_max) { // If a hit was found, transform the hit point back to world space
-        world_p = transform * transformed_ray.at(rec.t);
-        world_t = (world_p - ray.origin()).dot(ray.direction().normalize());
+    Ray transformed_ray = ray.transform(inverseTransform);
+    const auto& v = triangles[primitive].vertex_indices;
+    const auto& n = triangles[primitive].normal_indices;
+    rec.t = t_max;
+    hitTriangle(transformed_ray, points[v[0]], points[v[1]], points[v[2]], point_normals[n[0]],
+                point_normals[n[1]], point_normals[n[2]], t_min, rec.t, rec);
+    return finishHit(ray, transformed_ray, t_min, t_max, rec);
+}
+
+Tessellation Mesh::tessellate(const TriangleSink& sink) const {
+    const std::vector<Point3>& points = level == 0 ? vertices : levels[level - 1].vertices;
+    const std::vector<ObjReader::FaceIndices>& triangles =
+        level == 0 ? faces : levels[level - 1].faces;
+
+    std::vector<Point3> world;
+    world.reserve(points.size());
+    for (const Point3& point : points) {
+        world.push_back(transform * point);
+    }
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        const auto& v = triangles[i].vertex_indices;
+        sink(static_cast<uint32_t>(i), world[v[0]], world[v[1]], world[v[2]]);
     }
+    return Tessellation::Exact;
+}
+
+bool Mesh::finishHit(const Ray& ray, const Ray& transformed_ray, double t_min, double t_max,
+                     HitRecord& rec) const {
+    // No face was hit (checked apart, since an infinite t_max would accept world_t below)
+    if (!(rec.t < t_max)) {
+        return false;
+    }
+
+    // Transform the hit point back to world space
+    const Point3 world_p = transform * transformed_ray.at(rec.t);
+    const double world_t = (world_p - ray.origin()).dot(ray.direction().normalize());
 
     if (world_t < t_min || world_t > t_max) {
         return false;
@@ -78,4 +147,135 @@ void Mesh::setMaterial(std::shared_ptr<Material> new_material) {
     material = std::move(new_material);
 }
 
+std::shared_ptr<Material> Mesh::getMaterial() const {
+    return material;
+}
+
+const std::vector<Point3>& Mesh::getVertices() const {
+    return vertices;
+}
+
+const std::vector<Vector3>& Mesh::getNormals() const {
+    return normals;
+}
+
+const std::vector<ObjReader::FaceIndices>& Mesh::getFaces() const {
+    return faces;
+}
+
+AABB Mesh::boundingBox() const {
+    return bounds.transformed(transform);
+}
+
+void Mesh::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.other += sizeof(Mesh) - sizeof(Object) - sizeof(AABB);
+    report.geometry += vertices.capacity() * sizeof(Point3) + normals.capacity() * sizeof(Vector3);
+    report.indices += faces.capacity() * sizeof(ObjReader::FaceIndices);
+    report.other += levels.capacity() * sizeof(MeshLevel);
+    for (const MeshLevel& detail : levels) {
+        report.geometry += detail.vertices.capacity() * sizeof(Point3) +
+                           detail.normals.capacity() * sizeof(Vector3);
+        report.indices += detail.faces.capacity() * sizeof(ObjReader::FaceIndices);
+    }
+    report.acceleration += sizeof(AABB);
+    report.addMaterial(material.get());
+}
+
+const AABB& Mesh::getLocalBounds() const {
+    return bounds;
+}
+
+void Mesh::generateLevels(int count, double ratio) {
+    for (int i = 0; i < count; ++i) {
+        MeshLevel source;
+        if (levels.empty()) {
+            source = MeshLevel{vertices, normals, faces};
+        }
+        const MeshLevel& previous = levels.empty() ? source : levels.back();
+        size_t target = static_cast<size_t>(previous.faces.size() * ratio);
+        if (target < 4) {
+            break; // Nothing left worth simplifying
+        }
+        MeshLevel simplified = simplifyMesh(previous, target);
+        if (simplified.faces.size() >= previous.faces.size()) {
+            break;
+        }
+        addLevel(std::move(simplified));
+    }
+}
+
+void Mesh::addLevel(MeshLevel detail) {
+    // Simplified vertices can move slightly out of the original bounds
+    for (const Point3& vertex : detail.vertices) {
+        bounds.expand(vertex);
+    }
+    levels.push_back(std::move(detail));
+}
+
+void Mesh::setLodSettings(const LodSettings& settings) {
+    if (settings.pinned >= static_cast<int>(levelCount())) {
+        throw std::runtime_error("Mesh: cannot pin level " + std::to_string(settings.pinned) +
+                                 ", the mesh has " + std::to_string(levelCount()) + " levels.");
+    }
+    lod = settings;
+    if (lod.pinned > 0) {
+        MeshLevel& pinned = levels[lod.pinned - 1];
+        vertices = std::move(pinned.vertices);
+        normals = std::move(pinned.normals);
+        faces = std::move(pinned.faces);
+        computeBounds();
+    }
+    if (lod.pinned >= 0) {
+        levels.clear();
+        levels.shrink_to_fit();
+        lod.pinned = 0;
+    }
+    level = 0;
+}
+
+const LodSettings& Mesh::getLodSettings() const {
+    return lod;
+}
+
+void Mesh::setViewpoint(const Point3& eye, double pixel_angle) {
+    level = 0;
+    if (levels.empty() || pixel_angle <= 0.0) {
+        return;
+    }
+    AABB world = boundingBox();
+    Point3 center = world.min + (world.max - world.min) * 0.5;
+    double radius = (world.max - world.min).magnitude() * 0.5;
+    double distance = (center - eye).magnitude() - radius;
+    if (distance <= 0.0) {
+        return; // The camera is within the mesh's bounding sphere
+    }
+
+    // Pixels covered by the projected bounding sphere, shared among the triangles of a level
+    double pixels = radius / distance / pixel_angle;
+    double area = M_PI * pixels * pixels;
+    while (level + 1 < levelCount() && area / levelFaceCount(level) < lod.triangle_pixels) {
+        level++;
+    }
+}
+
+size_t Mesh::levelCount() const {
+    return levels.size() + 1;
+}
+
+size_t Mesh::currentLevel() const {
+    return level;
+}
+
+size_t Mesh::levelFaceCount(size_t index) const {
+    return index == 0 ? faces.size() : levels.at(index - 1).faces.size();
+}
+
+const MeshLevel& Mesh::getLevel(size_t index) const {
+    if (index == 0) {
+        throw std::out_of_range("Mesh: level 0 is the full mesh, not a simplified level.");
+    }
+    return levels.at(index - 1);
+}
+
 }; // namespace Prism
@@ -0,0 +1,414 @@
+#include "Prism/objects/mesh_lod.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+
+namespace Prism {
+
+namespace {
+
+using Vec = std::array<double, 3>;
+
+Vec sub(const Vec& a, const Vec& b) {
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+Vec cross(const Vec& a, const Vec& b) {
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+double dot(const Vec& a, const Vec& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Boundary edges are held by planes this many times heavier than the surface planes
+constexpr double kBoundaryWeight = 1000.0;
+
+// Symmetric 4x4 matrix summing the squared distances to a set of planes, stored as its upper
+// triangle: a2 ab ac ad b2 bc bd c2 cd d2
+struct Quadric {
+    double q[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    static Quadric plane(const Vec& n, double d, double weight) {
+        Quadric k;
+        const double p[4] = {n[0], n[1], n[2], d};
+        int i = 0;
+        for (int r = 0; r < 4; ++r) {
+            for (int c = r; c < 4; ++c) {
+                k.q[i++] = p[r] * p[c] * weight;
+            }
+        }
+        return k;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        for (int i = 0; i < 10; ++i) {
+            q[i] += other.q[i];
+        }
+        return *this;
+    }
+
+    // Sum of the weighted squared distances from v to the planes
+    double error(const Vec& v) const {
+        const double x = v[0], y = v[1], z = v[2];
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x + q[4] * y * y +
+               2 * q[5] * y * z + 2 * q[6] * y + q[7] * z * z + 2 * q[8] * z + q[9];
+    }
+
+    // The point of least error, unless the planes do not pin one down (e.g. they are parallel)
+    bool optimum(Vec& v) const {
+        const double a = q[0], b = q[1], c = q[2], e = q[4], f = q[5], i = q[7];
+        const double det = a * (e * i - f * f) - b * (b * i - f * c) + c * (b * f - e * c);
+        const double scale = std::max({a, e, i});
+        if (!(std::abs(det) > 1e-9 * scale * scale * scale)) {
+            return false;
+        }
+        // Cramer's rule for A v = -(ad, bd, cd)
+        const double r0 = -q[3], r1 = -q[6], r2 = -q[8];
+        v[0] = (r0 * (e * i - f * f) - b * (r1 * i - f * r2) + c * (r1 * f - e * r2)) / det;
+        v[1] = (a * (r1 * i - r2 * f) - r0 * (b * i - f * c) + c * (b * r2 - r1 * c)) / det;
+        v[2] = (a * (e * r2 - f * r1) - b * (b * r2 - r1 * c) + r0 * (b * f - e * c)) / det;
+        return true;
+    }
+};
+
+struct Collapse {
+    double cost;
+    uint32_t a;
+    uint32_t b;
+    uint32_t stamp_a; ///< Versions of the vertices when the cost was computed
+    uint32_t stamp_b;
+    Vec position;
+
+    bool operator>(const Collapse& other) const {
+        return cost > other.cost;
+    }
+};
+
+class Simplifier {
+  public:
+    explicit Simplifier(const MeshLevel& mesh) {
+        weld(mesh);
+        buildQuadrics();
+    }
+
+    MeshLevel run(size_t target_faces) {
+        for (const auto& edge : edges) {
+            push(edge.first, edge.second);
+        }
+        while (live_faces > target_faces && !heap.empty()) {
+            Collapse collapse = heap.top();
+            heap.pop();
+            if (removed[collapse.a] || removed[collapse.b] ||
+                stamps[collapse.a] != collapse.stamp_a || stamps[collapse.b] != collapse.stamp_b) {
+                continue; // Outdated by an earlier collapse
+            }
+            if (!flips(collapse)) {
+                apply(collapse);
+            }
+        }
+        return output();
+    }
+
+  private:
+    // Merges vertices at the same position and collects the triangles and their edges
+    void weld(const MeshLevel& mesh) {
+        std::vector<uint32_t> order(mesh.vertices.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto key = [&](uint32_t i) {
+            const Point3& p = mesh.vertices[i];
+            return std::make_tuple(p.x, p.y, p.z);
+        };
+        std::sort(order.begin(), order.end(),
+                  [&](uint32_t a, uint32_t b) { return key(a) < key(b); });
+        std::vector<uint32_t> remap(mesh.vertices.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            if (k == 0 || key(order[k]) != key(order[k - 1])) {
+                const Point3& p = mesh.vertices[order[k]];
+                positions.push_back({p.x, p.y, p.z});
+            }
+            remap[order[k]] = static_cast<uint32_t>(positions.size() - 1);
+        }
+
+        normal_sums.assign(positions.size(), {0.0, 0.0, 0.0});
+        for (const auto& face : mesh.faces) {
+            std::array<uint32_t, 3> tri;
+            for (int c = 0; c < 3; ++c) {
+                tri[c] = remap[face.vertex_indices[c]];
+                if (face.normal_indices[c] < mesh.normals.size()) {
+                    const Vector3& n = mesh.normals[face.normal_indices[c]];
+                    Vec& sum = normal_sums[tri[c]];
+                    sum = {sum[0] + n.x, sum[1] + n.y, sum[2] + n.z};
+                }
+            }
+            if (tri[0] != tri[1] && tri[1] != tri[2] && tri[0] != tri[2]) {
+                faces.push_back(tri);
+            }
+        }
+        live_faces = faces.size();
+        alive.assign(faces.size(), 1);
+        removed.assign(positions.size(), 0);
+        stamps.assign(positions.size(), 0);
+        adjacency.resize(positions.size());
+        for (uint32_t f = 0; f < faces.size(); ++f) {
+            for (uint32_t v : faces[f]) {
+                adjacency[v].push_back(f);
+            }
+        }
+
+        for (const auto& tri : faces) {
+            for (int c = 0; c < 3; ++c) {
+                uint32_t a = tri[c], b = tri[(c + 1) % 3];
+                edges.emplace_back(std::min(a, b), std::max(a, b));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+    }
+
+    // Sums the planes of the triangles around each vertex, weighted by their area
+    void buildQuadrics() {
+        quadrics.assign(positions.size(), Quadric());
+        std::vector<std::pair<uint32_t, uint32_t>> unique_edges;
+        for (size_t k = 0; k < edges.size();) {
+            size_t run = k;
+            while (run < edges.size() && edges[run] == edges[k]) {
+                ++run;
+            }
+            if (run - k == 1) {
+                boundary.push_back(edges[k]);
+            }
+            unique_edges.push_back(edges[k]);
+            k = run;
+        }
+        edges = std::move(unique_edges);
+        std::sort(boundary.begin(), boundary.end());
+
+        for (const auto& tri : faces) {
+            Vec n = faceNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+            double area = std::sqrt(dot(n, n));
+            if (area == 0.0) {
+                continue;
+            }
+            Vec unit = {n[0] / area, n[1] / area, n[2] / area};
+            Quadric k = Quadric::plane(unit, -dot(unit, positions[tri[0]]), area);
+            for (uint32_t v : tri) {
+                quadrics[v] += k;
+            }
+
+            // A plane through each boundary edge, perpendicular to the triangle
+            for (int c = 0; c < 3; ++c) {
+                uint32_t a = tri[c], b = tri[(c + 1) % 3];
+                if (!std::binary_search(boundary.begin(), boundary.end(),
+                                        std::make_pair(std::min(a, b), std::max(a, b)))) {
+                    continue;
+                }
+                Vec edge = sub(positions[b], positions[a]);
+                Vec side = cross(edge, unit);
+                double length = std::sqrt(dot(side, side));
+                if (length == 0.0) {
+                    continue;
+                }
+                side = {side[0] / length, side[1] / length, side[2] / length};
+                Quadric constraint = Quadric::plane(side, -dot(side, positions[a]),
+                                                    kBoundaryWeight * dot(edge, edge));
+                quadrics[a] += constraint;
+                quadrics[b] += constraint;
+            }
+        }
+    }
+
+    static Vec faceNormal(const Vec& p0, const Vec& p1, const Vec& p2) {
+        return cross(sub(p1, p0), sub(p2, p0));
+    }
+
+    void push(uint32_t a, uint32_t b) {
+        Quadric q = quadrics[a];
+        q += quadrics[b];
+        const Vec& pa = positions[a];
+        const Vec& pb = positions[b];
+        Vec mid = {(pa[0] + pb[0]) / 2, (pa[1] + pb[1]) / 2, (pa[2] + pb[2]) / 2};
+
+        // The optimum of an ill-conditioned quadric can land far away from the edge
+        Vec best;
+        Vec edge = sub(pb, pa);
+        bool found = q.optimum(best);
+        if (found) {
+            Vec offset = sub(best, mid);
+            found = dot(offset, offset) <= 4.0 * dot(edge, edge);
+        }
+        if (!found) {
+            best = mid;
+            double best_error = q.error(mid);
+            for (const Vec* candidate : {&pa, &pb}) {
+                double error = q.error(*candidate);
+                if (error < best_error) {
+                    best_error = error;
+                    best = *candidate;
+                }
+            }
+        }
+        heap.push({std::max(0.0, q.error(best)), a, b, stamps[a], stamps[b], best});
+    }
+
+    // Checks whether moving the vertices of the collapse would turn a triangle over
+    bool flips(const Collapse& collapse) const {
+        for (uint32_t v : {collapse.a, collapse.b}) {
+            for (uint32_t f : adjacency[v]) {
+                if (!alive[f]) {
+                    continue;
+                }
+                const auto& tri = faces[f];
+                bool has_a = tri[0] == collapse.a || tri[1] == collapse.a || tri[2] == collapse.a;
+                bool has_b = tri[0] == collapse.b || tri[1] == collapse.b || tri[2] == collapse.b;
+                if (has_a && has_b) {
+                    continue; // Removed by the collapse
+                }
+                Vec moved[3];
+                for (int c = 0; c < 3; ++c) {
+                    moved[c] = tri[c] == v ? collapse.position : positions[tri[c]];
+                }
+                Vec before = faceNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+                Vec after = faceNormal(moved[0], moved[1], moved[2]);
+                if (dot(before, after) <= 0.0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void apply(const Collapse& collapse) {
+        const uint32_t a = collapse.a;
+        const uint32_t b = collapse.b;
+        positions[a] = collapse.position;
+        quadrics[a] += quadrics[b];
+        const Vec& nb = normal_sums[b];
+        normal_sums[a] = {normal_sums[a][0] + nb[0], normal_sums[a][1] + nb[1],
+                          normal_sums[a][2] + nb[2]};
+        removed[b] = 1;
+        stamps[a]++;
+        stamps[b]++;
+
+        for (uint32_t f : adjacency[b]) {
+            if (!alive[f]) {
+                continue;
+            }
+            auto& tri = faces[f];
+            if (tri[0] == a || tri[1] == a || tri[2] == a) {
+                alive[f] = 0;
+                live_faces--;
+                continue;
+            }
+            for (uint32_t& v : tri) {
+                if (v == b) {
+                    v = a;
+                }
+            }
+            adjacency[a].push_back(f);
+        }
+        adjacency[b].clear();
+
+        std::vector<uint32_t>& around = adjacency[a];
+        around.erase(std::remove_if(around.begin(), around.end(),
+                                    [&](uint32_t f) { return !alive[f]; }),
+                     around.end());
+        std::sort(around.begin(), around.end());
+        around.erase(std::unique(around.begin(), around.end()), around.end());
+
+        std::vector<uint32_t> neighbours;
+        for (uint32_t f : around) {
+            for (uint32_t v : faces[f]) {
+                if (v != a) {
+                    neighbours.push_back(v);
+                }
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        for (uint32_t v : neighbours) {
+            push(a, v);
+        }
+    }
+
+    MeshLevel output() const {
+        MeshLevel level;
+        std::vector<uint32_t> remap(positions.size(), UINT32_MAX);
+        std::vector<Vec> face_normals(positions.size(), Vec{0.0, 0.0, 0.0});
+        for (size_t f = 0; f < faces.size(); ++f) {
+            if (!alive[f]) {
+                continue;
+            }
+            ObjReader::FaceIndices face;
+            Vec n = faceNormal(positions[faces[f][0]], positions[faces[f][1]],
+                               positions[faces[f][2]]);
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v = faces[f][c];
+                if (remap[v] == UINT32_MAX) {
+                    remap[v] = static_cast<uint32_t>(level.vertices.size());
+                    level.vertices.emplace_back(positions[v][0], positions[v][1], positions[v][2]);
+                }
+                Vec& sum = face_normals[v];
+                sum = {sum[0] + n[0], sum[1] + n[1], sum[2] + n[2]};
+                face.vertex_indices[c] = face.normal_indices[c] = remap[v];
+            }
+            level.faces.push_back(face);
+        }
+
+        // Vertices without normals in the source fall back to their triangles' normals
+        level.normals.resize(level.vertices.size());
+        for (size_t v = 0; v < positions.size(); ++v) {
+            if (remap[v] == UINT32_MAX) {
+                continue;
+            }
+            const Vec& n = dot(normal_sums[v], normal_sums[v]) > 0.0 ? normal_sums[v]
+                                                                       : face_normals[v];
+            level.normals[remap[v]] = Vector3(n[0], n[1], n[2]).normalize();
+        }
+        return level;
+    }
+
+    std::vector<Vec> positions;
+    std::vector<Vec> normal_sums;
+    std::vector<Quadric> quadrics;
+    std::vector<std::array<uint32_t, 3>> faces;
+    std::vector<uint8_t> alive;
+    std::vector<uint8_t> removed;
+    std::vector<uint32_t> stamps;
+    std::vector<std::vector<uint32_t>> adjacency;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<std::pair<uint32_t, uint32_t>> boundary;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+    size_t live_faces = 0;
+};
+
+} // namespace
+
+MeshLevel MeshLevel::fromObj(const std::string& path) {
+    ObjReader reader(path);
+    if (reader.faces.empty()) {
+        throw std::runtime_error("Mesh level '" + path + "' has no triangles.");
+    }
+    MeshLevel level;
+    level.vertices.reserve(reader.vertices.size());
+    for (const auto& point : reader.vertices) {
+        level.vertices.emplace_back(point[0], point[1], point[2]);
+    }
+    level.normals.reserve(reader.normals.size());
+    for (const auto& normal : reader.normals) {
+        level.normals.emplace_back(normal[0], normal[1], normal[2]);
+    }
+    level.faces = std::move(reader.faces);
+    return level;
+}
+
+MeshLevel simplifyMesh(const MeshLevel& mesh, size_t target_faces) {
+    return Simplifier(mesh).run(target_faces);
+}
+
+} // namespace Prism
@@ -0,0 +1,164 @@
+#include "Prism/objects/mesh_proxy.hpp"
+
+#include "Prism/core/style.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace Prism {
+
+namespace {
+
+constexpr char kBoundsMagic[8] = {'P', 'R', 'S', 'M', 'B', 'N', 'D', 'S'};
+
+// Header of the `<obj>.bounds` cache. The OBJ size and modification time identify the version of
+// the OBJ file the bounds were computed from.
+struct BoundsCacheHeader {
+    char magic[8];
+    uint64_t obj_size;
+    int64_t obj_mtime;
+    double min[3];
+    double max[3];
+};
+
+std::filesystem::path boundsCachePath(const std::filesystem::path& path) {
+    std::filesystem::path cache = path;
+    cache += ".bounds";
+    return cache;
+}
+
+} // namespace
+
+MeshProxy::MeshProxy(std::filesystem::path path, const AABB& bounds,
+                     std::shared_ptr<Material> material)
+    : path(std::move(path)), bounds(bounds), material(std::move(material)) {
+}
+
+AABB MeshProxy::readBounds(const std::filesystem::path& path) {
+    std::error_code ec;
+    const uint64_t obj_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        throw std::runtime_error("Could not open mesh file: " + path.string());
+    }
+    const int64_t obj_mtime = static_cast<int64_t>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+
+    const auto cache_path = boundsCachePath(path);
+    std::ifstream cache_in(cache_path, std::ios::binary);
+    if (cache_in.is_open()) {
+        BoundsCacheHeader header;
+        if (cache_in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, kBoundsMagic, sizeof(kBoundsMagic)) == 0 &&
+            header.obj_size == obj_size && header.obj_mtime == obj_mtime) {
+            return AABB(Point3(header.min[0], header.min[1], header.min[2]),
+                        Point3(header.max[0], header.max[1], header.max[2]));
+        }
+    }
+
+    // Cache miss: scan the vertex positions only, without building any geometry
+    std::ifstream obj(path);
+    AABB box;
+    std::string line;
+    while (std::getline(obj, line)) {
+        if (line.size() < 2 || line[0] != 'v' || line[1] != ' ') {
+            continue;
+        }
+        std::istringstream iss(line.substr(2));
+        double x, y, z;
+        if (iss >> x >> y >> z) {
+            box.expand(Point3(x, y, z));
+        }
+    }
+    if (box.isEmpty()) {
+        throw std::runtime_error("Mesh file has no vertices: " + path.string());
+    }
+
+    BoundsCacheHeader header{};
+    std::memcpy(header.magic, kBoundsMagic, sizeof(kBoundsMagic));
+    header.obj_size = obj_size;
+    header.obj_mtime = obj_mtime;
+    header.min[0] = box.min.x;
+    header.min[1] = box.min.y;
+    header.min[2] = box.min.z;
+    header.max[0] = box.max.x;
+    header.max[1] = box.max.y;
+    header.max[2] = box.max.z;
+    std::ofstream cache_out(cache_path, std::ios::binary | std::ios::trunc);
+    if (cache_out.is_open()) {
+        cache_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    } else {
+        Style::logWarning("Could not write mesh bounds cache: " + cache_path.string());
+    }
+
+    return box;
+}
+
+bool MeshProxy::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
+    // Same conservative culling as Mesh::hit, but without the geometry
+    Ray transformed_ray = ray.transform(inverseTransform);
+    double box_t_min = t_min;
+    double box_t_max = INFINITY;
+    if (!bounds.clip(transformed_ray, box_t_min, box_t_max)) {
+        return false;
+    }
+
+    return geometry().hit(ray, t_min, t_max, rec);
+}
+
+Tessellation MeshProxy::tessellate(const TriangleSink& sink) const {
+    return isLoaded() ? mesh->tessellate(sink) : Tessellation::None;
+}
+
+bool MeshProxy::hitPrimitive(const Ray& ray, uint32_t primitive, double t_min, double t_max,
+                             HitRecord& rec) const {
+    return geometry().hitPrimitive(ray, primitive, t_min, t_max, rec);
+}
+
+AABB MeshProxy::boundingBox() const {
+    return bounds.transformed(transform);
+}
+
+void MeshProxy::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.other += sizeof(MeshProxy) - sizeof(Object) - sizeof(AABB) + path.native().capacity();
+    report.acceleration += sizeof(AABB);
+    report.addMaterial(material.get());
+    if (isLoaded()) {
+        mesh->accountMemory(report);
+    }
+}
+
+bool MeshProxy::isLoaded() const {
+    return loaded.load(std::memory_order_acquire);
+}
+
+const Mesh& MeshProxy::geometry() const {
+    if (!loaded.load(std::memory_order_acquire)) {
+        std::call_once(load_flag, [this] { load(); });
+    }
+    return *mesh;
+}
+
+void MeshProxy::load() const {
+    std::filesystem::path mesh_path = path;
+    auto loaded_mesh = std::make_unique<Mesh>(mesh_path);
+    if (material) {
+        loaded_mesh->setMaterial(material);
+    }
+    loaded_mesh->setTransform(transform, inverseTransform);
+    mesh = std::move(loaded_mesh);
+    loaded.store(true, std::memory_order_release);
+}
+
+void MeshProxy::transformChanged() {
+    if (isLoaded()) {
+        mesh->setTransform(transform, inverseTransform);
+    }
+}
+
+} // namespace Prism
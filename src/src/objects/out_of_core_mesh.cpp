@@ -0,0 +1,412 @@
+#include "Prism/objects/out_of_core_mesh.hpp"
+
+#include "Prism/core/matrix.hpp"
+#include "Prism/objects/triangle.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace Prism {
+
+namespace {
+
+constexpr char kClusterMagic[8] = {'P', 'R', 'S', 'M', 'C', 'L', 'S', 'T'};
+constexpr uint32_t kClusterVersion = 1;
+
+// Header of a cluster file. The source size and modification time identify the OBJ file the
+// clusters were built from (both are zero when built from an in-memory mesh).
+struct ClusterFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t cluster_count;
+    uint64_t triangle_count;
+    uint64_t cluster_triangles;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint32_t has_material;
+    uint32_t reserved;
+    double material[15]; // color, ka, ks, ke, ns, ni, d
+    double bounds[6];
+};
+
+struct ClusterRecord {
+    double min[3];
+    double max[3];
+    uint64_t offset;
+    uint64_t triangle_count;
+};
+
+// Each triangle is stored as three positions followed by three normals
+constexpr size_t kDoublesPerTriangle = 18;
+
+std::atomic<uint64_t> next_cache_id{1};
+
+// Spreads the lower 10 bits of v so that there are two zero bits between each of them
+uint32_t expandBits(uint32_t v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+uint32_t mortonCode(const Point3& p, const AABB& box) {
+    const Vector3 extent = box.diagonal();
+    auto quantize = [](double value, double min, double size) {
+        double unit = size > 0.0 ? (value - min) / size : 0.0;
+        return static_cast<uint32_t>(std::min(std::max(unit * 1024.0, 0.0), 1023.0));
+    };
+    return (expandBits(quantize(p.x, box.min.x, extent.x)) << 2) |
+           (expandBits(quantize(p.y, box.min.y, extent.y)) << 1) |
+           expandBits(quantize(p.z, box.min.z, extent.z));
+}
+
+bool readSourceStamp(const std::filesystem::path& path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    mtime = static_cast<int64_t>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+    return !ec;
+}
+
+std::filesystem::path clusterFilePath(const std::filesystem::path& obj_path) {
+    std::filesystem::path backing = obj_path;
+    backing += ".prclusters";
+    return backing;
+}
+
+} // namespace
+
+OutOfCoreMesh::OutOfCoreMesh(std::filesystem::path backing_path, GeometryCache& cache)
+    : backing_path(std::move(backing_path)), cache(&cache), cache_id(next_cache_id++) {
+    file.open(this->backing_path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open cluster file: " + this->backing_path.string());
+    }
+
+    ClusterFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kClusterMagic, sizeof(kClusterMagic)) != 0 ||
+        header.version != kClusterVersion) {
+        throw std::runtime_error("Not a valid cluster file: " + this->backing_path.string());
+    }
+
+    if (header.has_material) {
+        const double* m = header.material;
+        material = std::make_shared<Material>(Color(m[0], m[1], m[2]), Color(m[3], m[4], m[5]),
+                                              Color(m[6], m[7], m[8]), Color(m[9], m[10], m[11]),
+                                              m[12], m[13], m[14]);
+    } else {
+        material = std::make_shared<Material>();
+    }
+    bounds = AABB(Point3(header.bounds[0], header.bounds[1], header.bounds[2]),
+                  Point3(header.bounds[3], header.bounds[4], header.bounds[5]));
+    triangle_count = header.triangle_count;
+
+    std::vector<ClusterRecord> records(header.cluster_count);
+    if (!file.read(reinterpret_cast<char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(ClusterRecord)))) {
+        throw std::runtime_error("Truncated cluster file: " + this->backing_path.string());
+    }
+
+    clusters.reserve(records.size());
+    for (const auto& record : records) {
+        clusters.push_back(
+            ClusterInfo{AABB(Point3(record.min[0], record.min[1], record.min[2]),
+                             Point3(record.max[0], record.max[1], record.max[2])),
+                        record.offset, static_cast<uint32_t>(record.triangle_count)});
+    }
+}
+
+OutOfCoreMesh::~OutOfCoreMesh() {
+    cache->evictOwner(cache_id);
+}
+
+std::unique_ptr<OutOfCoreMesh> OutOfCoreMesh::build(const Mesh& mesh,
+                                                    const std::filesystem::path& backing_path,
+                                                    size_t cluster_triangles,
+                                                    GeometryCache& cache) {
+    write(mesh, backing_path, cluster_triangles, 0, 0);
+    return std::make_unique<OutOfCoreMesh>(backing_path, cache);
+}
+
+std::unique_ptr<OutOfCoreMesh> OutOfCoreMesh::fromObj(const std::filesystem::path& obj_path,
+                                                      size_t cluster_triangles,
+                                                      GeometryCache& cache) {
+    uint64_t source_size = 0;
+    int64_t source_mtime = 0;
+    if (!readSourceStamp(obj_path, source_size, source_mtime)) {
+        throw std::runtime_error("Could not open mesh file: " + obj_path.string());
+    }
+
+    const auto backing_path = clusterFilePath(obj_path);
+    {
+        std::ifstream in(backing_path, std::ios::binary);
+        ClusterFileHeader header;
+        if (in.is_open() && in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, kClusterMagic, sizeof(kClusterMagic)) == 0 &&
+            header.version == kClusterVersion && header.source_size == source_size &&
+            header.source_mtime == source_mtime &&
+            header.cluster_triangles == cluster_triangles) {
+            return std::make_unique<OutOfCoreMesh>(backing_path, cache);
+        }
+    }
+
+    // The OBJ is parsed once, converted, and released before rendering starts
+    {
+        std::filesystem::path path = obj_path;
+        Mesh mesh(path);
+        write(mesh, backing_path, cluster_triangles, source_size, source_mtime);
+    }
+    return std::make_unique<OutOfCoreMesh>(backing_path, cache);
+}
+
+void OutOfCoreMesh::write(const Mesh& mesh, const std::filesystem::path& backing_path,
+                          size_t cluster_triangles, uint64_t source_size, int64_t source_mtime) {
+    if (cluster_triangles == 0) {
+        throw std::runtime_error("Cluster size must be at least one triangle.");
+    }
+
+    const auto& vertices = mesh.getVertices();
+    const auto& normals = mesh.getNormals();
+    const auto& faces = mesh.getFaces();
+    const AABB& mesh_bounds = mesh.getLocalBounds();
+
+    // Sort the triangles along a Morton curve, so each cluster covers a compact region
+    std::vector<uint32_t> codes(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        const auto& v = faces[i].vertex_indices;
+        Point3 centroid((vertices[v[0]].x + vertices[v[1]].x + vertices[v[2]].x) / 3.0,
+                        (vertices[v[0]].y + vertices[v[1]].y + vertices[v[2]].y) / 3.0,
+                        (vertices[v[0]].z + vertices[v[1]].z + vertices[v[2]].z) / 3.0);
+        codes[i] = mortonCode(centroid, mesh_bounds);
+    }
+    std::vector<size_t> order(faces.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return codes[a] < codes[b]; });
+
+    const size_t cluster_count = (faces.size() + cluster_triangles - 1) / cluster_triangles;
+
+    ClusterFileHeader header{};
+    std::memcpy(header.magic, kClusterMagic, sizeof(kClusterMagic));
+    header.version = kClusterVersion;
+    header.cluster_count = static_cast<uint32_t>(cluster_count);
+    header.triangle_count = faces.size();
+    header.cluster_triangles = cluster_triangles;
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    if (auto mat = mesh.getMaterial()) {
+        header.has_material = 1;
+        const Color colors[4] = {mat->color, mat->ka, mat->ks, mat->ke};
+        for (int c = 0; c < 4; ++c) {
+            header.material[c * 3 + 0] = colors[c].r;
+            header.material[c * 3 + 1] = colors[c].g;
+            header.material[c * 3 + 2] = colors[c].b;
+        }
+        header.material[12] = mat->ns;
+        header.material[13] = mat->ni;
+        header.material[14] = mat->d;
+    }
+    header.bounds[0] = mesh_bounds.min.x;
+    header.bounds[1] = mesh_bounds.min.y;
+    header.bounds[2] = mesh_bounds.min.z;
+    header.bounds[3] = mesh_bounds.max.x;
+    header.bounds[4] = mesh_bounds.max.y;
+    header.bounds[5] = mesh_bounds.max.z;
+
+    std::vector<ClusterRecord> records(cluster_count);
+    uint64_t offset = sizeof(ClusterFileHeader) + cluster_count * sizeof(ClusterRecord);
+
+    std::ofstream out(backing_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Could not write cluster file: " + backing_path.string());
+    }
+    // The cluster table is only known once the data is laid out; reserve its space first
+    out.seekp(static_cast<std::streamoff>(offset));
+
+    std::vector<double> data;
+    for (size_t c = 0; c < cluster_count; ++c) {
+        const size_t first = c * cluster_triangles;
+        const size_t last = std::min(first + cluster_triangles, faces.size());
+
+        AABB cluster_bounds;
+        data.clear();
+        data.reserve((last - first) * kDoublesPerTriangle);
+        for (size_t i = first; i < last; ++i) {
+            const auto& face = faces[order[i]];
+            for (int k = 0; k < 3; ++k) {
+                const Point3& p = vertices[face.vertex_indices[k]];
+                cluster_bounds.expand(p);
+                data.insert(data.end(), {p.x, p.y, p.z});
+            }
+            for (int k = 0; k < 3; ++k) {
+                const Vector3& n = normals[face.normal_indices[k]];
+                data.insert(data.end(), {n.x, n.y, n.z});
+            }
+        }
+        out.write(reinterpret_cast<const char*>(data.data()),
+                  static_cast<std::streamsize>(data.size() * sizeof(double)));
+
+        ClusterRecord& record = records[c];
+        record.min[0] = cluster_bounds.min.x;
+        record.min[1] = cluster_bounds.min.y;
+        record.min[2] = cluster_bounds.min.z;
+        record.max[0] = cluster_bounds.max.x;
+        record.max[1] = cluster_bounds.max.y;
+        record.max[2] = cluster_bounds.max.z;
+        record.offset = offset;
+        record.triangle_count = last - first;
+        offset += data.size() * sizeof(double);
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(ClusterRecord)));
+    if (!out) {
+        throw std::runtime_error("Could not write cluster file: " + backing_path.string());
+    }
+}
+
+std::shared_ptr<const GeometryCluster> OutOfCoreMesh::loadCluster(size_t index) const {
+    const ClusterInfo& info = clusters[index];
+    std::vector<double> data(info.triangle_count * kDoublesPerTriangle);
+    {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(info.offset));
+        if (!file.read(reinterpret_cast<char*>(data.data()),
+                       static_cast<std::streamsize>(data.size() * sizeof(double)))) {
+            throw std::runtime_error("Truncated cluster file: " + backing_path.string());
+        }
+    }
+
+    auto result = std::make_shared<GeometryCluster>();
+    result->vertices.reserve(info.triangle_count * 3);
+    result->normals.reserve(info.triangle_count * 3);
+    for (size_t i = 0; i < data.size(); i += kDoublesPerTriangle) {
+        const double* t = data.data() + i;
+        for (int k = 0; k < 3; ++k) {
+            result->vertices.emplace_back(t[k * 3], t[k * 3 + 1], t[k * 3 + 2]);
+        }
+        for (int k = 3; k < 6; ++k) {
+            result->normals.emplace_back(t[k * 3], t[k * 3 + 1], t[k * 3 + 2]);
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const GeometryCluster> OutOfCoreMesh::cluster(size_t index) const {
+    return cache->acquire(cache_id, static_cast<uint32_t>(index),
+                          [this, index] { return loadCluster(index); });
+}
+
+bool OutOfCoreMesh::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
+    Ray transformed_ray = ray.transform(inverseTransform);
+
+    double box_t_min = t_min;
+    double box_t_max = INFINITY;
+    if (!bounds.clip(transformed_ray, box_t_min, box_t_max)) {
+        return false;
+    }
+
+    // Collect the clusters the ray crosses, ordered by where it enters them
+    thread_local std::vector<std::pair<double, size_t>> candidates;
+    candidates.clear();
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        double enter = t_min;
+        double exit = INFINITY;
+        if (clusters[i].bounds.clip(transformed_ray, enter, exit)) {
+            candidates.emplace_back(enter, i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    rec.t = t_max;
+    for (const auto& candidate : candidates) {
+        if (candidate.first >= rec.t) {
+            break; // Every remaining cluster starts behind the closest hit
+        }
+        // Holding the pointer pins the cluster, even if it is evicted meanwhile
+        std::shared_ptr<const GeometryCluster> geometry = cluster(candidate.second);
+        const auto& v = geometry->vertices;
+        const auto& n = geometry->normals;
+        for (size_t k = 0; k < v.size(); k += 3) {
+            hitTriangle(transformed_ray, v[k], v[k + 1], v[k + 2], n[k], n[k + 1], n[k + 2], t_min,
+                        rec.t, rec);
+        }
+    }
+
+    Point3 world_p;
+    double world_t = INFINITY;
+
+    if (rec.t < t_max) { // If a hit was found, transform the hit point back to world space
+        world_p = transform * transformed_ray.at(rec.t);
+        world_t = (world_p - ray.origin()).dot(ray.direction().normalize());
+    }
+
+    if (world_t < t_min || world_t > t_max) {
+        return false;
+    }
+
+    rec.t = world_t;
+    rec.p = world_p;
+
+    Vector3 world_normal = (inverseTransposeTransform * rec.normal).normalize();
+    rec.set_face_normal(ray, world_normal);
+
+    rec.material = material;
+
+    return true;
+}
+
+AABB OutOfCoreMesh::boundingBox() const {
+    return bounds.transformed(transform);
+}
+
+void OutOfCoreMesh::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.other += sizeof(OutOfCoreMesh) - sizeof(Object) + backing_path.native().capacity();
+    report.acceleration += clusters.capacity() * sizeof(ClusterInfo);
+    report.addMaterial(material.get());
+    // The cache is shared by all out-of-core meshes and may fill up to its budget
+    if (report.countOnce(cache)) {
+        report.geometry += cache->budget();
+    }
+}
+
+void OutOfCoreMesh::setMaterial(std::shared_ptr<Material> new_material) {
+    material = std::move(new_material);
+}
+
+std::shared_ptr<Material> OutOfCoreMesh::getMaterial() const {
+    return material;
+}
+
+const AABB& OutOfCoreMesh::getLocalBounds() const {
+    return bounds;
+}
+
+const std::filesystem::path& OutOfCoreMesh::getBackingPath() const {
+    return backing_path;
+}
+
+size_t OutOfCoreMesh::clusterCount() const {
+    return clusters.size();
+}
+
+size_t OutOfCoreMesh::triangleCount() const {
+    return triangle_count;
+}
+
+} // namespace Prism
@@ -10,6 +10,18 @@ Plane::Plane(Point3 point_on_plane, Vector3 normal, std::shared_ptr<Material> ma
     : point_on_plane(point_on_plane), normal(normal), material(std::move(material)) {
 }
 
+Point3 Plane::getPoint() const {
+    return point_on_plane;
+}
+
+Vector3 Plane::getNormal() const {
+    return normal;
+}
+
+std::shared_ptr<Material> Plane::getMaterial() const {
+    return material;
+}
+
 bool Plane::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
     Ray transformed_ray = ray.transform(inverseTransform);
 
@@ -36,4 +48,10 @@ bool Plane::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) cons
     return true;
 }
 
+void Plane::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.geometry += sizeof(Plane) - sizeof(Object);
+    report.addMaterial(material.get());
+}
+
 } // namespace Prism
\ No newline at end of file
@@ -11,6 +11,61 @@ Sphere::Sphere(Point3 center, double radius, std::shared_ptr<Material> material)
     : center(center), radius(radius), material(std::move(material)) {
 }
 
+Point3 Sphere::getCenter() const {
+    return center;
+}
+
+double Sphere::getRadius() const {
+    return radius;
+}
+
+std::shared_ptr<Material> Sphere::getMaterial() const {
+    return material;
+}
+
+AABB Sphere::boundingBox() const {
+    Vector3 extent(radius, radius, radius);
+    return AABB(center + (-extent), center + extent).transformed(transform);
+}
+
+Tessellation Sphere::tessellate(const TriangleSink& sink) const {
+    // Faces span at most half the diagonal of a quad from their vertices, so pushing the vertices
+    // out by 1 / cos of that angle keeps every face outside the sphere
+    constexpr int kStacks = 16;
+    constexpr int kSlices = 32;
+    const double stack_angle = M_PI / kStacks;
+    const double slice_angle = 2.0 * M_PI / kSlices;
+    const double scale = radius / std::cos(0.5 * std::hypot(stack_angle, slice_angle));
+    auto vertex = [&](int i, int j) {
+        const double theta = stack_angle * i;
+        const double phi = slice_angle * j;
+        return transform * (center + Vector3(std::sin(theta) * std::cos(phi), std::cos(theta),
+                                             std::sin(theta) * std::sin(phi)) *
+                                         scale);
+    };
+    for (int i = 0; i < kStacks; ++i) {
+        for (int j = 0; j < kSlices; ++j) {
+            const Point3 a = vertex(i, j);
+            const Point3 b = vertex(i, j + 1);
+            const Point3 c = vertex(i + 1, j);
+            const Point3 d = vertex(i + 1, j + 1);
+            if (i > 0) {
+                sink(0, a, b, c);
+            }
+            if (i < kStacks - 1) {
+                sink(0, b, d, c);
+            }
+        }
+    }
+    return Tessellation::Enclosing;
+}
+
+void Sphere::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.geometry += sizeof(Sphere) - sizeof(Object);
+    report.addMaterial(material.get());
+}
+
 //(d⋅d)t2+(2d⋅oc)t+(oc⋅oc−r2)=0
 // solve using reducted quadratic formula
 // t = (-b ± √(b² - 4ac)) / 2a
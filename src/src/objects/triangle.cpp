@@ -19,6 +19,28 @@ Point3 Triangle::getPoint2() const {
 Point3 Triangle::getPoint3() const {
     return point3;
 }
+std::shared_ptr<Material> Triangle::getMaterial() const {
+    return material;
+}
+
+AABB Triangle::boundingBox() const {
+    AABB box;
+    box.expand(point1);
+    box.expand(point2);
+    box.expand(point3);
+    return box.transformed(transform);
+}
+
+Tessellation Triangle::tessellate(const TriangleSink& sink) const {
+    sink(0, transform * point1, transform * point2, transform * point3);
+    return Tessellation::Exact;
+}
+
+void Triangle::accountMemory(MemoryReport& report) const {
+    accountTransforms(report);
+    report.geometry += sizeof(Triangle) - sizeof(Object);
+    report.addMaterial(material.get());
+}
 
 bool Triangle::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
     const Ray transformed_ray = ray.transform(inverseTransform);
@@ -102,11 +124,18 @@ Point3 MeshTriangle::getPoint3() const {
 }
 
 bool MeshTriangle::hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
+    return hitTriangle(ray, *point1, *point2, *point3, *normal1, *normal2, *normal3, t_min, t_max,
+                       rec);
+}
+
+bool hitTriangle(const Ray& ray, const Point3& p1, const Point3& p2, const Point3& p3,
+                 const Vector3& n1, const Vector3& n2, const Vector3& n3, double t_min,
+                 double t_max, HitRecord& rec) {
 
     const double epsilon = 1e-8;
     const Vector3 ray_direction = ray.direction();
-    const Vector3 edge1 = this->getPoint2() - this->getPoint1();
-    const Vector3 edge2 = this->getPoint3() - this->getPoint1();
+    const Vector3 edge1 = p2 - p1;
+    const Vector3 edge2 = p3 - p1;
     const Vector3 h = ray_direction ^ edge2;
     const double a = edge1 * h;
 
@@ -114,7 +143,7 @@ bool MeshTriangle::hit(const Ray& ray, double t_min, double t_max, HitRecord& re
         return false;
 
     const double f = 1.0 / a;
-    const Vector3 s = ray.origin() - this->getPoint1();
+    const Vector3 s = ray.origin() - p1;
     const double u = f * (s * h);
 
     if (u < 0.0 || u > 1.0)
@@ -132,10 +161,10 @@ bool MeshTriangle::hit(const Ray& ray, double t_min, double t_max, HitRecord& re
 
         const double w = 1.0 - u - v;
         rec.t = t;
-        rec.normal = ((*normal1 * w) + (*normal2 * u) + (*normal3 * v)).normalize();
+        rec.normal = ((n1 * w) + (n2 * u) + (n3 * v)).normalize();
         return true;
     }
     return false;
 }
 
-} // namespace Prism
\ No newline at end of file
+} // namespace Prism
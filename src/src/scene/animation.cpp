@@ -0,0 +1,100 @@
+#include "Prism/scene/animation.hpp"
+
+#include "Prism/scene/scene.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Prism {
+
+namespace {
+
+Vector3 lerp(const Vector3& a, const Vector3& b, double t) {
+    return a + (b - a) * t;
+}
+
+Point3 lerp(const Point3& a, const Point3& b, double t) {
+    return a + (b - a) * t;
+}
+
+// Finds the keyframes around `frame` in keys sorted by frame. Returns the index of the first one
+// and the interpolation parameter towards the next; the parameter is 0 outside the keyed range.
+template <typename Key>
+size_t bracket(const std::vector<Key>& keys, double frame, double& t) {
+    t = 0.0;
+    if (frame <= keys.front().frame) {
+        return 0;
+    }
+    if (frame >= keys.back().frame) {
+        return keys.size() - 1;
+    }
+    auto next = std::upper_bound(keys.begin(), keys.end(), frame,
+                                 [](double f, const Key& key) { return f < key.frame; });
+    size_t index = static_cast<size_t>(next - keys.begin()) - 1;
+    t = (frame - keys[index].frame) / (keys[index + 1].frame - keys[index].frame);
+    return index;
+}
+
+template <typename Key> void sortByFrame(std::vector<Key>& keys) {
+    if (keys.empty()) {
+        throw std::runtime_error("Animation tracks need at least one keyframe.");
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+                     [](const Key& a, const Key& b) { return a.frame < b.frame; });
+}
+
+} // namespace
+
+void Animation::setFrameCount(int count) {
+    frame_count_ = std::max(0, count);
+}
+
+void Animation::setCameraKeys(std::vector<CameraKey> keys) {
+    sortByFrame(keys);
+    camera_keys_ = std::move(keys);
+}
+
+void Animation::addTrack(size_t object, const Matrix& base, std::vector<TransformKey> keys) {
+    sortByFrame(keys);
+    tracks_.push_back(Track{object, base, std::move(keys)});
+}
+
+Camera Animation::cameraAt(const Camera& base, double frame) const {
+    if (camera_keys_.empty()) {
+        return base;
+    }
+    double t;
+    size_t i = bracket(camera_keys_, frame, t);
+    const CameraKey& a = camera_keys_[i];
+    const CameraKey& b = camera_keys_[std::min(i + 1, camera_keys_.size() - 1)];
+    return Camera(lerp(a.lookfrom, b.lookfrom, t), lerp(a.lookat, b.lookat, t), base.up,
+                  base.screen_distance, base.screen_height, base.screen_width, base.pixel_height,
+                  base.pixel_width);
+}
+
+Matrix Animation::transformAt(const Track& track, double frame) {
+    double t;
+    size_t i = bracket(track.keys, frame, t);
+    const TransformKey& a = track.keys[i];
+    const TransformKey& b = track.keys[std::min(i + 1, track.keys.size() - 1)];
+
+    Vector3 translation = lerp(a.translation, b.translation, t);
+    Vector3 scale = lerp(a.scale, b.scale, t);
+    Vector3 axis = lerp(a.axis, b.axis, t).normalize();
+    double angle = a.angle + (b.angle - a.angle) * t;
+    return Matrix::translation(translation.x, translation.y, translation.z) *
+           Matrix::rotation(angle, axis) * Matrix::scaling(scale.x, scale.y, scale.z) *
+           track.base;
+}
+
+void Animation::apply(Scene& scene, double frame, const Camera& base_camera) const {
+    if (!camera_keys_.empty()) {
+        scene.setCamera(cameraAt(base_camera, frame));
+    }
+    for (const Track& track : tracks_) {
+        Matrix transform = transformAt(track, frame);
+        scene.updateObject(track.object, [&](Object& object) { object.setTransform(transform); });
+    }
+}
+
+} // namespace Prism
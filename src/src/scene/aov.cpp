@@ -0,0 +1,164 @@
+#include "Prism/scene/aov.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Prism {
+
+namespace {
+
+// OpenEXR magic number and version field (version 2, single-part scanline file)
+constexpr uint32_t kExrMagic = 20000630;
+constexpr uint32_t kExrVersion = 2;
+
+// Pixel type of a 32-bit float channel
+constexpr uint32_t kExrFloat = 2;
+
+// Appends values in little-endian byte order, as OpenEXR stores them
+struct ByteWriter {
+    std::vector<char> bytes;
+
+    void u8(uint8_t value) {
+        bytes.push_back(static_cast<char>(value));
+    }
+
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            u8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void u64(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            u8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void f32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u32(bits);
+    }
+
+    void str(const std::string& value) {
+        bytes.insert(bytes.end(), value.begin(), value.end());
+        u8(0);
+    }
+
+    // Attribute header: name, type name and size of the value that follows
+    void attribute(const std::string& name, const std::string& type, uint32_t size) {
+        str(name);
+        str(type);
+        u32(size);
+    }
+};
+
+} // namespace
+
+void writeAovs(const std::filesystem::path& path, const GuideBuffers& buffers,
+               const AovSettings& settings) {
+    if (!settings.any()) {
+        throw std::runtime_error("writeAovs: no AOV channel is selected.");
+    }
+    if ((settings.object_id || settings.material_id) && !buffers.has_ids) {
+        throw std::runtime_error("writeAovs: the buffers were collected without ids.");
+    }
+
+    // Channels must be listed, and stored within each scanline, in alphabetical order
+    std::vector<std::pair<std::string, const float*>> channels;
+    if (settings.depth) {
+        channels.emplace_back("Z", buffers.depth.data());
+    }
+    if (settings.normal) {
+        channels.emplace_back("N.X", buffers.normal[0].data());
+        channels.emplace_back("N.Y", buffers.normal[1].data());
+        channels.emplace_back("N.Z", buffers.normal[2].data());
+    }
+    if (settings.albedo) {
+        channels.emplace_back("albedo.R", buffers.albedo[0].data());
+        channels.emplace_back("albedo.G", buffers.albedo[1].data());
+        channels.emplace_back("albedo.B", buffers.albedo[2].data());
+    }
+    if (settings.object_id) {
+        channels.emplace_back("objectId", buffers.object_id.data());
+    }
+    if (settings.material_id) {
+        channels.emplace_back("materialId", buffers.material_id.data());
+    }
+    std::sort(channels.begin(), channels.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    const int width = buffers.width;
+    const int height = buffers.height;
+    ByteWriter out;
+    out.u32(kExrMagic);
+    out.u32(kExrVersion);
+
+    uint32_t channel_list_size = 1;
+    for (const auto& channel : channels) {
+        channel_list_size += static_cast<uint32_t>(channel.first.size()) + 1 + 16;
+    }
+    out.attribute("channels", "chlist", channel_list_size);
+    for (const auto& channel : channels) {
+        out.str(channel.first);
+        out.u32(kExrFloat);
+        out.u32(0); // pLinear and reserved bytes
+        out.u32(1); // x sampling
+        out.u32(1); // y sampling
+    }
+    out.u8(0);
+    out.attribute("compression", "compression", 1);
+    out.u8(0); // No compression
+    for (const char* window : {"dataWindow", "displayWindow"}) {
+        out.attribute(window, "box2i", 16);
+        out.u32(0);
+        out.u32(0);
+        out.u32(static_cast<uint32_t>(width - 1));
+        out.u32(static_cast<uint32_t>(height - 1));
+    }
+    out.attribute("lineOrder", "lineOrder", 1);
+    out.u8(0); // Increasing y
+    out.attribute("pixelAspectRatio", "float", 4);
+    out.f32(1.0f);
+    out.attribute("screenWindowCenter", "v2f", 8);
+    out.f32(0.0f);
+    out.f32(0.0f);
+    out.attribute("screenWindowWidth", "float", 4);
+    out.f32(1.0f);
+    out.u8(0); // End of header
+
+    // Offset table, then one chunk per scanline: y, data size, then each channel's row
+    const uint64_t line_size = static_cast<uint64_t>(width) * channels.size() * sizeof(float);
+    const uint64_t first_line = out.bytes.size() + static_cast<uint64_t>(height) * 8;
+    for (int y = 0; y < height; ++y) {
+        out.u64(first_line + static_cast<uint64_t>(y) * (8 + line_size));
+    }
+    out.bytes.reserve(out.bytes.size() + static_cast<size_t>(height) * (8 + line_size));
+    for (int y = 0; y < height; ++y) {
+        out.u32(static_cast<uint32_t>(y));
+        out.u32(static_cast<uint32_t>(line_size));
+        for (const auto& channel : channels) {
+            const float* row = channel.second + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                out.f32(row[x]);
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open the file for writing: " + path.string());
+    }
+    file.write(out.bytes.data(), static_cast<std::streamsize>(out.bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Could not write AOVs: " + path.string());
+    }
+}
+
+} // namespace Prism
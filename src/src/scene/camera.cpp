@@ -2,6 +2,7 @@
 
 #include "Prism/core/utils.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
@@ -26,4 +27,28 @@ Camera::Camera(const Point3& position, const Point3& target, const Vector3& upve
     pixel_00_loc = top_left_corner + (pixel_delta_u * 0.5) - (pixel_delta_v * 0.5);
 }
 
-} // namespace Prism
\ No newline at end of file
+double Camera::project(const Point3& p, double& x, double& y) const {
+    // Image point (0, 0), and the unit normal of the view plane, pointing away from the camera
+    const Point3 origin = pixel_00_loc + (pixel_delta_u * -0.5) + (pixel_delta_v * 0.5);
+    Vector3 forward = pixel_delta_u.cross(pixel_delta_v).normalize();
+    if (forward.dot(origin - pos) < 0.0) {
+        forward = forward * -1.0;
+    }
+    const Vector3 offset = p - pos;
+    const double depth = forward.dot(offset);
+    if (depth <= 0.0) {
+        return depth;
+    }
+    const Vector3 on_plane = (pos + offset * (forward.dot(origin - pos) / depth)) - origin;
+    x = on_plane.dot(pixel_delta_u) / pixel_delta_u.dot(pixel_delta_u);
+    y = -on_plane.dot(pixel_delta_v) / pixel_delta_v.dot(pixel_delta_v);
+    return depth;
+}
+
+Camera Camera::scaled(double factor) const {
+    int height = std::max(1, static_cast<int>(std::lround(pixel_height * factor)));
+    int width = std::max(1, static_cast<int>(std::lround(pixel_width * factor)));
+    return Camera(pos, aim, up, screen_distance, screen_height, screen_width, height, width);
+}
+
+} // namespace Prism
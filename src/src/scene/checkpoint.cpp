@@ -0,0 +1,152 @@
+#include "Prism/scene/checkpoint.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace Prism {
+
+namespace {
+
+// --- On-disk layout ---
+//
+// [CheckpointHeader][RecordHeader][float values]...[RecordHeader][float values]
+//
+// Records are appended in the order tiles finish, in native byte order (the byte order mark
+// rejects files written on another architecture).
+
+constexpr char kCheckpointMagic[8] = {'P', 'R', 'S', 'M', 'C', 'K', 'P', 'T'};
+constexpr uint32_t kCheckpointVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t fingerprint;
+    uint64_t tile_count;
+};
+
+struct RecordHeader {
+    uint32_t tile;
+    uint32_t value_count;
+    uint64_t samples;
+    uint64_t checksum; ///< Hash of the other fields and of the values
+};
+
+uint64_t recordChecksum(const RecordHeader& header, const float* values) {
+    uint64_t hash = RenderCheckpoint::hash(&header.tile, sizeof(header.tile));
+    hash = RenderCheckpoint::hash(&header.value_count, sizeof(header.value_count), hash);
+    hash = RenderCheckpoint::hash(&header.samples, sizeof(header.samples), hash);
+    return RenderCheckpoint::hash(values, header.value_count * sizeof(float), hash);
+}
+
+} // namespace
+
+RenderCheckpoint::RenderCheckpoint(std::filesystem::path path, uint64_t fingerprint,
+                                   size_t tile_count)
+    : path_(std::move(path)), fingerprint_(fingerprint), finished_(tile_count, 0) {}
+
+uint64_t RenderCheckpoint::hash(const void* data, size_t size, uint64_t hash) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+size_t RenderCheckpoint::resume(
+    const std::function<void(size_t tile, const TileRecord& record)>& restore) {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+    CheckpointHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0 ||
+        header.version != kCheckpointVersion || header.byte_order != kByteOrderMark ||
+        header.fingerprint != fingerprint_ || header.tile_count != finished_.size()) {
+        return 0;
+    }
+    has_header_ = true;
+
+    size_t restored = 0;
+    uint64_t valid_end = sizeof(header);
+    TileRecord record;
+    RecordHeader record_header;
+    while (file.read(reinterpret_cast<char*>(&record_header), sizeof(record_header))) {
+        record.values.resize(record_header.value_count);
+        if (record_header.tile >= finished_.size() ||
+            !file.read(reinterpret_cast<char*>(record.values.data()),
+                       static_cast<std::streamsize>(record.values.size() * sizeof(float))) ||
+            recordChecksum(record_header, record.values.data()) != record_header.checksum) {
+            break;
+        }
+        valid_end += sizeof(record_header) + record.values.size() * sizeof(float);
+        if (finished_[record_header.tile]) {
+            continue;
+        }
+        record.samples = record_header.samples;
+        restore(record_header.tile, record);
+        finished_[record_header.tile] = 1;
+        finished_count_++;
+        restored++;
+    }
+    file.close();
+
+    // Later records are appended after the last complete one
+    std::error_code error;
+    if (std::filesystem::file_size(path_, error) != valid_end && !error) {
+        std::filesystem::resize_file(path_, valid_end, error);
+        if (error) {
+            has_header_ = false;
+        }
+    }
+    return restored;
+}
+
+void RenderCheckpoint::add(size_t tile, const TileRecord& record) {
+    if (finished_[tile]) {
+        return;
+    }
+    RecordHeader header{static_cast<uint32_t>(tile), static_cast<uint32_t>(record.values.size()),
+                        record.samples, 0};
+    header.checksum = recordChecksum(header, record.values.data());
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    pending_.insert(pending_.end(), bytes, bytes + sizeof(header));
+    bytes = reinterpret_cast<const char*>(record.values.data());
+    pending_.insert(pending_.end(), bytes, bytes + record.values.size() * sizeof(float));
+    finished_[tile] = 1;
+    finished_count_++;
+}
+
+void RenderCheckpoint::flush() {
+    if (pending_.empty() && has_header_) {
+        return;
+    }
+    std::ofstream file(path_, has_header_ ? std::ios::binary | std::ios::app
+                                          : std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open the checkpoint file: " + path_.string());
+    }
+    if (!has_header_) {
+        CheckpointHeader header{};
+        std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+        header.version = kCheckpointVersion;
+        header.byte_order = kByteOrderMark;
+        header.fingerprint = fingerprint_;
+        header.tile_count = finished_.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    file.write(pending_.data(), static_cast<std::streamsize>(pending_.size()));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("Could not write the checkpoint file: " + path_.string());
+    }
+    has_header_ = true;
+    pending_.clear();
+}
+
+} // namespace Prism
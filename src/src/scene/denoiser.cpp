@@ -0,0 +1,244 @@
+#include "Prism/scene/denoiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Prism {
+
+namespace {
+
+// Taps of the B3-spline kernel; the 2D kernel is their outer product
+constexpr float kKernel[5] = {1.0f / 16, 1.0f / 4, 3.0f / 8, 1.0f / 4, 1.0f / 16};
+
+// exp(-x) for x >= 0, as 1 / (1 + x / 256)^256. Only multiplications and a division, so the
+// filter loops vectorize instead of calling into libm; the weights lose less than 3% below x = 4
+// and large exponents still go to 0.
+inline float expNeg(float x) {
+    float y = 1.0f + x * (1.0f / 256.0f);
+    y *= y;
+    y *= y;
+    y *= y;
+    y *= y;
+    y *= y;
+    y *= y;
+    y *= y;
+    y *= y;
+    return 1.0f / y;
+}
+
+// A channel surrounded by a border of `pad` pixels that repeat the edge pixels, so that the
+// filter taps read out of the image without bounds checks
+struct PaddedPlane {
+    int width;
+    int height;
+    int pad;
+    int stride;
+    std::vector<float> data;
+
+    PaddedPlane(int width, int height, int pad)
+        : width(width), height(height), pad(pad), stride(width + 2 * pad),
+          data(static_cast<size_t>(stride) * (height + 2 * pad)) {
+    }
+
+    // First pixel of row y of the image (the border starts before it)
+    const float* row(int y) const {
+        return data.data() + static_cast<size_t>(y + pad) * stride + pad;
+    }
+
+    // Copies an image-sized plane in and replicates its edges into the border
+    void fill(const float* source) {
+        for (int y = -pad; y < height + pad; ++y) {
+            const float* src = source + static_cast<size_t>(std::clamp(y, 0, height - 1)) * width;
+            float* dst = data.data() + static_cast<size_t>(y + pad) * stride;
+            std::fill(dst, dst + pad, src[0]);
+            std::copy(src, src + width, dst + pad);
+            std::fill(dst + pad + width, dst + stride, src[width - 1]);
+        }
+    }
+};
+
+} // namespace
+
+GuideBuffers::GuideBuffers(int width, int height, bool ids)
+    : width(width), height(height), has_ids(ids) {
+    clear();
+}
+
+void GuideBuffers::resolve() {
+    const size_t size = count.size();
+    for (size_t i = 0; i < size; ++i) {
+        if (count[i] > 1) {
+            const float inv = 1.0f / static_cast<float>(count[i]);
+            depth[i] *= inv;
+            for (int c = 0; c < 3; ++c) {
+                albedo[c][i] *= inv;
+            }
+        }
+        float length = std::sqrt(normal[0][i] * normal[0][i] + normal[1][i] * normal[1][i] +
+                                 normal[2][i] * normal[2][i]);
+        if (length > 0.0f) {
+            for (int c = 0; c < 3; ++c) {
+                normal[c][i] /= length;
+            }
+        }
+        count[i] = 1;
+    }
+}
+
+void GuideBuffers::clear() {
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height);
+    depth.assign(size, 0.0f);
+    for (int c = 0; c < 3; ++c) {
+        normal[c].assign(size, 0.0f);
+        albedo[c].assign(size, 0.0f);
+    }
+    if (has_ids) {
+        object_id.assign(size, 0.0f);
+        material_id.assign(size, 0.0f);
+    }
+    count.assign(size, 0);
+}
+
+void GuideBuffers::clearPixel(size_t pixel) {
+    depth[pixel] = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        normal[c][pixel] = 0.0f;
+        albedo[c][pixel] = 0.0f;
+    }
+    if (has_ids) {
+        object_id[pixel] = 0.0f;
+        material_id[pixel] = 0.0f;
+    }
+    count[pixel] = 0;
+}
+
+void denoise(Framebuffer& image, const GuideBuffers& guides, const DenoiseSettings& settings) {
+    const int width = image.width();
+    const int height = image.height();
+    if (guides.width != width || guides.height != height) {
+        throw std::runtime_error("denoise: the guide buffers do not match the image size.");
+    }
+    const int levels = std::max(0, settings.levels);
+    if (levels == 0 || width == 0 || height == 0) {
+        return;
+    }
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height);
+    const int pad = 2 << (levels - 1); // Farthest tap of the last level
+
+    PaddedPlane color[3] = {{width, height, pad}, {width, height, pad}, {width, height, pad}};
+    PaddedPlane normal[3] = {{width, height, pad}, {width, height, pad}, {width, height, pad}};
+    PaddedPlane albedo[3] = {{width, height, pad}, {width, height, pad}, {width, height, pad}};
+    PaddedPlane depth(width, height, pad);
+    std::vector<float> plane(size);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t i = 0; i < size; ++i) {
+            const Color& pixel = image.pixels()[i];
+            plane[i] = static_cast<float>(c == 0 ? pixel.r : c == 1 ? pixel.g : pixel.b);
+        }
+        color[c].fill(plane.data());
+        normal[c].fill(guides.normal[c].data());
+        albedo[c].fill(guides.albedo[c].data());
+    }
+    depth.fill(guides.depth.data());
+
+    // Depth differences are relative to the center pixel's depth, so that the tolerance does not
+    // depend on the scale of the scene; escaped pixels (depth 0) reject every surface
+    std::vector<float> inv_depth(size);
+    const float depth_sigma = static_cast<float>(settings.depth_sigma);
+    for (size_t i = 0; i < size; ++i) {
+        inv_depth[i] = 1.0f / (depth_sigma * std::max(guides.depth[i], 1e-6f));
+    }
+    const float inv_normal =
+        static_cast<float>(1.0 / (settings.normal_sigma * settings.normal_sigma));
+    const float inv_albedo =
+        static_cast<float>(1.0 / (settings.albedo_sigma * settings.albedo_sigma));
+
+    std::vector<float> out[3] = {std::vector<float>(size), std::vector<float>(size),
+                                 std::vector<float>(size)};
+    std::vector<float> sum[3] = {std::vector<float>(width), std::vector<float>(width),
+                                 std::vector<float>(width)};
+    std::vector<float> weight_sum(width);
+
+    // Each level runs along the rows, then along the columns: 2 x 5 taps instead of 5 x 5
+    const ptrdiff_t directions[2] = {1, color[0].stride};
+    for (int level = 0; level < levels; ++level) {
+        const int step = 1 << level;
+        const double color_sigma = settings.color_sigma / step;
+        const float inv_color = static_cast<float>(1.0 / (color_sigma * color_sigma));
+        const float depth_scale = 1.0f / static_cast<float>(step);
+
+        for (ptrdiff_t direction : directions) {
+            for (int y = 0; y < height; ++y) {
+                const float* cr = color[0].row(y);
+                const float* cg = color[1].row(y);
+                const float* cb = color[2].row(y);
+                const float* nx = normal[0].row(y);
+                const float* ny = normal[1].row(y);
+                const float* nz = normal[2].row(y);
+                const float* ar = albedo[0].row(y);
+                const float* ag = albedo[1].row(y);
+                const float* ab = albedo[2].row(y);
+                const float* z = depth.row(y);
+                const float* iz = inv_depth.data() + static_cast<size_t>(y) * width;
+                float* sr = sum[0].data();
+                float* sg = sum[1].data();
+                float* sb = sum[2].data();
+                float* sw = weight_sum.data();
+                std::fill(sw, sw + width, 0.0f);
+                for (int c = 0; c < 3; ++c) {
+                    std::fill(sum[c].begin(), sum[c].end(), 0.0f);
+                }
+
+                // One tap at a time over the whole row: every operand is a contiguous run of
+                // floats
+                for (int tap = -2; tap <= 2; ++tap) {
+                    const float kernel = kKernel[tap + 2];
+                    const ptrdiff_t offset = tap * step * direction;
+                    for (int x = 0; x < width; ++x) {
+                        const ptrdiff_t q = x + offset;
+                        const float dr = cr[q] - cr[x];
+                        const float dg = cg[q] - cg[x];
+                        const float db = cb[q] - cb[x];
+                        const float dnx = nx[q] - nx[x];
+                        const float dny = ny[q] - ny[x];
+                        const float dnz = nz[q] - nz[x];
+                        const float dar = ar[q] - ar[x];
+                        const float dag = ag[q] - ag[x];
+                        const float dab = ab[q] - ab[x];
+                        const float e = (dr * dr + dg * dg + db * db) * inv_color +
+                                        (dnx * dnx + dny * dny + dnz * dnz) * inv_normal +
+                                        std::fabs(z[q] - z[x]) * iz[x] * depth_scale +
+                                        (dar * dar + dag * dag + dab * dab) * inv_albedo;
+                        const float w = kernel * expNeg(e);
+                        sr[x] += w * cr[q];
+                        sg[x] += w * cg[q];
+                        sb[x] += w * cb[q];
+                        sw[x] += w;
+                    }
+                }
+
+                // The center tap always has a weight of 3/8, so the sum is never 0
+                const size_t base = static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    const float inv = 1.0f / sw[x];
+                    out[0][base + x] = sr[x] * inv;
+                    out[1][base + x] = sg[x] * inv;
+                    out[2][base + x] = sb[x] * inv;
+                }
+            }
+            for (int c = 0; c < 3; ++c) {
+                color[c].fill(out[c].data());
+            }
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const size_t i = static_cast<size_t>(y) * width + x;
+            image.at(x, y) = Color(out[0][i], out[1][i], out[2][i]);
+        }
+    }
+}
+
+} // namespace Prism
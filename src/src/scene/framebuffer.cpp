@@ -0,0 +1,87 @@
+#include "Prism/scene/framebuffer.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Prism {
+
+PRISM_EXPORT int convert_color(double f) {
+    return static_cast<int>(255.999 * f);
+}
+
+PRISM_EXPORT std::ostream& operator<<(std::ostream& os, const Color& color) {
+    os << static_cast<int>(convert_color(color.r)) << " "
+       << static_cast<int>(convert_color(color.g)) << " "
+       << static_cast<int>(convert_color(color.b));
+    return os;
+}
+
+Framebuffer::Framebuffer(int width, int height)
+    : width_(width), height_(height),
+      pixels_(static_cast<size_t>(width) * static_cast<size_t>(height), Color(0, 0, 0)) {
+}
+
+void Framebuffer::writePPM(const std::filesystem::path& path, bool binary) const {
+    std::ofstream image_file(path, std::ios::trunc | std::ios::binary);
+    if (!image_file.is_open()) {
+        throw std::runtime_error("Could not open the file for writing: " + path.string());
+    }
+
+    image_file << (binary ? "P6" : "P3") << "\n" << width_ << " " << height_ << "\n255\n";
+    if (binary) {
+        std::vector<unsigned char> bytes;
+        bytes.reserve(pixels_.size() * 3);
+        for (const Color& pixel : pixels_) {
+            bytes.push_back(static_cast<unsigned char>(convert_color(pixel.r)));
+            bytes.push_back(static_cast<unsigned char>(convert_color(pixel.g)));
+            bytes.push_back(static_cast<unsigned char>(convert_color(pixel.b)));
+        }
+        image_file.write(reinterpret_cast<const char*>(bytes.data()),
+                         static_cast<std::streamsize>(bytes.size()));
+    } else {
+        for (const Color& pixel : pixels_) {
+            image_file << pixel << '\n';
+        }
+    }
+    if (!image_file) {
+        throw std::runtime_error("Could not write image: " + path.string());
+    }
+}
+
+Framebuffer Framebuffer::readPPM(const std::filesystem::path& path) {
+    std::ifstream image_file(path, std::ios::binary);
+    if (!image_file.is_open()) {
+        throw std::runtime_error("Could not open the image: " + path.string());
+    }
+    std::string magic;
+    int width = 0, height = 0, max_value = 0;
+    image_file >> magic >> width >> height >> max_value;
+    if (!image_file || (magic != "P3" && magic != "P6") || width <= 0 || height <= 0 ||
+        max_value != 255) {
+        throw std::runtime_error("Not an 8-bit PPM image: " + path.string());
+    }
+    image_file.get(); // The single whitespace before the pixels
+
+    // The center of each 8-bit step converts back to the same value
+    auto component = [](int value) { return (value + 0.5) / 256.0; };
+    Framebuffer image(width, height);
+    for (Color& pixel : image.pixels_) {
+        int r, g, b;
+        if (magic == "P3") {
+            image_file >> r >> g >> b;
+        } else {
+            unsigned char rgb[3];
+            image_file.read(reinterpret_cast<char*>(rgb), 3);
+            r = rgb[0], g = rgb[1], b = rgb[2];
+        }
+        if (!image_file) {
+            throw std::runtime_error("Truncated PPM image: " + path.string());
+        }
+        pixel = Color(component(r), component(g), component(b));
+    }
+    return image;
+}
+
+} // namespace Prism
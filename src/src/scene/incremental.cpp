@@ -0,0 +1,82 @@
+#include "Prism/scene/incremental.hpp"
+
+#include <algorithm>
+
+namespace Prism {
+
+void RayDependencies::finish() {
+    std::sort(objects.begin(), objects.end());
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+    std::sort(materials.begin(), materials.end());
+    materials.erase(std::unique(materials.begin(), materials.end()), materials.end());
+}
+
+void RayDependencies::clear() {
+    objects.clear();
+    materials.clear();
+    segments.clear();
+}
+
+bool RayDependencies::dependsOn(uint32_t object) const {
+    return std::binary_search(objects.begin(), objects.end(), object);
+}
+
+bool RayDependencies::dependsOn(const Material* material) const {
+    return std::binary_search(materials.begin(), materials.end(), material);
+}
+
+bool RayDependencies::crosses(const AABB& bounds) const {
+    if (bounds.isEmpty()) {
+        return false;
+    }
+    for (const Segment& segment : segments) {
+        if (bounds.hit(segment.ray, 1e-4, segment.t_max)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t RayDependencies::byteSize() const {
+    return objects.capacity() * sizeof(uint32_t) +
+           materials.capacity() * sizeof(const Material*) +
+           segments.capacity() * sizeof(Segment);
+}
+
+IncrementalState::IncrementalState(int width, int height, int tile_size)
+    : image(width, height), tile_size(std::max(1, tile_size)),
+      tiles_x((width + this->tile_size - 1) / this->tile_size),
+      tiles_y((height + this->tile_size - 1) / this->tile_size),
+      tiles(static_cast<size_t>(tiles_x) * tiles_y), dirty(tiles.size(), 1) {
+}
+
+ImageRegion IncrementalState::tile(size_t index) const {
+    ImageRegion region;
+    region.x = static_cast<int>(index % tiles_x) * tile_size;
+    region.y = static_cast<int>(index / tiles_x) * tile_size;
+    region.width = std::min(tile_size, image.width() - region.x);
+    region.height = std::min(tile_size, image.height() - region.y);
+    return region;
+}
+
+void IncrementalState::invalidate(uint32_t object, const AABB& bounds) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (!dirty[i] && (tiles[i].dependsOn(object) || tiles[i].crosses(bounds))) {
+            dirty[i] = 1;
+        }
+    }
+}
+
+void IncrementalState::invalidate(const Material* material) {
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (!dirty[i] && tiles[i].dependsOn(material)) {
+            dirty[i] = 1;
+        }
+    }
+}
+
+size_t IncrementalState::dirtyCount() const {
+    return static_cast<size_t>(std::count(dirty.begin(), dirty.end(), 1));
+}
+
+} // namespace Prism
@@ -0,0 +1,124 @@
+#include "Prism/scene/light_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Prism {
+
+LightTree::LightTree(const std::vector<std::unique_ptr<Light>>& lights)
+    : light_count(lights.size()) {
+    if (lights.empty()) {
+        return;
+    }
+    std::vector<uint32_t> order(lights.size());
+    std::iota(order.begin(), order.end(), 0u);
+    nodes.reserve(2 * lights.size());
+    build(lights, order, 0, lights.size());
+}
+
+uint32_t LightTree::build(const std::vector<std::unique_ptr<Light>>& lights,
+                          std::vector<uint32_t>& order, size_t begin, size_t end) {
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    AABB bounds;
+    double power = 0.0;
+    double radius = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        const Light& light = *lights[order[i]];
+        bounds.expand(light.bounds());
+        power += light.power();
+        radius = std::max(radius, light.radius > 0.0 ? light.radius : INFINITY);
+    }
+
+    Node node{bounds, power, radius, 0, 0, 0, false};
+    if (end - begin == 1) {
+        node.leaf = true;
+        node.light = order[begin];
+        nodes[index] = node;
+        return index;
+    }
+
+    // Median split along the longest axis of the light positions
+    Vector3 extent = bounds.diagonal();
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    auto coordinate = [&](uint32_t light) {
+        const Point3& p = lights[light]->position;
+        return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+    };
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                     [&](uint32_t a, uint32_t b) { return coordinate(a) < coordinate(b); });
+
+    node.left = build(lights, order, begin, middle);
+    node.right = build(lights, order, middle, end);
+    nodes[index] = node;
+    return index;
+}
+
+double LightTree::importance(const Node& node, const Point3& p) const {
+    return node.power * Light::falloff(node.bounds.distanceTo(p), node.radius);
+}
+
+void LightTree::collect(const Point3& p, double threshold, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (nodes.empty()) {
+        return;
+    }
+
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        double bound = importance(node, p);
+        if (bound <= 0.0 || bound < threshold) {
+            continue;
+        }
+        if (node.leaf) {
+            out.push_back(node.light);
+        } else {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+
+    // Keep the order of the scene, so the shading sums match the exhaustive loop
+    std::sort(out.begin(), out.end());
+}
+
+bool LightTree::sample(const Point3& p, double u, uint32_t& light, double& pdf) const {
+    if (nodes.empty() || importance(nodes[0], p) <= 0.0) {
+        return false;
+    }
+
+    pdf = 1.0;
+    const Node* node = &nodes[0];
+    while (!node->leaf) {
+        const Node& left = nodes[node->left];
+        const Node& right = nodes[node->right];
+        double left_importance = importance(left, p);
+        double right_importance = importance(right, p);
+        double total = left_importance + right_importance;
+        if (total <= 0.0) {
+            return false;
+        }
+        double p_left = left_importance / total;
+        // Reuse the random number for the next level by rescaling it into [0, 1)
+        if (u < p_left) {
+            u = u / p_left;
+            pdf *= p_left;
+            node = &left;
+        } else {
+            u = (u - p_left) / (1.0 - p_left);
+            pdf *= 1.0 - p_left;
+            node = &right;
+        }
+        u = std::min(u, 0.99999999999999989);
+    }
+    light = node->light;
+    return true;
+}
+
+} // namespace Prism
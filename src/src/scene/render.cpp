@@ -0,0 +1,1535 @@
+#include "Prism/scene/scene.hpp"
+
+#include "Prism/core/matrix.hpp"
+#include "Prism/core/random.hpp"
+#include "Prism/core/style.hpp"
+#include "Prism/objects/mesh.hpp"
+#include "Prism/objects/out_of_core_mesh.hpp"
+#include "Prism/objects/plane.hpp"
+#include "Prism/objects/sphere.hpp"
+#include "Prism/objects/triangle.hpp"
+#include "Prism/scene/aov.hpp"
+#include "Prism/scene/checkpoint.hpp"
+#include "Prism/scene/denoiser.hpp"
+#include "Prism/scene/light_tree.hpp"
+#include "Prism/scene/visibility_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Prism {
+
+namespace {
+
+double luminance(const Color& color) {
+    return 0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b;
+}
+
+// Random decisions along the ray tree use their own streams, separate from the sample positions
+constexpr uint32_t kRouletteStream = 0x80000000u;
+
+// Running sums of the samples of one pixel
+struct PixelSamples {
+    Color sum = Color(0.0, 0.0, 0.0);
+    double luminance_sum = 0.0;
+    double luminance_sq_sum = 0.0;
+    int count = 0;
+
+    void add(const Color& sample) {
+        sum += sample;
+        double l = luminance(sample);
+        luminance_sum += l;
+        luminance_sq_sum += l * l;
+        count++;
+    }
+
+    Color mean() const {
+        return sum * (1.0 / count);
+    }
+
+    double meanLuminance() const {
+        return luminance_sum / count;
+    }
+
+    // Standard error of the mean luminance, or 0 with a single sample
+    double standardError() const {
+        if (count < 2) {
+            return 0.0;
+        }
+        double mean = luminance_sum / count;
+        double variance = std::max(0.0, (luminance_sq_sum - count * mean * mean) / (count - 1));
+        return std::sqrt(variance / count);
+    }
+};
+
+// Builds the light hierarchy of the many-light modes, or returns null when every light is used
+std::unique_ptr<LightTree> makeLightTree(const RenderSettings& settings,
+                                         const std::vector<std::unique_ptr<Light>>& lights) {
+    if (settings.lights.selection == LightSelection::All) {
+        return nullptr;
+    }
+    return std::make_unique<LightTree>(lights);
+}
+
+// Allocates the first-hit buffers of the denoiser and the AOVs, if either is enabled
+std::unique_ptr<GuideBuffers> makeGuides(const RenderSettings& settings, int width, int height) {
+    const AovSettings& aovs = settings.aovs;
+    if (!settings.denoise.enabled && !aovs.any()) {
+        return nullptr;
+    }
+    return std::make_unique<GuideBuffers>(width, height, aovs.object_id || aovs.material_id);
+}
+
+// Filters a rendered image with the features collected while tracing it
+void applyDenoiser(Framebuffer& image, GuideBuffers& guides, const DenoiseSettings& settings,
+                   bool report) {
+    auto start = std::chrono::steady_clock::now();
+    guides.resolve();
+    denoise(image, guides, settings);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (report) {
+        std::ostringstream message;
+        message << "Denoised in " << elapsed.count() << " ms ("
+                << elapsed.count() * 1e6 / (static_cast<double>(image.width()) * image.height())
+                << " ms per megapixel)";
+        Style::logInfo(message.str());
+    }
+}
+
+// Smallest rectangle containing every region
+ImageRegion boundingRegion(const std::vector<ImageRegion>& regions) {
+    int x0 = regions.front().x;
+    int y0 = regions.front().y;
+    int x1 = x0 + regions.front().width;
+    int y1 = y0 + regions.front().height;
+    for (const ImageRegion& region : regions) {
+        x0 = std::min(x0, region.x);
+        y0 = std::min(y0, region.y);
+        x1 = std::max(x1, region.x + region.width);
+        y1 = std::max(y1, region.y + region.height);
+    }
+    return ImageRegion{x0, y0, x1 - x0, y1 - y0};
+}
+
+// Maps the requested regions to pixels of the (possibly scaled) camera, clipped to its image
+std::vector<ImageRegion> resolveRegions(const RenderSettings& settings, const Camera& camera) {
+    if (settings.regions.empty()) {
+        return {ImageRegion{0, 0, camera.pixel_width, camera.pixel_height}};
+    }
+    const double scale = settings.resolution_scale;
+    std::vector<ImageRegion> regions;
+    for (const ImageRegion& region : settings.regions) {
+        int x0 = std::max(0, static_cast<int>(std::floor(region.x * scale)));
+        int y0 = std::max(0, static_cast<int>(std::floor(region.y * scale)));
+        int x1 = std::min(camera.pixel_width,
+                          static_cast<int>(std::ceil((region.x + region.width) * scale)));
+        int y1 = std::min(camera.pixel_height,
+                          static_cast<int>(std::ceil((region.y + region.height) * scale)));
+        if (x1 > x0 && y1 > y0) {
+            regions.push_back(ImageRegion{x0, y0, x1 - x0, y1 - y0});
+        }
+    }
+    if (regions.empty()) {
+        throw std::runtime_error("Scene: none of the render regions overlaps the image.");
+    }
+    return regions;
+}
+
+// Random stream of the pixels sampled by estimateRenderCost()
+constexpr uint64_t kEstimateStream = 0xE57;
+
+// Regions per side of the grid that render cost estimates are tallied in
+constexpr int kCostGrid = 8;
+
+// Cosine by which a box must lie behind a plane of a tile's frustum to be culled, so rounding
+// never drops an object that touches the frustum
+constexpr double kCullTolerance = 1e-9;
+
+// Splits regions into tiles of at most `tile_size` pixels a side, row by row within each region
+std::vector<ImageRegion> splitIntoTiles(const std::vector<ImageRegion>& regions, int tile_size) {
+    tile_size = std::max(1, tile_size);
+    std::vector<ImageRegion> tiles;
+    for (const ImageRegion& region : regions) {
+        for (int y = region.y; y < region.y + region.height; y += tile_size) {
+            for (int x = region.x; x < region.x + region.width; x += tile_size) {
+                tiles.push_back(ImageRegion{x, y, std::min(tile_size, region.x + region.width - x),
+                                            std::min(tile_size, region.y + region.height - y)});
+            }
+        }
+    }
+    return tiles;
+}
+
+// Orders tiles by distance to the center of the frame, nearest first
+void sortCenterOut(std::vector<ImageRegion>& tiles, const ImageRegion& frame) {
+    const double center_x = frame.x + 0.5 * frame.width;
+    const double center_y = frame.y + 0.5 * frame.height;
+    auto distance = [&](const ImageRegion& tile) {
+        double dx = tile.x + 0.5 * tile.width - center_x;
+        double dy = tile.y + 0.5 * tile.height - center_y;
+        return dx * dx + dy * dy;
+    };
+    std::stable_sort(tiles.begin(), tiles.end(), [&](const ImageRegion& a, const ImageRegion& b) {
+        return distance(a) < distance(b);
+    });
+}
+
+// Quality levels of a deadline render, cheapest first: one sample per pixel with one bounce and
+// one shadow ray per area light, then the full depth and shadow sampling, then the full sampling
+// settings. Levels identical to the previous one are left out.
+std::vector<RenderSettings> qualityLevels(const RenderSettings& settings) {
+    std::vector<RenderSettings> levels;
+    RenderSettings level = settings;
+    level.sampling.min_samples = level.sampling.max_samples = 1;
+    level.max_depth = 1;
+    level.shadows.min_samples = level.shadows.max_samples = 1;
+    levels.push_back(level);
+    level.max_depth = settings.max_depth;
+    level.shadows = settings.shadows;
+    if (level.max_depth != 1 || level.shadows.min_samples != 1 ||
+        level.shadows.max_samples != 1) {
+        levels.push_back(level);
+    }
+    if (settings.sampling.isAdaptive()) {
+        levels.push_back(settings);
+    }
+    return levels;
+}
+
+// Per-pixel values of a checkpointed tile: the color, then the raw guide sums and sample count
+constexpr size_t kColorValues = 3;
+constexpr size_t kGuideValues = 8;
+constexpr size_t kIdValues = 2;
+
+size_t checkpointValues(const GuideBuffers* guides) {
+    if (!guides) {
+        return kColorValues;
+    }
+    return kColorValues + kGuideValues + (guides->has_ids ? kIdValues : 0);
+}
+
+TileRecord saveTile(const ImageRegion& tile, size_t samples, const Framebuffer& image,
+                    const ImageRegion& frame, const GuideBuffers* guides) {
+    TileRecord record;
+    record.samples = samples;
+    record.values.reserve(tile.area() * checkpointValues(guides));
+    for (int y = tile.y - frame.y; y < tile.y - frame.y + tile.height; ++y) {
+        for (int x = tile.x - frame.x; x < tile.x - frame.x + tile.width; ++x) {
+            const Color& color = image.at(x, y);
+            record.values.insert(record.values.end(), {static_cast<float>(color.r),
+                                                       static_cast<float>(color.g),
+                                                       static_cast<float>(color.b)});
+            if (!guides) {
+                continue;
+            }
+            const size_t pixel = static_cast<size_t>(y) * frame.width + x;
+            record.values.insert(
+                record.values.end(),
+                {guides->depth[pixel], guides->normal[0][pixel], guides->normal[1][pixel],
+                 guides->normal[2][pixel], guides->albedo[0][pixel], guides->albedo[1][pixel],
+                 guides->albedo[2][pixel], static_cast<float>(guides->count[pixel])});
+            if (guides->has_ids) {
+                record.values.insert(record.values.end(),
+                                     {guides->object_id[pixel], guides->material_id[pixel]});
+            }
+        }
+    }
+    return record;
+}
+
+void restoreTile(const ImageRegion& tile, const TileRecord& record, Framebuffer& image,
+                 const ImageRegion& frame, GuideBuffers* guides) {
+    if (record.values.size() != tile.area() * checkpointValues(guides)) {
+        throw std::runtime_error("Scene: a checkpointed tile does not match the render.");
+    }
+    const float* value = record.values.data();
+    for (int y = tile.y - frame.y; y < tile.y - frame.y + tile.height; ++y) {
+        for (int x = tile.x - frame.x; x < tile.x - frame.x + tile.width; ++x) {
+            image.at(x, y) = Color(value[0], value[1], value[2]);
+            value += kColorValues;
+            if (!guides) {
+                continue;
+            }
+            const size_t pixel = static_cast<size_t>(y) * frame.width + x;
+            guides->depth[pixel] = value[0];
+            for (int i = 0; i < 3; ++i) {
+                guides->normal[i][pixel] = value[1 + i];
+                guides->albedo[i][pixel] = value[4 + i];
+            }
+            guides->count[pixel] = static_cast<uint32_t>(value[7]);
+            value += kGuideValues;
+            if (guides->has_ids) {
+                guides->object_id[pixel] = value[0];
+                guides->material_id[pixel] = value[1];
+                value += kIdValues;
+            }
+        }
+    }
+}
+
+// Identifies a checkpointed render: the camera, the settings that change traced pixels, the
+// tiles and their layout, and the lights, materials and bounding boxes of the objects
+uint64_t checkpointFingerprint(const Camera& camera, const ImageRegion& frame,
+                               const std::vector<ImageRegion>& tiles, size_t values_per_pixel,
+                               const RenderSettings& settings,
+                               const std::vector<std::unique_ptr<Object>>& objects,
+                               const std::vector<std::unique_ptr<Light>>& lights,
+                               const Color& ambient) {
+    uint64_t key = RenderCheckpoint::hash(nullptr, 0);
+    auto add = [&](const auto& value) { key = RenderCheckpoint::hash(&value, sizeof(value), key); };
+    auto addPoint = [&](const auto& p) {
+        add(p.x);
+        add(p.y);
+        add(p.z);
+    };
+    auto addColor = [&](const Color& c) {
+        add(c.r);
+        add(c.g);
+        add(c.b);
+    };
+    auto addArray = [&](const auto& values) {
+        key = RenderCheckpoint::hash(values.data(), values.size() * sizeof(values[0]), key);
+    };
+    auto addRegion = [&](const ImageRegion& region) {
+        add(region.x);
+        add(region.y);
+        add(region.width);
+        add(region.height);
+    };
+
+    addPoint(camera.pos);
+    addPoint(camera.aim);
+    addPoint(camera.up);
+    add(camera.screen_distance);
+    add(camera.screen_height);
+    add(camera.screen_width);
+    add(camera.pixel_width);
+    add(camera.pixel_height);
+    addRegion(frame);
+    for (const ImageRegion& tile : tiles) {
+        addRegion(tile);
+    }
+    add(values_per_pixel);
+
+    add(settings.max_depth);
+    add(settings.sampling.min_samples);
+    add(settings.sampling.max_samples);
+    add(settings.sampling.variance_threshold);
+    add(settings.sampling.contrast_threshold);
+    add(settings.seed);
+    add(settings.min_contribution);
+    add(settings.russian_roulette);
+    add(settings.roulette_threshold);
+    add(settings.lights.selection);
+    add(settings.lights.threshold);
+    add(settings.lights.samples);
+    add(settings.shadows.min_samples);
+    add(settings.shadows.max_samples);
+    add(settings.shadow_maps.enabled);
+    add(settings.shadow_maps.resolution);
+    add(settings.shadow_maps.bias);
+    add(settings.shadow_maps.filter);
+    add(settings.integrator);
+    add(settings.depth_scale);
+
+    addColor(ambient);
+    for (const auto& light : lights) {
+        addPoint(light->position);
+        addColor(light->color);
+        add(light->radius);
+        add(light->shape);
+        addPoint(light->edge_u);
+        addPoint(light->edge_v);
+        add(light->sphere_radius);
+    }
+    for (const auto& object : objects) {
+        AABB bounds = object->boundingBox();
+        addPoint(bounds.min);
+        addPoint(bounds.max);
+        const Matrix transform = object->getTransform();
+        for (size_t i = 0; i < transform.getRows(); ++i) {
+            for (size_t j = 0; j < transform.getCols(); ++j) {
+                add(transform[i][j]);
+            }
+        }
+        // The geometry itself; lazy mesh proxies are only covered by their bounds, so that
+        // fingerprinting never loads them
+        if (auto sphere = dynamic_cast<const Sphere*>(object.get())) {
+            addPoint(sphere->getCenter());
+            add(sphere->getRadius());
+        } else if (auto plane = dynamic_cast<const Plane*>(object.get())) {
+            addPoint(plane->getPoint());
+            addPoint(plane->getNormal());
+        } else if (auto triangle = dynamic_cast<const Triangle*>(object.get())) {
+            addPoint(triangle->getPoint1());
+            addPoint(triangle->getPoint2());
+            addPoint(triangle->getPoint3());
+        } else if (auto mesh = dynamic_cast<const Mesh*>(object.get())) {
+            add(mesh->getVertices().size());
+            add(mesh->getFaces().size());
+            addArray(mesh->getVertices());
+            addArray(mesh->getNormals());
+            addArray(mesh->getFaces());
+            add(mesh->levelCount());
+            add(mesh->getLodSettings().triangle_pixels);
+        } else if (auto clustered = dynamic_cast<const OutOfCoreMesh*>(object.get())) {
+            addArray(clustered->getBackingPath().native());
+            add(clustered->triangleCount());
+            add(clustered->clusterCount());
+        }
+        if (std::shared_ptr<Material> material = object->getMaterial()) {
+            addColor(material->color);
+            addColor(material->ka);
+            addColor(material->ks);
+            addColor(material->ke);
+            add(material->ns);
+            add(material->ni);
+            add(material->d);
+        }
+    }
+    return key;
+}
+
+} // namespace
+
+void logTraceStats(const TraceStats& stats) {
+    if (stats.shadow_rays > 0) {
+        Style::logInfo("Area lights: " + std::to_string(stats.shadow_rays) + " shadow rays traced");
+    }
+    if (stats.pruned == 0 && stats.terminated == 0) {
+        return;
+    }
+    std::ostringstream report;
+    report << "Ray tree: " << stats.rays << " rays traced, " << stats.pruned
+           << " pruned by contribution, " << stats.terminated << " stopped by Russian roulette";
+    Style::logInfo(report.str());
+}
+
+Framebuffer Scene::renderImage(const RenderSettings& settings, TraceStats* stats,
+                               const PreviewCallback& preview) const {
+    const Camera camera = camera_.scaled(settings.resolution_scale);
+    std::vector<ImageRegion> regions = resolveRegions(settings, camera);
+    ImageRegion frame{0, 0, camera.pixel_width, camera.pixel_height};
+    if (settings.crop) {
+        frame = boundingRegion(regions);
+    }
+    Framebuffer image(frame.width, frame.height);
+    renderRegions(camera, regions, image, frame, settings, stats, preview);
+    return image;
+}
+
+void Scene::renderInto(Framebuffer& image, const RenderSettings& settings, TraceStats* stats,
+                       const PreviewCallback& preview) const {
+    const Camera camera = camera_.scaled(settings.resolution_scale);
+    if (image.width() != camera.pixel_width || image.height() != camera.pixel_height) {
+        throw std::runtime_error("Scene::renderInto: the image is " +
+                                 std::to_string(image.width()) + "x" +
+                                 std::to_string(image.height()) + ", the camera renders " +
+                                 std::to_string(camera.pixel_width) + "x" +
+                                 std::to_string(camera.pixel_height) + ".");
+    }
+    std::vector<ImageRegion> regions = resolveRegions(settings, camera);
+    const ImageRegion frame{0, 0, camera.pixel_width, camera.pixel_height};
+    renderRegions(camera, regions, image, frame, settings, stats, preview);
+}
+
+void Scene::renderRegions(const Camera& camera, const std::vector<ImageRegion>& regions,
+                          Framebuffer& image, const ImageRegion& frame,
+                          const RenderSettings& settings, TraceStats* stats,
+                          const PreviewCallback& preview) const {
+    TraceContext context(settings);
+    std::unique_ptr<LightTree> light_tree = makeLightTree(settings, lights_);
+    context.light_tree = light_tree.get();
+    const ShadowMaps shadow_maps = prepareShadowMaps(settings);
+    context.shadow_maps = &shadow_maps;
+    context.stack.reserve(static_cast<size_t>(std::max(settings.max_depth, 0)));
+
+    if (settings.aovs.any() && settings.aovs.file.empty()) {
+        throw std::runtime_error("Scene: AOV channels are selected but no AOV file is set.");
+    }
+    std::unique_ptr<GuideBuffers> guides = makeGuides(settings, frame.width, frame.height);
+    if (guides) {
+        context.guides = guides.get();
+        numberMaterials(context);
+    }
+    auto raster_start = std::chrono::steady_clock::now();
+    std::unique_ptr<VisibilityBuffer> visibility = rasterizeView(camera, frame, settings);
+    if (visibility) {
+        context.visibility = visibility.get();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - raster_start;
+        std::ostringstream report;
+        report << "Visibility buffer: " << visibility->triangleCount() << " triangles in "
+               << elapsed.count() << " ms";
+        Style::logInfo(report.str());
+    }
+
+    size_t total_samples = 0;
+    size_t total_area = 0;
+    for (const ImageRegion& region : regions) {
+        total_area += region.area();
+    }
+    if (settings.deadline > 0.0) {
+        total_samples = renderDeadline(camera, regions, image, frame, context);
+    } else if (settings.progressive.enabled) {
+        if (!settings.checkpoint.file.empty()) {
+            Style::logWarning("progressive renders are not checkpointed.");
+        }
+        total_samples = renderProgressive(camera, regions, image, frame, context, preview);
+    } else if (!settings.checkpoint.file.empty()) {
+        total_samples = renderCheckpointed(camera, regions, image, frame, context);
+    } else {
+        for (const ImageRegion& region : regions) {
+            total_samples += renderRegion(camera, region, image, frame, context, true);
+        }
+    }
+    if (settings.aovs.any()) {
+        guides->resolve();
+        writeAovs(settings.aovs.file, *guides, settings.aovs);
+        Style::logInfo("AOVs written to " + Style::CYAN + settings.aovs.file.string());
+    }
+    if (settings.denoise.enabled) {
+        if (total_area == frame.area()) {
+            applyDenoiser(image, *guides, settings.denoise, true);
+        } else {
+            // The filter reads across region borders, but only the traced pixels may change
+            Framebuffer original = image;
+            applyDenoiser(image, *guides, settings.denoise, true);
+            Framebuffer filtered = std::move(image);
+            image = std::move(original);
+            for (const ImageRegion& region : regions) {
+                for (int y = region.y - frame.y; y < region.y - frame.y + region.height; ++y) {
+                    for (int x = region.x - frame.x; x < region.x - frame.x + region.width; ++x) {
+                        image.at(x, y) = filtered.at(x, y);
+                    }
+                }
+            }
+        }
+    }
+
+    if (settings.sampling.isAdaptive()) {
+        std::ostringstream report;
+        report << "Adaptive sampling: " << total_samples << " samples ("
+               << static_cast<double>(total_samples) / total_area << " per pixel, max "
+               << std::max(settings.sampling.min_samples, settings.sampling.max_samples) << ")";
+        Style::logInfo(report.str());
+    }
+    logTraceStats(context.stats);
+    if (stats) {
+        *stats = context.stats;
+    }
+}
+
+std::unique_ptr<VisibilityBuffer> Scene::rasterizeView(const Camera& camera,
+                                                        const ImageRegion& frame,
+                                                        const RenderSettings& settings) const {
+    if (!settings.rasterize) {
+        return nullptr;
+    }
+    auto buffer = std::make_unique<VisibilityBuffer>(camera, frame);
+    std::vector<uint32_t> visible;
+    cullObjects(camera, frame, visible);
+    for (uint32_t i : visible) {
+        buffer->add(i, *objects_[i]);
+    }
+    return buffer;
+}
+
+void Scene::cullObjects(const Camera& camera, const ImageRegion& block,
+                        std::vector<uint32_t>& candidates) const {
+    // Camera rays through the block fill a pyramid from the camera, bounded by the planes through
+    // the camera and two neighbouring corners of the block; normals point into the pyramid
+    const int x_end = block.x + block.width;
+    const int y_end = block.y + block.height;
+    const Vector3 corners[4] = {camera.rayAt(block.x, block.y).direction(),
+                                camera.rayAt(x_end, block.y).direction(),
+                                camera.rayAt(x_end, y_end).direction(),
+                                camera.rayAt(block.x, y_end).direction()};
+    const Vector3 axis = corners[0] + corners[1] + corners[2] + corners[3];
+    Vector3 normals[4];
+    for (int i = 0; i < 4; ++i) {
+        normals[i] = corners[i].cross(corners[(i + 1) % 4]).normalize();
+        if (normals[i].dot(axis) < 0.0) {
+            normals[i] = normals[i] * -1.0;
+        }
+    }
+
+    candidates.clear();
+    for (size_t i = 0; i < objects_.size(); ++i) {
+        const AABB bounds = objects_[i]->boundingBox();
+        bool outside = false;
+        if (bounds.isFinite()) {
+            // The box is outside if even its corner farthest along a normal is behind the plane
+            for (const Vector3& normal : normals) {
+                const Point3 corner(normal.x > 0.0 ? bounds.max.x : bounds.min.x,
+                                    normal.y > 0.0 ? bounds.max.y : bounds.min.y,
+                                    normal.z > 0.0 ? bounds.max.z : bounds.min.z);
+                const Vector3 to_corner = corner - camera.pos;
+                if (normal.dot(to_corner) < -kCullTolerance * to_corner.magnitude()) {
+                    outside = true;
+                    break;
+                }
+            }
+        }
+        if (!outside) {
+            candidates.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+size_t Scene::renderRegion(const Camera& camera, const ImageRegion& region, Framebuffer& image,
+                           const ImageRegion& frame, TraceContext& context,
+                           bool show_progress) const {
+    const RenderSettings& settings = context.settings;
+    auto progress = [&](int y) {
+        if (show_progress) {
+            Style::logStatusBar(static_cast<double>(y - region.y + 1) / region.height);
+        }
+    };
+    const int x_end = region.x + region.width;
+    const int y_end = region.y + region.height;
+    // Pixels are stored relative to the frame the image covers
+    auto guideIndex = [&](int x, int y) {
+        return static_cast<size_t>(y - frame.y) * frame.width + (x - frame.x);
+    };
+
+    // Camera rays only test the objects whose bounds meet the frustum of their block of
+    // `tile_size` pixels
+    const int block = std::max(settings.tile_size, 1);
+    const int blocks_x = (region.width + block - 1) / block;
+    const int blocks_y = (region.height + block - 1) / block;
+    std::vector<std::vector<uint32_t>> culled(static_cast<size_t>(blocks_x) * blocks_y);
+    for (int by = 0; by < blocks_y; ++by) {
+        for (int bx = 0; bx < blocks_x; ++bx) {
+            const ImageRegion bounds{region.x + bx * block, region.y + by * block,
+                                     std::min(block, region.width - bx * block),
+                                     std::min(block, region.height - by * block)};
+            cullObjects(camera, bounds, culled[static_cast<size_t>(by) * blocks_x + bx]);
+        }
+    }
+    auto enterPixel = [&](int x, int y) {
+        const int bx = (x - region.x) / block;
+        const int by = (y - region.y) / block;
+        context.camera_objects = &culled[static_cast<size_t>(by) * blocks_x + bx];
+        context.camera_primitives = nullptr;
+    };
+
+    // With a visibility buffer, the ray through a pixel center starts from the primitives the
+    // buffer shows in the 3x3 pixels around it, which include those whose edge it grazes
+    const VisibilityBuffer* visibility = context.visibility;
+    std::vector<std::pair<uint32_t, uint32_t>> primitives;
+    auto enterCenter = [&](int x, int y) {
+        enterPixel(x, y);
+        if (!visibility) {
+            return;
+        }
+        const ImageRegion& drawn = visibility->region();
+        const int drawn_x_end = drawn.x + drawn.width;
+        const int drawn_y_end = drawn.y + drawn.height;
+        if (x < drawn.x || y < drawn.y || x >= drawn_x_end || y >= drawn_y_end) {
+            return;
+        }
+        primitives.clear();
+        for (int ny = std::max(y - 1, drawn.y); ny <= std::min(y + 1, drawn_y_end - 1); ++ny) {
+            for (int nx = std::max(x - 1, drawn.x); nx <= std::min(x + 1, drawn_x_end - 1); ++nx) {
+                const VisibilitySample sample = visibility->at(nx, ny);
+                const std::pair<uint32_t, uint32_t> primitive(sample.object, sample.primitive);
+                if (sample.object != VisibilitySample::kNone &&
+                    std::find(primitives.begin(), primitives.end(), primitive) ==
+                        primitives.end()) {
+                    primitives.push_back(primitive);
+                }
+            }
+        }
+        context.camera_primitives = &primitives;
+        context.camera_depth = visibility->at(x, y).depth;
+    };
+
+    if (!settings.sampling.isAdaptive()) {
+        for (int y = region.y; y < y_end; ++y) {
+            for (int x = region.x; x < x_end; ++x) {
+                enterCenter(x, y);
+                image.at(x - frame.x, y - frame.y) = tracePixel(camera, x, y, frame, context);
+            }
+            progress(y);
+        }
+        context.camera_objects = nullptr;
+        context.camera_primitives = nullptr;
+        return region.area();
+    }
+
+    const SamplingSettings& sampling = settings.sampling;
+    const int batch = std::max(1, sampling.min_samples);
+    const int max_samples = std::max(batch, sampling.max_samples);
+    std::vector<PixelSamples> samples(region.area());
+    std::vector<std::pair<double, double>> offsets;
+    auto indexOf = [&](int x, int y) {
+        return static_cast<size_t>(y - region.y) * region.width + (x - region.x);
+    };
+
+    auto addBatch = [&](int x, int y, uint32_t round, int count) {
+        PixelSamples& pixel = samples[indexOf(x, y)];
+        context.rng = Rng::forPixel(settings.seed, x, y, kRouletteStream + round);
+        context.guide_pixel = guideIndex(x, y);
+        if (count == 1 && round == 0) {
+            enterCenter(x, y);
+            pixel.add(traceCamera(camera.rayAt(x + 0.5, y + 0.5), context));
+            return;
+        }
+        enterPixel(x, y);
+        Rng rng = Rng::forPixel(settings.seed, x, y, round);
+        stratifiedOffsets(count, rng, offsets);
+        for (const auto& offset : offsets) {
+            Ray ray = camera.rayAt(x + offset.first, y + offset.second);
+            pixel.add(traceCamera(ray, context));
+        }
+    };
+
+    // First batch for every pixel
+    for (int y = region.y; y < y_end; ++y) {
+        for (int x = region.x; x < x_end; ++x) {
+            addBatch(x, y, 0, batch);
+        }
+        progress(y);
+    }
+
+    // Further batches only where the estimate is still uncertain. Contrast with the neighbours
+    // only flags pixels after their first batch (it reveals edges a single sample missed);
+    // afterwards, the pixel's own variance decides whether it keeps sampling.
+    std::vector<uint8_t> refine(samples.size());
+    size_t total_samples = samples.size() * batch;
+    for (uint32_t round = 1;; ++round) {
+        bool any = false;
+        for (int y = region.y; y < y_end; ++y) {
+            for (int x = region.x; x < x_end; ++x) {
+                const size_t index = indexOf(x, y);
+                const PixelSamples& pixel = samples[index];
+                bool needs_more = false;
+                if (pixel.count < max_samples) {
+                    needs_more = pixel.standardError() > sampling.variance_threshold;
+                    if (!needs_more && pixel.count == batch) {
+                        const double l = pixel.meanLuminance();
+                        const int neighbours[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+                        for (const auto& d : neighbours) {
+                            int nx = x + d[0];
+                            int ny = y + d[1];
+                            if (nx < region.x || ny < region.y || nx >= x_end || ny >= y_end) {
+                                continue;
+                            }
+                            double nl = samples[indexOf(nx, ny)].meanLuminance();
+                            if (std::abs(l - nl) > sampling.contrast_threshold) {
+                                needs_more = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                refine[index] = needs_more;
+                any = any || needs_more;
+            }
+        }
+        if (!any) {
+            break;
+        }
+
+        for (int y = region.y; y < y_end; ++y) {
+            for (int x = region.x; x < x_end; ++x) {
+                const size_t index = indexOf(x, y);
+                if (refine[index]) {
+                    int count = std::min(batch, max_samples - samples[index].count);
+                    addBatch(x, y, round, count);
+                    total_samples += count;
+                }
+            }
+        }
+    }
+
+    for (int y = region.y; y < y_end; ++y) {
+        for (int x = region.x; x < x_end; ++x) {
+            image.at(x - frame.x, y - frame.y) = samples[indexOf(x, y)].mean();
+        }
+    }
+    context.camera_objects = nullptr;
+    context.camera_primitives = nullptr;
+    return total_samples;
+}
+
+size_t Scene::renderProgressive(const Camera& camera, const std::vector<ImageRegion>& regions,
+                                Framebuffer& image, const ImageRegion& frame,
+                                TraceContext& context, const PreviewCallback& preview) const {
+    const RenderSettings& settings = context.settings;
+
+    // Tiles of every region, nearest to the center of the image first
+    std::vector<ImageRegion> tiles = splitIntoTiles(regions, settings.tile_size);
+    size_t total_area = 0;
+    for (const ImageRegion& region : regions) {
+        total_area += region.area();
+    }
+    sortCenterOut(tiles, frame);
+    // Camera rays of each tile only test the objects in its frustum, as in renderRegion()
+    std::vector<std::vector<uint32_t>> culled(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        cullObjects(camera, tiles[i], culled[i]);
+    }
+
+    // Whether each pixel of the frame was traced yet
+    std::vector<uint8_t> traced(frame.area(), 0);
+    auto isTraced = [&](int x, int y) -> uint8_t& {
+        return traced[static_cast<size_t>(y - frame.y) * frame.width + (x - frame.x)];
+    };
+    size_t traced_count = 0;
+
+    // Fills the missing pixels of each tile from the traced pixel at the corner of their 2x2
+    // block, or else of their 4x4 block (blocks are aligned on the tile)
+    auto showPreview = [&] {
+        Framebuffer reconstructed = image;
+        for (const ImageRegion& tile : tiles) {
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                for (int x = tile.x; x < tile.x + tile.width; ++x) {
+                    if (isTraced(x, y)) {
+                        continue;
+                    }
+                    for (int stride : {2, 4}) {
+                        int bx = tile.x + (x - tile.x) / stride * stride;
+                        int by = tile.y + (y - tile.y) / stride * stride;
+                        if (isTraced(bx, by)) {
+                            reconstructed.at(x - frame.x, y - frame.y) =
+                                image.at(bx - frame.x, by - frame.y);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        preview(reconstructed);
+    };
+    auto last_preview = std::chrono::steady_clock::now();
+    auto tileDone = [&](bool pass_done) {
+        Style::logStatusBar(static_cast<double>(traced_count) / total_area);
+        if (!preview) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed = now - last_preview;
+        if (pass_done || elapsed.count() >= settings.progressive.interval) {
+            showPreview();
+            last_preview = std::chrono::steady_clock::now();
+        }
+    };
+
+    // Coarse passes: one pixel center per 4x4, then per 2x2 block of each tile
+    size_t total_samples = 0;
+    for (int stride : {4, 2}) {
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            const ImageRegion& tile = tiles[i];
+            context.camera_objects = &culled[i];
+            for (int y = tile.y; y < tile.y + tile.height; y += stride) {
+                for (int x = tile.x; x < tile.x + tile.width; x += stride) {
+                    if (!isTraced(x, y)) {
+                        image.at(x - frame.x, y - frame.y) =
+                            tracePixel(camera, x, y, frame, context);
+                        isTraced(x, y) = 1;
+                        traced_count++;
+                        total_samples++;
+                    }
+                }
+            }
+            context.camera_objects = nullptr;
+            tileDone(i + 1 == tiles.size());
+        }
+    }
+
+    // Final pass: the remaining pixels, or whole tiles with adaptive sampling (which needs every
+    // sample of a pixel and its neighbours)
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        const ImageRegion& tile = tiles[i];
+        if (settings.sampling.isAdaptive()) {
+            total_samples += renderRegion(camera, tile, image, frame, context, false);
+        }
+        context.camera_objects = &culled[i];
+        for (int y = tile.y; y < tile.y + tile.height; ++y) {
+            for (int x = tile.x; x < tile.x + tile.width; ++x) {
+                if (!isTraced(x, y)) {
+                    if (!settings.sampling.isAdaptive()) {
+                        image.at(x - frame.x, y - frame.y) =
+                            tracePixel(camera, x, y, frame, context);
+                        total_samples++;
+                    }
+                    isTraced(x, y) = 1;
+                    traced_count++;
+                }
+            }
+        }
+        context.camera_objects = nullptr;
+        tileDone(false);
+    }
+    return total_samples;
+}
+
+size_t Scene::renderDeadline(const Camera& camera, const std::vector<ImageRegion>& regions,
+                             Framebuffer& image, const ImageRegion& frame,
+                             TraceContext& context) const {
+    const RenderSettings& settings = context.settings;
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<ImageRegion> tiles = splitIntoTiles(regions, settings.tile_size);
+    sortCenterOut(tiles, frame);
+    const std::vector<RenderSettings> levels = qualityLevels(settings);
+    std::vector<std::unique_ptr<TraceContext>> contexts;
+    for (const RenderSettings& level : levels) {
+        contexts.push_back(std::make_unique<TraceContext>(level));
+        contexts.back()->light_tree = context.light_tree;
+        contexts.back()->shadow_maps = context.shadow_maps;
+        contexts.back()->visibility = context.visibility;
+        contexts.back()->stack.reserve(static_cast<size_t>(std::max(level.max_depth, 0)));
+        contexts.back()->guides = context.guides;
+        contexts.back()->material_ids = context.material_ids;
+    }
+
+    // Traces one pixel per 4x4 block of a tile, and fills each block with it. Returns the
+    // predicted time of the whole tile at that level. Camera rays only test the objects in the
+    // frustum of the tile, as in renderRegion().
+    constexpr int kStride = 4;
+    size_t total_samples = 0;
+    std::vector<uint32_t> culled;
+    auto traceLattice = [&](const ImageRegion& tile, TraceContext& level_context) {
+        auto tile_start = std::chrono::steady_clock::now();
+        cullObjects(camera, tile, culled);
+        level_context.camera_objects = &culled;
+        size_t count = 0;
+        for (int y = tile.y; y < tile.y + tile.height; y += kStride) {
+            for (int x = tile.x; x < tile.x + tile.width; x += kStride) {
+                Color color = tracePixel(camera, x, y, frame, level_context);
+                for (int by = y; by < std::min(y + kStride, tile.y + tile.height); ++by) {
+                    for (int bx = x; bx < std::min(x + kStride, tile.x + tile.width); ++bx) {
+                        image.at(bx - frame.x, by - frame.y) = color;
+                    }
+                }
+                count++;
+            }
+        }
+        level_context.camera_objects = nullptr;
+        total_samples += count;
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - tile_start;
+        return seconds.count() * tile.area() / count;
+    };
+
+    // Predicted time of every tile at every level
+    std::vector<std::vector<double>> predicted(levels.size(), std::vector<double>(tiles.size()));
+
+    // First pass: the cheapest level on the lattice, whatever the deadline, so no pixel stays
+    // black. Its first hits also go to the guide buffers, for the tiles left coarse.
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        predicted[0][i] = traceLattice(tiles[i], *contexts[0]);
+    }
+
+    // Probe of the full depth and shadows on the lattice while it fits in the budget, each tile
+    // predicted from its first pass and the slowdown of the tiles probed so far (at first, a
+    // guess of 2). Tiles left out are predicted from the average slowdown.
+    if (levels.size() > 1) {
+        TraceContext& probe = *contexts[1];
+        probe.guides = nullptr;
+        double probed = 0.0;
+        double first_pass = 0.0;
+        size_t i = 0;
+        auto slowdown = [&] { return first_pass > 0.0 ? probed / first_pass : 2.0; };
+        for (; i < tiles.size(); ++i) {
+            if (elapsed() + predicted[0][i] / (kStride * kStride) * slowdown() >
+                settings.deadline) {
+                break;
+            }
+            predicted[1][i] = traceLattice(tiles[i], probe);
+            probed += predicted[1][i];
+            first_pass += predicted[0][i];
+        }
+        for (; i < tiles.size(); ++i) {
+            predicted[1][i] = predicted[0][i] * slowdown();
+        }
+        probe.guides = context.guides;
+    }
+
+    // Adaptive sampling is guessed to cost its minimum samples per pixel
+    if (levels.size() > 2) {
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            predicted[2][i] = predicted[1][i] * std::max(1, settings.sampling.min_samples);
+        }
+    }
+
+    // Final pass: each tile, from the center outwards, is traced at the best level at which the
+    // remaining tiles all fit in the budget, or else at the cheapest level if the tile itself fits.
+    // Predictions of each level are corrected by the ratio of the measured to the predicted time
+    // of its tiles so far, so the level drops when tiles run slower than predicted.
+    std::vector<std::vector<double>> remaining(levels.size(),
+                                               std::vector<double>(tiles.size() + 1, 0.0));
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (size_t i = tiles.size(); i-- > 0;) {
+            remaining[level][i] = remaining[level][i + 1] + predicted[level][i];
+        }
+    }
+    std::vector<double> measured(levels.size(), 0.0);
+    std::vector<double> expected(levels.size(), 0.0);
+    std::vector<size_t> tiles_at(levels.size(), 0);
+    auto correction = [&](size_t level) {
+        return expected[level] > 0.0 ? measured[level] / expected[level] : 1.0;
+    };
+    size_t traced = 0;
+    for (; traced < tiles.size(); ++traced) {
+        const double budget = settings.deadline - elapsed();
+        size_t level = levels.size();
+        while (level-- > 0) {
+            if (remaining[level][traced] * correction(level) <= budget) {
+                break;
+            }
+        }
+        if (level >= levels.size()) {
+            level = 0;
+            if (predicted[0][traced] * correction(0) > budget) {
+                break;
+            }
+        }
+        auto tile_start = std::chrono::steady_clock::now();
+        if (context.guides) {
+            // The guides of the tile hold its first pass, which the final level replaces
+            const ImageRegion& tile = tiles[traced];
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                for (int x = tile.x; x < tile.x + tile.width; ++x) {
+                    context.guides->clearPixel(static_cast<size_t>(y - frame.y) * frame.width +
+                                               (x - frame.x));
+                }
+            }
+        }
+        total_samples += renderRegion(camera, tiles[traced], image, frame, *contexts[level], false);
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - tile_start;
+        measured[level] += seconds.count();
+        expected[level] += predicted[level][traced];
+        tiles_at[level]++;
+        Style::logStatusBar(static_cast<double>(traced + 1) / tiles.size());
+    }
+    for (const auto& level_context : contexts) {
+        context.stats += level_context->stats;
+    }
+
+    std::ostringstream report;
+    report << "Deadline: " << elapsed() << "s of " << settings.deadline << "s, tiles per quality "
+           << "level (cheapest first):";
+    for (size_t tiles_traced : tiles_at) {
+        report << " " << tiles_traced;
+    }
+    if (traced < tiles.size()) {
+        report << ", " << tiles.size() - traced << " left coarse";
+    }
+    Style::logInfo(report.str());
+    return total_samples;
+}
+
+size_t Scene::renderCheckpointed(const Camera& camera, const std::vector<ImageRegion>& regions,
+                                 Framebuffer& image, const ImageRegion& frame,
+                                 TraceContext& context) const {
+    const RenderSettings& settings = context.settings;
+    GuideBuffers* guides = context.guides;
+    std::vector<ImageRegion> tiles = splitIntoTiles(regions, settings.tile_size);
+    RenderCheckpoint checkpoint(settings.checkpoint.file,
+                                checkpointFingerprint(camera, frame, tiles,
+                                                      checkpointValues(guides), settings,
+                                                      objects_, lights_, ambient_color_),
+                                tiles.size());
+
+    size_t total_samples = 0;
+    size_t restored = checkpoint.resume([&](size_t tile, const TileRecord& record) {
+        restoreTile(tiles[tile], record, image, frame, guides);
+        total_samples += record.samples;
+    });
+    if (restored > 0) {
+        Style::logInfo("Checkpoint: resuming with " + std::to_string(restored) + " of " +
+                       std::to_string(tiles.size()) + " tiles finished");
+    }
+
+    // Time spent saving tiles, to report the cost of the checkpoint
+    std::chrono::duration<double, std::milli> saving{0};
+    auto last_flush = std::chrono::steady_clock::now();
+    size_t writes = 0;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        if (checkpoint.isFinished(i)) {
+            continue;
+        }
+        size_t samples = renderRegion(camera, tiles[i], image, frame, context, false);
+        total_samples += samples;
+
+        auto start = std::chrono::steady_clock::now();
+        checkpoint.add(i, saveTile(tiles[i], samples, image, frame, guides));
+        std::chrono::duration<double> since_flush = start - last_flush;
+        if (since_flush.count() >= settings.checkpoint.interval) {
+            checkpoint.flush();
+            writes++;
+            last_flush = std::chrono::steady_clock::now();
+        }
+        saving += std::chrono::steady_clock::now() - start;
+        Style::logStatusBar(static_cast<double>(checkpoint.finishedCount()) / tiles.size());
+    }
+    auto start = std::chrono::steady_clock::now();
+    checkpoint.flush();
+    saving += std::chrono::steady_clock::now() - start;
+
+    std::ostringstream report;
+    report << "Checkpoint: " << tiles.size() - restored << " tiles saved in " << writes + 1
+           << " writes (" << saving.count() << " ms) to " << settings.checkpoint.file.string();
+    Style::logInfo(report.str());
+    return total_samples;
+}
+
+Color Scene::tracePixel(const Camera& camera, int x, int y, const ImageRegion& frame,
+                        TraceContext& context) const {
+    const RenderSettings& settings = context.settings;
+    context.rng = Rng::forPixel(settings.seed, x, y, kRouletteStream);
+    context.guide_pixel = static_cast<size_t>(y - frame.y) * frame.width + (x - frame.x);
+    return traceCamera(camera.rayAt(x + 0.5, y + 0.5), context);
+}
+
+Color Scene::traceCamera(const Ray& ray, TraceContext& context) const {
+    const RenderSettings& settings = context.settings;
+    if (settings.integrator != Integrator::Whitted) {
+        return shadeFirstHit(ray, context);
+    }
+    return settings.recursive_trace ? trace(ray, settings.max_depth, 1.0, context)
+                                    : traceIterative(ray, settings.max_depth, 1.0, context);
+}
+
+std::vector<Framebuffer> Scene::renderViews(const std::vector<Camera>& cameras,
+                                            const RenderSettings& settings, TraceStats* stats,
+                                            const std::vector<std::string>& names) {
+    if (cameras.empty()) {
+        throw std::runtime_error("Scene::renderViews: no cameras to render.");
+    }
+    if (!names.empty() && names.size() != cameras.size()) {
+        throw std::runtime_error("Scene::renderViews: there must be one name per camera.");
+    }
+    if (settings.aovs.any() && settings.aovs.file.empty()) {
+        throw std::runtime_error("Scene: AOV channels are selected but no AOV file is set.");
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    // Objects with levels of detail use the level needed by the nearest view
+    for (const auto& object : objects_) {
+        AABB bounds = object->boundingBox();
+        if (!bounds.isFinite()) {
+            continue;
+        }
+        Point3 center = bounds.center();
+        const Camera* nearest = &cameras.front();
+        for (const Camera& camera : cameras) {
+            if ((camera.pos - center).magnitude() < (nearest->pos - center).magnitude()) {
+                nearest = &camera;
+            }
+        }
+        updateViewpoint(*object, *nearest);
+    }
+
+    std::vector<Camera> views;
+    std::vector<Framebuffer> images;
+    std::vector<std::unique_ptr<GuideBuffers>> guides;
+    std::vector<std::vector<ImageRegion>> tiles;
+    for (const Camera& camera : cameras) {
+        views.push_back(camera.scaled(settings.resolution_scale));
+        const Camera& view = views.back();
+        images.emplace_back(view.pixel_width, view.pixel_height);
+        guides.push_back(makeGuides(settings, view.pixel_width, view.pixel_height));
+        tiles.push_back(splitIntoTiles({ImageRegion{0, 0, view.pixel_width, view.pixel_height}},
+                                       settings.tile_size));
+    }
+
+    // Tile i of every view, then tile i + 1 of every view, ...
+    std::vector<std::pair<size_t, size_t>> work;
+    for (size_t i = 0;; ++i) {
+        size_t added = 0;
+        for (size_t view = 0; view < views.size(); ++view) {
+            if (i < tiles[view].size()) {
+                work.emplace_back(view, i);
+                added++;
+            }
+        }
+        if (added == 0) {
+            break;
+        }
+    }
+
+    std::unique_ptr<LightTree> light_tree = makeLightTree(settings, lights_);
+    const ShadowMaps shadow_maps = prepareShadowMaps(settings);
+    std::vector<std::unique_ptr<VisibilityBuffer>> visibility;
+    for (const Camera& camera : views) {
+        visibility.push_back(rasterizeView(
+            camera, ImageRegion{0, 0, camera.pixel_width, camera.pixel_height}, settings));
+    }
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    auto worker = [&](bool show_progress) {
+        TraceContext context(settings);
+        context.light_tree = light_tree.get();
+        context.shadow_maps = &shadow_maps;
+        context.stack.reserve(static_cast<size_t>(std::max(settings.max_depth, 0)));
+        if (guides.front()) {
+            numberMaterials(context);
+        }
+        for (size_t item = next++; item < work.size(); item = next++) {
+            const size_t view = work[item].first;
+            const Camera& camera = views[view];
+            const ImageRegion frame{0, 0, camera.pixel_width, camera.pixel_height};
+            context.guides = guides[view].get();
+            context.visibility = visibility[view].get();
+            renderRegion(camera, tiles[view][work[item].second], images[view], frame, context,
+                         false);
+            size_t finished = ++done;
+            if (show_progress) {
+                Style::logStatusBar(static_cast<double>(finished) / work.size());
+            }
+        }
+        return context.stats;
+    };
+
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const size_t thread_count = std::min(
+        work.size(), static_cast<size_t>(settings.threads > 0 ? settings.threads : cores));
+    std::vector<std::future<TraceStats>> helpers;
+    for (size_t i = 1; i < thread_count; ++i) {
+        helpers.push_back(std::async(std::launch::async, worker, false));
+    }
+    TraceStats total = worker(true);
+    for (auto& helper : helpers) {
+        total += helper.get(); // Rethrows a failed tile
+    }
+
+    for (size_t view = 0; view < views.size(); ++view) {
+        if (settings.aovs.any()) {
+            // Each view gets its own file, suffixed like the images of render()
+            const std::filesystem::path& file = settings.aovs.file;
+            std::filesystem::path path = file.parent_path() /
+                                         (file.stem().string() + "_" +
+                                          (names.empty() ? std::to_string(view) : names[view]) +
+                                          file.extension().string());
+            guides[view]->resolve();
+            writeAovs(path, *guides[view], settings.aovs);
+            Style::logInfo("AOVs written to " + Style::CYAN + path.string());
+        }
+        if (settings.denoise.enabled) {
+            applyDenoiser(images[view], *guides[view], settings.denoise, false);
+        }
+    }
+    for (const auto& object : objects_) {
+        updateViewpoint(*object, camera_);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::ostringstream report;
+    report << "Views: " << views.size() << " rendered in " << elapsed.count() << "s ("
+           << work.size() << " tiles on " << thread_count << " threads)";
+    Style::logInfo(report.str());
+    logTraceStats(total);
+    if (stats) {
+        *stats = total;
+    }
+    return images;
+}
+
+RenderCostEstimate Scene::estimateRenderCost(const RenderSettings& settings, double fraction,
+                                             double time_limit) const {
+    if (!(fraction > 0.0 && fraction <= 1.0)) {
+        throw std::runtime_error("Scene::estimateRenderCost: the fraction must be in (0, 1].");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+    const Camera camera = camera_.scaled(settings.resolution_scale);
+    const int width = camera.pixel_width;
+    const int height = camera.pixel_height;
+
+    // Square cells of about 1 / fraction pixels, visited in random order
+    const int cell = std::max(1, static_cast<int>(std::lround(1.0 / std::sqrt(fraction))));
+    const int cells_x = (width + cell - 1) / cell;
+    const int cells_y = (height + cell - 1) / cell;
+    std::vector<uint32_t> order(static_cast<size_t>(cells_x) * cells_y);
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    Rng rng(settings.seed, kEstimateStream);
+    for (size_t i = order.size(); i > 1; --i) {
+        std::swap(order[i - 1], order[static_cast<size_t>(rng.nextDouble() * i)]);
+    }
+
+    // A grid of up to 8x8 regions that the sample is tallied in
+    const int region_width = (width + kCostGrid - 1) / kCostGrid;
+    const int region_height = (height + kCostGrid - 1) / kCostGrid;
+    const int regions_x = (width + region_width - 1) / region_width;
+    const int regions_y = (height + region_height - 1) / region_height;
+    RenderCostEstimate estimate;
+    estimate.width = width;
+    estimate.height = height;
+    std::vector<uint64_t> region_rays(static_cast<size_t>(regions_x) * regions_y, 0);
+    for (int ry = 0; ry < regions_y; ++ry) {
+        for (int rx = 0; rx < regions_x; ++rx) {
+            RegionCost cost;
+            cost.region = ImageRegion{rx * region_width, ry * region_height,
+                                      std::min(region_width, width - rx * region_width),
+                                      std::min(region_height, height - ry * region_height)};
+            estimate.regions.push_back(cost);
+        }
+    }
+
+    TraceContext context(settings);
+    std::unique_ptr<LightTree> light_tree = makeLightTree(settings, lights_);
+    context.light_tree = light_tree.get();
+    const ShadowMaps shadow_maps = prepareShadowMaps(settings);
+    context.shadow_maps = &shadow_maps;
+    context.stack.reserve(static_cast<size_t>(std::max(settings.max_depth, 0)));
+    auto raster_start = std::chrono::steady_clock::now();
+    std::unique_ptr<VisibilityBuffer> visibility =
+        rasterizeView(camera, ImageRegion{0, 0, width, height}, settings);
+    context.visibility = visibility.get();
+    std::chrono::duration<double> raster_seconds = std::chrono::steady_clock::now() - raster_start;
+    Framebuffer pixel(1, 1);
+    uint64_t camera_samples = 0;
+    double traced_seconds = 0.0;
+    for (uint32_t index : order) {
+        if (estimate.sampled_pixels > 0 && elapsed() > time_limit) {
+            break;
+        }
+        const int cx = static_cast<int>(index % cells_x) * cell;
+        const int cy = static_cast<int>(index / cells_x) * cell;
+        const int x = cx + static_cast<int>(rng.nextDouble() * std::min(cell, width - cx));
+        const int y = cy + static_cast<int>(rng.nextDouble() * std::min(cell, height - cy));
+
+        const ImageRegion single{x, y, 1, 1};
+        const uint64_t rays_before = context.stats.rays + context.stats.shadow_rays;
+        auto pixel_start = std::chrono::steady_clock::now();
+        camera_samples += renderRegion(camera, single, pixel, single, context, false);
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - pixel_start;
+
+        const size_t region = static_cast<size_t>(y / region_height) * regions_x +
+                              static_cast<size_t>(x / region_width);
+        estimate.regions[region].sampled_pixels++;
+        estimate.regions[region].seconds += seconds.count();
+        region_rays[region] += context.stats.rays + context.stats.shadow_rays - rays_before;
+        traced_seconds += seconds.count();
+        estimate.sampled_pixels++;
+    }
+
+    // Each region scales its own average per pixel, or the image's if it has no sample
+    const double pixels = static_cast<double>(width) * height;
+    const double scale = pixels / estimate.sampled_pixels;
+    const double average = traced_seconds / estimate.sampled_pixels;
+    double slowest_pixel = 0.0;
+    for (size_t i = 0; i < estimate.regions.size(); ++i) {
+        RegionCost& cost = estimate.regions[i];
+        double per_pixel = average;
+        if (cost.sampled_pixels > 0) {
+            per_pixel = cost.seconds / cost.sampled_pixels;
+            cost.rays_per_pixel = static_cast<double>(region_rays[i]) / cost.sampled_pixels;
+        }
+        cost.seconds = per_pixel * cost.region.area();
+        estimate.seconds += cost.seconds;
+        slowest_pixel = std::max(slowest_pixel, per_pixel);
+    }
+    if (visibility) {
+        estimate.raster_seconds = raster_seconds.count();
+    }
+    std::stable_sort(estimate.regions.begin(), estimate.regions.end(),
+                     [](const RegionCost& a, const RegionCost& b) { return a.seconds > b.seconds; });
+
+    const int tile_size = std::max(1, settings.tile_size);
+    estimate.slowest_tile = slowest_pixel * std::min(tile_size, width) * std::min(tile_size, height);
+    auto extrapolate = [&](uint64_t count) {
+        return static_cast<uint64_t>(std::llround(static_cast<double>(count) * scale));
+    };
+    estimate.rays.rays = extrapolate(context.stats.rays);
+    estimate.rays.pruned = extrapolate(context.stats.pruned);
+    estimate.rays.terminated = extrapolate(context.stats.terminated);
+    estimate.rays.shadow_rays = extrapolate(context.stats.shadow_rays);
+    estimate.camera_samples = extrapolate(camera_samples);
+    estimate.sample_seconds = elapsed();
+    return estimate;
+}
+
+const Framebuffer& Scene::renderIncremental(TraceStats* stats) {
+    const RenderSettings& settings = settings_;
+    if (!incremental_) {
+        incremental_ = std::make_unique<IncrementalState>(camera_.pixel_width,
+                                                          camera_.pixel_height, settings.tile_size);
+    }
+    IncrementalState& state = *incremental_;
+
+    TraceContext context(settings);
+    std::unique_ptr<LightTree> light_tree = makeLightTree(settings, lights_);
+    context.light_tree = light_tree.get();
+    context.stack.reserve(static_cast<size_t>(std::max(settings.max_depth, 0)));
+
+    const ImageRegion full{0, 0, camera_.pixel_width, camera_.pixel_height};
+    const size_t dirty = state.dirtyCount();
+    std::unique_ptr<VisibilityBuffer> visibility;
+    if (dirty > 0) {
+        visibility = rasterizeView(camera_, full, settings);
+        context.visibility = visibility.get();
+    }
+    size_t done = 0;
+    for (size_t i = 0; i < state.tiles.size(); ++i) {
+        if (!state.dirty[i]) {
+            continue;
+        }
+        RayDependencies& dependencies = state.tiles[i];
+        dependencies.clear();
+        context.dependencies = &dependencies;
+        renderRegion(camera_, state.tile(i), state.image, full, context, false);
+        dependencies.finish();
+        state.dirty[i] = 0;
+        Style::logStatusBar(static_cast<double>(++done) / dirty);
+    }
+    context.dependencies = nullptr;
+
+    Style::logInfo("Incremental render: " + std::to_string(dirty) + " of " +
+                   std::to_string(state.tiles.size()) + " tiles traced");
+    logTraceStats(context.stats);
+    if (stats) {
+        *stats = context.stats;
+    }
+    return state.image;
+}
+
+void Scene::renderSequence(const Animation& animation, const std::filesystem::path& output_dir,
+                           TraceStats* stats) {
+    const int frames = animation.frameCount();
+    if (frames <= 0) {
+        throw std::runtime_error("Scene::renderSequence: the animation has no frames.");
+    }
+    std::filesystem::create_directories(output_dir);
+    Style::logInfo("Rendering " + std::to_string(frames) + " frames to " + Style::CYAN +
+                   std::filesystem::weakly_canonical(output_dir).string());
+
+    // Set up once for the whole sequence: lights are not animated, so neither is the light tree
+    const Camera base_camera = camera_;
+    const RenderSettings settings = settings_;
+    if (settings.progressive.enabled) {
+        Style::logWarning("sequences are not rendered progressively.");
+    }
+    if (!settings.checkpoint.file.empty()) {
+        Style::logWarning("sequences are not checkpointed.");
+    }
+    if (settings.deadline > 0.0) {
+        Style::logWarning("sequences ignore the render deadline.");
+    }
+    TraceContext context(settings);
+    std::unique_ptr<LightTree> light_tree = makeLightTree(settings, lights_);
+    context.light_tree = light_tree.get();
+    context.stack.reserve(static_cast<size_t>(std::max(settings.max_depth, 0)));
+    const Camera preview = camera_.scaled(settings.resolution_scale);
+    const ImageRegion full{0, 0, preview.pixel_width, preview.pixel_height};
+    std::unique_ptr<GuideBuffers> guides = makeGuides(settings, full.width, full.height);
+    if (guides) {
+        context.guides = guides.get();
+        numberMaterials(context);
+    }
+
+    // Frame f is traced into buffers[f % 2] while frame f - 1 is written from the other one
+    Framebuffer buffers[2] = {Framebuffer(full.width, full.height),
+                              Framebuffer(full.width, full.height)};
+    std::future<void> writing;
+    ShadowMaps shadow_maps;
+
+    // Back to the scene as it was loaded, also when a frame fails
+    auto restore = [&] {
+        setCamera(base_camera);
+        for (const Animation::Track& track : animation.tracks()) {
+            updateObject(track.object, [&](Object& object) { object.setTransform(track.base); });
+        }
+    };
+    auto start = std::chrono::steady_clock::now();
+    try {
+        for (int frame = 0; frame < frames; ++frame) {
+            animation.apply(*this, frame, base_camera);
+            // Maps are rebuilt only on frames that move geometry
+            shadow_maps = prepareShadowMaps(settings);
+            context.shadow_maps = &shadow_maps;
+            Framebuffer& image = buffers[frame % 2];
+            const Camera camera = camera_.scaled(settings.resolution_scale);
+            std::unique_ptr<VisibilityBuffer> visibility = rasterizeView(camera, full, settings);
+            context.visibility = visibility.get();
+            renderRegion(camera, full, image, full, context, false);
+            char name[32];
+            if (settings.aovs.any()) {
+                guides->resolve();
+                std::snprintf(name, sizeof(name), "frame_%04d.exr", frame);
+                writeAovs(output_dir / name, *guides, settings.aovs);
+            }
+            if (settings.denoise.enabled) {
+                applyDenoiser(image, *guides, settings.denoise, false);
+            }
+            if (guides) {
+                guides->clear();
+            }
+
+            if (writing.valid()) {
+                writing.get(); // Rethrows a failed write
+            }
+            std::snprintf(name, sizeof(name), "frame_%04d.ppm", frame);
+            writing = std::async(std::launch::async, [&image, path = output_dir / name] {
+                image.writePPM(path);
+            });
+            Style::logStatusBar(static_cast<double>(frame + 1) / frames);
+        }
+        writing.get();
+    } catch (...) {
+        // The write in flight still reads one of the buffers
+        if (writing.valid()) {
+            writing.wait();
+        }
+        restore();
+        throw;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    restore();
+
+    std::ostringstream report;
+    report << "Sequence: " << frames << " frames in " << elapsed.count() << "s ("
+           << elapsed.count() / frames << "s per frame)";
+    Style::logDone(report.str());
+    logTraceStats(context.stats);
+    if (stats) {
+        *stats = context.stats;
+    }
+}
+
+void Scene::updateObject(size_t index, const std::function<void(Object&)>& edit) {
+    if (index >= objects_.size()) {
+        throw std::runtime_error("Scene::updateObject: no object with index " +
+                                 std::to_string(index) + ".");
+    }
+    edit(*objects_[index]);
+    updateViewpoint(*objects_[index], camera_);
+    geometry_version_++;
+    if (incremental_) {
+        // Tiles that saw the object, and tiles whose rays could now hit it
+        incremental_->invalidate(static_cast<uint32_t>(index), objects_[index]->boundingBox());
+    }
+}
+
+void Scene::updateMaterial(const std::shared_ptr<Material>& material,
+                           const std::function<void(Material&)>& edit) {
+    edit(*material);
+    if (incremental_) {
+        incremental_->invalidate(material.get());
+    }
+}
+
+} // namespace Prism
@@ -0,0 +1,46 @@
+#include "Prism/scene/render_cost.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace Prism {
+
+namespace {
+
+// Regions listed by toString()
+constexpr size_t kListedRegions = 5;
+
+} // namespace
+
+double RenderCostEstimate::wallSeconds(int threads) const {
+    return std::max(seconds / std::max(threads, 1), slowest_tile) + raster_seconds;
+}
+
+std::string RenderCostEstimate::toString() const {
+    std::ostringstream ss;
+    ss << "Image: " << width << "x" << height << ", " << sampled_pixels << " pixels sampled in "
+       << std::fixed << std::setprecision(3) << sample_seconds << "s\n";
+    ss << "Rays: " << rays.rays << " (" << rays.shadow_rays << " area light shadow rays), "
+       << camera_samples << " camera samples\n";
+    ss << "Wall time:";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        ss << " " << threads << (threads == 1 ? " thread " : " threads ") << wallSeconds(threads)
+           << "s" << (threads < 64 ? "," : "\n");
+    }
+    ss << "Costliest regions:\n";
+    for (size_t i = 0; i < std::min(kListedRegions, regions.size()); ++i) {
+        const RegionCost& cost = regions[i];
+        ss << "  [" << cost.region.x << ", " << cost.region.y << ", " << cost.region.width << ", "
+           << cost.region.height << "] " << cost.seconds << "s, " << std::setprecision(1)
+           << cost.rays_per_pixel << " rays per pixel\n"
+           << std::setprecision(3);
+    }
+    return ss.str();
+}
+
+std::ostream& operator<<(std::ostream& os, const RenderCostEstimate& estimate) {
+    return os << estimate.toString();
+}
+
+} // namespace Prism
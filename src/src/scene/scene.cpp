@@ -4,7 +4,11 @@
 #include "Prism/core/material.hpp"
 #include "Prism/core/style.hpp"
 #include "Prism/core/utils.hpp"
+#include "Prism/objects/geometry_cache.hpp"
+#include "Prism/scene/denoiser.hpp"
+#include "Prism/scene/light_tree.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <filesystem>
@@ -12,30 +16,178 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <system_error>
 
 namespace Prism {
 
-PRISM_EXPORT int convert_color(double f) {
-    return static_cast<int>(255.999 * f);
-}
+namespace {
 
-PRISM_EXPORT std::ostream& operator<<(std::ostream& os, const Color& color) {
-    os << static_cast<int>(convert_color(color.r)) << " "
-       << static_cast<int>(convert_color(color.g)) << " "
-       << static_cast<int>(convert_color(color.b));
-    return os;
-}
+// Relative depth by which a camera ray's hit may lie behind the visibility buffer (stored in
+// single precision) and still be trusted to be the nearest
+constexpr double kVisibilityTolerance = 1e-5;
+
+} // namespace
 
 Scene::Scene(Camera camera, Color ambient_light)
     : camera_(std::move(camera)), ambient_color_(ambient_light) {
 }
 
 void Scene::addObject(std::unique_ptr<Object> object) {
+    if (memory_budget_ > 0) {
+        object->accountMemory(load_usage_);
+        load_usage_.other += sizeof(std::unique_ptr<Object>);
+    }
+    updateViewpoint(*object, camera_);
     objects_.push_back(std::move(object));
+    incremental_.reset();
+    geometry_version_++;
+    enforceMemoryBudget();
+}
+
+void Scene::updateViewpoint(Object& object, const Camera& camera) {
+    double pixel_angle = camera.screen_height / camera.pixel_height / camera.screen_distance;
+    object.setViewpoint(camera.pos, pixel_angle);
+}
+
+void Scene::setRenderSettings(const RenderSettings& settings) {
+    settings_ = settings;
+    incremental_.reset();
+}
+
+const RenderSettings& Scene::getRenderSettings() const {
+    return settings_;
+}
+
+void Scene::setAnimation(const Animation& animation) {
+    animation_ = animation;
+}
+
+const Animation& Scene::getAnimation() const {
+    return animation_;
+}
+
+void Scene::setCamera(Camera camera) {
+    camera_ = std::move(camera);
+    incremental_.reset();
+    for (const auto& object : objects_) {
+        updateViewpoint(*object, camera_);
+    }
+}
+
+const Camera& Scene::getCamera() const {
+    return camera_;
+}
+
+void Scene::addCamera(const std::string& name, Camera camera) {
+    for (const auto& named : cameras_) {
+        if (named.first == name) {
+            throw std::runtime_error("Scene::addCamera: there is already a camera named '" + name +
+                                     "'.");
+        }
+    }
+    cameras_.emplace_back(name, std::move(camera));
+}
+
+const Camera& Scene::getCamera(const std::string& name) const {
+    for (const auto& named : cameras_) {
+        if (named.first == name) {
+            return named.second;
+        }
+    }
+    throw std::runtime_error("Scene::getCamera: no camera named '" + name + "'.");
+}
+
+std::vector<std::string> Scene::cameraNames() const {
+    std::vector<std::string> names;
+    for (const auto& named : cameras_) {
+        names.push_back(named.first);
+    }
+    return names;
+}
+
+void Scene::reserveObjects(size_t count) {
+    objects_.reserve(objects_.size() + count);
+}
+
+size_t Scene::objectCount() const {
+    return objects_.size();
 }
 
 void Scene::addLight(std::unique_ptr<Light> light) {
+    if (memory_budget_ > 0) {
+        load_usage_.other += sizeof(Light) + sizeof(std::unique_ptr<Light>);
+    }
     lights_.push_back(std::move(light));
+    incremental_.reset();
+    enforceMemoryBudget();
+}
+
+void Scene::numberMaterials(TraceContext& context) const {
+    for (const auto& object : objects_) {
+        if (auto material = object->getMaterial()) {
+            context.material_ids.emplace(material.get(),
+                                         static_cast<uint32_t>(context.material_ids.size() + 1));
+        }
+    }
+}
+
+ShadowMaps Scene::prepareShadowMaps(const RenderSettings& settings) const {
+    if (!settings.shadow_maps.enabled) {
+        return {};
+    }
+    return shadow_maps_->prepare(lights_, settings.shadow_maps, geometry_version_,
+                                 [this](const Ray& ray) {
+                                     HitRecord rec;
+                                     return hit_closest(ray, 1e-4, INFINITY, rec) ? rec.t
+                                                                                  : INFINITY;
+                                 });
+}
+
+void Scene::accountSceneMemory(MemoryReport& report) const {
+    report.other += sizeof(Scene) + objects_.capacity() * sizeof(std::unique_ptr<Object>) +
+                    lights_.capacity() * sizeof(std::unique_ptr<Light>) +
+                    lights_.size() * sizeof(Light) + shadow_maps_->memoryBytes();
+    report.framebuffer += static_cast<size_t>(camera_.pixel_width) *
+                          static_cast<size_t>(camera_.pixel_height) * sizeof(Color);
+    if (incremental_) {
+        report.framebuffer += incremental_->image.pixels().capacity() * sizeof(Color);
+        for (const RayDependencies& tile : incremental_->tiles) {
+            report.other += tile.byteSize();
+        }
+    }
+}
+
+MemoryReport Scene::memoryReport() const {
+    MemoryReport report;
+    accountSceneMemory(report);
+    for (const auto& object : objects_) {
+        object->accountMemory(report);
+    }
+    return report;
+}
+
+void Scene::setMemoryBudget(size_t bytes) {
+    memory_budget_ = bytes;
+    load_usage_ = memoryReport();
+    enforceMemoryBudget();
+}
+
+size_t Scene::memoryBudget() const {
+    return memory_budget_;
+}
+
+void Scene::enforceMemoryBudget() const {
+    if (memory_budget_ == 0 || load_usage_.total() <= memory_budget_) {
+        return;
+    }
+    const double mib = 1024.0 * 1024.0;
+    std::ostringstream message;
+    message << std::fixed << std::setprecision(1) << "Scene exceeds its memory budget of "
+            << memory_budget_ / mib << " MiB after " << objects_.size() << " objects ("
+            << load_usage_.total() / mib << " MiB):\n"
+            << load_usage_;
+    throw std::runtime_error(message.str());
 }
 
 bool get_local_time(std::tm* tm_out, const std::time_t* time_in) {
@@ -65,71 +217,263 @@ std::filesystem::path generate_filename() {
     return "render_fallback.ppm";
 }
 
-bool Scene::is_in_shadow(const std::unique_ptr<Light>& light, const HitRecord& rec) const {
-    double light_distance = (light->position - rec.p).magnitude();
-    Vector3 light_dir = (light->position - rec.p).normalize();
-    Ray shadow_ray(rec.p, light_dir);
+bool Scene::is_occluded(const Point3& from, const Point3& to, TraceContext* context) const {
+    double light_distance = (to - from).magnitude();
+    Vector3 light_dir = (to - from).normalize();
+    Ray shadow_ray(from, light_dir);
     bool in_shadow = false;
-    for (const auto& obj_ptr : objects_) {
+    for (size_t i = 0; i < objects_.size(); ++i) {
         HitRecord shadow_rec;
-        if (obj_ptr->hit(shadow_ray, 1e-4, light_distance, shadow_rec)) {
+        if (objects_[i]->hit(shadow_ray, 1e-4, light_distance, shadow_rec)) {
             in_shadow = true;
+            if (context && context->dependencies) {
+                context->dependencies->addHit(shadow_ray, shadow_rec.t, static_cast<uint32_t>(i),
+                                              nullptr);
+            }
             break;
         }
     }
+    if (!in_shadow && context && context->dependencies) {
+        context->dependencies->addSegment(shadow_ray, light_distance);
+    }
     return in_shadow;
 }
 
-bool Scene::hit_closest(const Ray& ray, double t_min, double t_max, HitRecord& rec) const {
+bool Scene::hit_closest(const Ray& ray, double t_min, double t_max, HitRecord& rec,
+                        TraceContext* context, const std::vector<uint32_t>* candidates) const {
     bool hit_anything = false;
     double closest_t = INFINITY;
+    size_t closest = 0;
 
-    for (const auto& object_ptr : objects_) {
+    auto test = [&](size_t i) {
         HitRecord temp_rec;
-        if (object_ptr->hit(ray, 1e-4, closest_t, temp_rec)) {
+        if (objects_[i]->hit(ray, 1e-4, closest_t, temp_rec)) {
             hit_anything = true;
             closest_t = temp_rec.t;
+            closest = i;
             rec = temp_rec;
         }
+    };
+    if (candidates) {
+        for (uint32_t i : *candidates) {
+            test(i);
+        }
+    } else {
+        for (size_t i = 0; i < objects_.size(); ++i) {
+            test(i);
+        }
     }
 
+    if (context) {
+        recordHit(ray, hit_anything, closest_t, closest, rec, *context);
+    }
     return hit_anything;
 }
 
-Color Scene::trace(const Ray& ray, int depth) const {
-    if (depth <= 0) {
-        return Color(0, 0, 0); // Base case for recursion, return black color
+bool Scene::hitCamera(const Ray& ray, HitRecord& rec, TraceContext& context) const {
+    if (!context.camera_primitives) {
+        return hit_closest(ray, 1e-4, INFINITY, rec, &context, context.camera_objects);
+    }
+    bool hit_anything = false;
+    double closest_t = INFINITY;
+    size_t closest = 0;
+
+    auto take = [&](size_t i, const HitRecord& temp_rec) {
+        hit_anything = true;
+        closest_t = temp_rec.t;
+        closest = i;
+        rec = temp_rec;
+    };
+    HitRecord temp_rec;
+    for (const auto& primitive : *context.camera_primitives) {
+        if (objects_[primitive.first]->hitPrimitive(ray, primitive.second, 1e-4, closest_t,
+                                                    temp_rec)) {
+            take(primitive.first, temp_rec);
+        }
+    }
+    const VisibilityBuffer& visibility = *context.visibility;
+    for (uint32_t i : *context.camera_objects) {
+        if (!visibility.covers(i) && objects_[i]->hit(ray, 1e-4, closest_t, temp_rec)) {
+            take(i, temp_rec);
+        }
     }
 
-    HitRecord rec;
-    if (!hit_closest(ray, 1e-4, INFINITY, rec)) {
-        return ambient_color_; // Return ambient color if no hit
+    // Rasterized objects the buffer hides lie at or behind its depth (infinite where nothing was
+    // drawn), so they can only be nearer than a hit found behind it
+    const double limit = context.camera_depth * (1.0 + kVisibilityTolerance);
+    if (hit_anything ? visibility.depthOf(rec.p) > limit : std::isfinite(limit)) {
+        for (uint32_t i : *context.camera_objects) {
+            if (visibility.covers(i) && objects_[i]->hit(ray, 1e-4, closest_t, temp_rec)) {
+                take(i, temp_rec);
+            }
+        }
+    }
+
+    recordHit(ray, hit_anything, closest_t, closest, rec, context);
+    return hit_anything;
+}
+
+void Scene::recordHit(const Ray& ray, bool hit_anything, double closest_t, size_t closest,
+                      const HitRecord& rec, TraceContext& context) const {
+    if (hit_anything) {
+        context.hit_object = static_cast<uint32_t>(closest);
+    }
+    if (context.dependencies) {
+        if (hit_anything) {
+            context.dependencies->addHit(ray, closest_t, static_cast<uint32_t>(closest),
+                                         rec.material.get());
+        } else {
+            context.dependencies->addSegment(ray, INFINITY);
+        }
+    }
+}
+
+void Scene::recordGuide(const HitRecord* rec, TraceContext& context) const {
+    if (context.guides->has_ids) {
+        uint32_t object = 0;
+        uint32_t material = 0;
+        if (rec) {
+            object = context.hit_object + 1;
+            auto number = context.material_ids.emplace(
+                rec->material.get(), static_cast<uint32_t>(context.material_ids.size() + 1));
+            material = number.first->second;
+        }
+        context.guides->addIds(context.guide_pixel, object, material);
+    }
+    if (!rec) {
+        context.guides->add(context.guide_pixel, 0.0, Vector3(0, 0, 0), ambient_color_);
+        return;
+    }
+    Color albedo = rec->material ? rec->material->color : Color(1, 1, 1);
+    context.guides->add(context.guide_pixel, rec->t, rec->normal, albedo);
+}
+
+bool Scene::admitSecondary(double weight, TraceContext& context, double& traced_weight,
+                           double& scale) const {
+    const RenderSettings& settings = context.settings;
+    traced_weight = weight;
+    scale = 1.0;
+    if (weight < settings.min_contribution) {
+        context.stats.pruned++;
+        return false; // Cannot change the pixel noticeably
+    }
+    if (settings.russian_roulette && weight < settings.roulette_threshold) {
+        double survival = weight / settings.roulette_threshold;
+        if (context.rng.nextDouble() >= survival) {
+            context.stats.terminated++;
+            return false;
+        }
+        traced_weight = settings.roulette_threshold;
+        scale = 1.0 / survival;
+    }
+    return true;
+}
+
+double Scene::visibility(const Light& light, const HitRecord& rec, TraceContext& context) const {
+    if (!light.isArea()) {
+        if (context.shadow_maps) {
+            auto map = context.shadow_maps->find(&light);
+            if (map != context.shadow_maps->end()) {
+                const ShadowMapSettings& approximation = context.settings.shadow_maps;
+                return map->second->visibility(rec.p, rec.normal, approximation.bias,
+                                               approximation.filter);
+            }
+        }
+        return is_occluded(rec.p, light.position, &context) ? 0.0 : 1.0;
     }
 
+    // A first batch of stratified shadow rays; only a penumbra, where they disagree, gets more
+    const ShadowSettings& settings = context.settings.shadows;
+    const int first = std::max(1, settings.min_samples);
+    const int total = std::max(first, settings.max_samples);
+    int visible = 0;
+    auto traceBatch = [&](int count) {
+        stratifiedOffsets(count, context.rng, context.shadow_offsets);
+        for (const auto& [s, t] : context.shadow_offsets) {
+            if (!is_occluded(rec.p, light.samplePoint(rec.p, s, t), &context)) {
+                visible++;
+            }
+        }
+        context.stats.shadow_rays += count;
+    };
+
+    traceBatch(first);
+    if (visible == 0 || visible == first || total == first) {
+        return static_cast<double>(visible) / first;
+    }
+    traceBatch(total - first);
+    return static_cast<double>(visible) / total;
+}
+
+void Scene::shadeLight(const Light& light, double scale, const HitRecord& rec,
+                       const Vector3& view_dir, TraceContext& context,
+                       Color& surface_color) const {
+    if (light.radius > 0.0) {
+        double distance = (light.position - rec.p).magnitude();
+        if (distance >= light.radius) {
+            return; // Out of the light's influence, no shadow ray needed
+        }
+        scale *= Light::falloff(distance, light.radius);
+    }
+    double visible = visibility(light, rec, context);
+    if (visible == 0.0) {
+        return;
+    }
+    scale *= visible;
+
     auto mat = rec.material;
+    const Color light_color = scale == 1.0 ? light.color : light.color * scale;
 
-    Color surface_color = mat->ka * ambient_color_;
-    Vector3 view_dir = (ray.origin() - rec.p).normalize();
+    // Diffuse contribution
+    Vector3 light_dir = (light.position - rec.p).normalize();
+    double diff_factor = std::max(rec.normal.dot(light_dir), 0.0);
+    surface_color += mat->color * diff_factor * light_color;
 
-    for (const auto& light_ptr : lights_) {
-        if (!is_in_shadow(light_ptr, rec)) {
+    // Specular contribution
+    if (mat->ks.r == 0 && mat->ks.g == 0 && mat->ks.b == 0) {
+        return; // Skip specular if ks is black
+    }
+    Vector3 reflect_dir = (-light_dir) - rec.normal * 2 * (-light_dir).dot(rec.normal);
+    double spec_factor = std::pow(std::max(view_dir.dot(reflect_dir), 0.0), mat->ns);
+    surface_color += mat->ks * spec_factor * light_color;
+}
 
-            // Diffuse contribution
-            Vector3 light_dir = (light_ptr->position - rec.p).normalize();
-            double diff_factor = std::max(rec.normal.dot(light_dir), 0.0);
-            surface_color += mat->color * diff_factor * light_ptr->color;
+Color Scene::directLight(const Ray& ray, const HitRecord& rec, TraceContext& context) const {
+    Color surface_color = rec.material->ka * ambient_color_;
+    Vector3 view_dir = (ray.origin() - rec.p).normalize();
+    const LightSettings& settings = context.settings.lights;
 
-            // Specular contribution
-            if (mat->ks.r == 0 && mat->ks.g == 0 && mat->ks.b == 0) {
-                continue; // Skip specular if ks is black
+    if (settings.selection == LightSelection::All || !context.light_tree) {
+        for (const auto& light_ptr : lights_) {
+            shadeLight(*light_ptr, 1.0, rec, view_dir, context, surface_color);
+        }
+    } else if (settings.selection == LightSelection::Tree) {
+        context.light_tree->collect(rec.p, settings.threshold, context.light_indices);
+        for (uint32_t index : context.light_indices) {
+            shadeLight(*lights_[index], 1.0, rec, view_dir, context, surface_color);
+        }
+    } else {
+        // Each sample is an unbiased estimate of the sum over all lights
+        const int samples = std::max(1, settings.samples);
+        for (int i = 0; i < samples; ++i) {
+            uint32_t index;
+            double pdf;
+            if (context.light_tree->sample(rec.p, context.rng.nextDouble(), index, pdf)) {
+                shadeLight(*lights_[index], 1.0 / (samples * pdf), rec, view_dir, context,
+                           surface_color);
             }
-            Vector3 reflect_dir = (-light_dir) - rec.normal * 2 * (-light_dir).dot(rec.normal);
-            double spec_factor = std::pow(std::max(view_dir.dot(reflect_dir), 0.0), mat->ns);
-            surface_color += mat->ks * spec_factor * light_ptr->color;
         }
     }
+    return surface_color;
+}
 
-    Color final_color = mat->ke + surface_color;
+Bounce Scene::bounce(const Ray& ray, const HitRecord& rec, double weight,
+                     TraceContext& context) const {
+    auto mat = rec.material;
+    Color surface_color = directLight(ray, rec, context);
+
+    Bounce result;
+    result.local = mat->ke + surface_color;
 
     // Handle transparency and refraction
     double opacity = mat->d;
@@ -147,77 +491,277 @@ Color Scene::trace(const Ray& ray, int depth) const {
             reflectance = schlick(cos_theta, refraction_ratio);
         }
 
-        Color reflection_color = Color(0, 0, 0);
-        Color refraction_color = Color(0, 0, 0);
+        result.kind = Bounce::Kind::Transmit;
+        result.opacity = opacity;
+        result.reflectance = reflectance;
 
-        Vector3 reflect_dir = ray.direction() - rec.normal * 2 * ray.direction().dot(rec.normal);
-        Ray reflection_ray(rec.p + rec.normal * 1e-4, reflect_dir);
-        reflection_color = trace(reflection_ray, depth - 1);
+        result.origins[0] = rec.p + rec.normal * 1e-4;
+        result.directions[0] = ray.direction() - rec.normal * 2 * ray.direction().dot(rec.normal);
+        result.weights[0] = weight * (1.0 - opacity) * reflectance;
+        result.count = 1;
 
         if (reflectance < 1.0) {
-            Vector3 refracted_dir = refract(unit_direction, rec.normal, refraction_ratio);
-            Ray refracted_ray(rec.p - rec.normal * 1e-4, refracted_dir);
-            refraction_color = trace(refracted_ray, depth - 1);
+            result.origins[1] = rec.p - rec.normal * 1e-4;
+            result.directions[1] = refract(unit_direction, rec.normal, refraction_ratio);
+            result.weights[1] = weight * (1.0 - opacity) * (1.0 - reflectance);
+            result.count = 2;
         }
-
-        Color trasmited_color =
-            reflection_color * reflectance + refraction_color * (1.0 - reflectance);
-        final_color = final_color * opacity + trasmited_color * (1.0 - opacity);
     } else if (mat->ks.r > 0 || mat->ks.g > 0 || mat->ks.b > 0) {
-        Vector3 reflect_dir = ray.direction() - rec.normal * 2 * ray.direction().dot(rec.normal);
-        Ray reflection_ray(rec.p + rec.normal * 1e-4, reflect_dir);
-        final_color = final_color * (1.0 - mat->ks.r) + mat->ks * trace(reflection_ray, depth - 1);
+        result.kind = Bounce::Kind::Reflect;
+        result.ks = mat->ks;
+        result.origins[0] = rec.p + rec.normal * 1e-4;
+        result.directions[0] = ray.direction() - rec.normal * 2 * ray.direction().dot(rec.normal);
+        result.weights[0] = weight * std::max(mat->ks.r, std::max(mat->ks.g, mat->ks.b));
+        result.count = 1;
     }
 
+    return result;
+}
+
+Color Scene::combine(const Bounce& bounce, const Color children[2]) {
+    Color final_color = bounce.local;
+    if (bounce.kind == Bounce::Kind::Transmit) {
+        Color trasmited_color =
+            children[0] * bounce.reflectance + children[1] * (1.0 - bounce.reflectance);
+        final_color = final_color * bounce.opacity + trasmited_color * (1.0 - bounce.opacity);
+    } else if (bounce.kind == Bounce::Kind::Reflect) {
+        final_color = final_color * (1.0 - bounce.ks.r) + bounce.ks * children[0];
+    }
     return final_color.clamp();
 }
 
-void Scene::render() const {
+Color Scene::trace(const Ray& ray, int depth, double weight, TraceContext& context) const {
+    if (depth <= 0) {
+        return Color(0, 0, 0); // Base case for recursion, return black color
+    }
+    context.stats.rays++;
+
+    HitRecord rec;
+    const bool camera_ray = depth == context.settings.max_depth;
+    bool hit_anything = camera_ray ? hitCamera(ray, rec, context)
+                                   : hit_closest(ray, 1e-4, INFINITY, rec, &context);
+    if (context.guides && camera_ray) {
+        recordGuide(hit_anything ? &rec : nullptr, context);
+    }
+    if (!hit_anything) {
+        return ambient_color_; // Return ambient color if no hit
+    }
+
+    Bounce hit = bounce(ray, rec, weight, context);
+    Color children[2] = {Color(0, 0, 0), Color(0, 0, 0)};
+    for (int i = 0; i < hit.count; ++i) {
+        double traced_weight, scale;
+        if (admitSecondary(hit.weights[i], context, traced_weight, scale)) {
+            Ray secondary(hit.origins[i], hit.directions[i]);
+            children[i] = trace(secondary, depth - 1, traced_weight, context);
+            if (scale != 1.0) {
+                children[i] = children[i] * scale;
+            }
+        }
+    }
+    return combine(hit, children);
+}
+
+Color Scene::shadeFirstHit(const Ray& ray, TraceContext& context) const {
+    const RenderSettings& settings = context.settings;
+    context.stats.rays++;
+
+    HitRecord rec;
+    bool hit_anything = hitCamera(ray, rec, context);
+    if (context.guides) {
+        recordGuide(hit_anything ? &rec : nullptr, context);
+    }
+    if (!hit_anything) {
+        bool lit = settings.integrator == Integrator::Ambient ||
+                   settings.integrator == Integrator::Direct;
+        return lit ? ambient_color_ : Color(0, 0, 0);
+    }
+
+    switch (settings.integrator) {
+        case Integrator::Albedo:
+            return rec.material ? rec.material->color : Color(1, 1, 1);
+        case Integrator::Normals:
+            return Color((rec.normal.x + 1.0) * 0.5, (rec.normal.y + 1.0) * 0.5,
+                         (rec.normal.z + 1.0) * 0.5);
+        case Integrator::Depth: {
+            double distance = (rec.p - ray.origin()).magnitude();
+            double grey = settings.depth_scale / (settings.depth_scale + distance);
+            return Color(grey, grey, grey);
+        }
+        case Integrator::Ambient:
+            return (rec.material->ke + rec.material->ka * ambient_color_).clamp();
+        default: // Direct; Whitted rays are traced by trace() and traceIterative()
+            return (rec.material->ke + directLight(ray, rec, context)).clamp();
+    }
+}
+
+Color Scene::traceIterative(const Ray& ray, int depth, double weight,
+                            TraceContext& context) const {
+    std::vector<TraceFrame>& stack = context.stack;
+    stack.clear();
+    Color returned;
+
+    // Shades the hit of a ray. Returns false when the ray's color is known right away (in
+    // `returned`), true when a frame was pushed to wait for its secondary rays.
+    auto enter = [&](const Ray& current, int current_depth, double current_weight) {
+        if (current_depth <= 0) {
+            returned = Color(0, 0, 0);
+            return false;
+        }
+        context.stats.rays++;
+
+        HitRecord rec;
+        const bool camera_ray = current_depth == context.settings.max_depth;
+        bool hit_anything = camera_ray ? hitCamera(current, rec, context)
+                                       : hit_closest(current, 1e-4, INFINITY, rec, &context);
+        if (context.guides && camera_ray) {
+            recordGuide(hit_anything ? &rec : nullptr, context);
+        }
+        if (!hit_anything) {
+            returned = ambient_color_;
+            return false;
+        }
+
+        Bounce hit = bounce(current, rec, current_weight, context);
+        if (hit.count == 0) {
+            Color children[2] = {Color(0, 0, 0), Color(0, 0, 0)};
+            returned = combine(hit, children);
+            return false;
+        }
+        stack.emplace_back();
+        stack.back().bounce = hit;
+        stack.back().depth = current_depth;
+        return true;
+    };
+
+    if (!enter(ray, depth, weight)) {
+        return returned;
+    }
+
+    // Post-order traversal: a frame is combined once all of its secondary rays returned
+    while (!stack.empty()) {
+        TraceFrame& frame = stack.back();
+        if (frame.waiting) {
+            frame.children[frame.next - 1] =
+                frame.scale != 1.0 ? returned * frame.scale : returned;
+            frame.waiting = false;
+        }
+
+        if (frame.next < frame.bounce.count) {
+            int i = frame.next++;
+            double traced_weight, scale;
+            if (!admitSecondary(frame.bounce.weights[i], context, traced_weight, scale)) {
+                continue; // The child color stays black
+            }
+            frame.waiting = true;
+            frame.scale = scale;
+            Ray secondary(frame.bounce.origins[i], frame.bounce.directions[i]);
+            enter(secondary, frame.depth - 1, traced_weight); // May invalidate `frame`
+            continue;
+        }
+
+        returned = combine(frame.bounce, frame.children);
+        stack.pop_back();
+    }
+    return returned;
+}
+
+void Scene::render() {
     std::filesystem::path output_dir = "./data/output";
     std::filesystem::create_directories(output_dir);
     auto filename = generate_filename();
     auto full_path = output_dir / filename;
 
-    std::ofstream image_file(full_path, std::ios::trunc);
-    if (!image_file.is_open()) {
-        Style::logError("could not open the file for writing.");
-        return;
-    }
-
     auto clean_path = std::filesystem::weakly_canonical(output_dir);
 
     Style::logInfo("Output directory: " + Prism::Style::CYAN + clean_path.string());
     Style::logInfo("Starting render...\n");
 
+    GeometryCache::instance().resetStats();
     auto start_time = std::chrono::steady_clock::now();
 
-    image_file << "P3\n" << camera_.pixel_width << " " << camera_.pixel_height << "\n255\n";
-
-    int total_pixels = camera_.pixel_height * camera_.pixel_width;
-    int pixels_done = 0;
-    const int progress_bar_width = 25;
-    int last_progress_percent = -1;
-
-    for (Ray const& ray : camera_) {
-        image_file << trace(ray, 5) << '\n';
+    // Previews are written next to the file they replace and renamed over it, so a viewer never
+    // reads a partially written image
+    PreviewCallback preview;
+    if (settings_.progressive.enabled) {
+        std::filesystem::path preview_path = settings_.progressive.preview.empty()
+                                                 ? output_dir / "preview.ppm"
+                                                 : settings_.progressive.preview;
+        Style::logInfo("Progressive previews: " + Prism::Style::CYAN + preview_path.string());
+        preview = [preview_path](const Framebuffer& partial) {
+            std::filesystem::path temporary = preview_path;
+            temporary += ".tmp";
+            try {
+                partial.writePPM(temporary, true);
+                std::filesystem::rename(temporary, preview_path);
+            } catch (const std::exception& error) {
+                Style::logWarning(std::string("could not write the preview: ") + error.what());
+            }
+        };
+    }
 
-        pixels_done++;
-        int current_progress_percent =
-            static_cast<int>((static_cast<double>(pixels_done) / total_pixels) * 100.0);
+    RenderSettings settings = settings_;
+    if (settings.aovs.any() && settings.aovs.file.empty()) {
+        settings.aovs.file = full_path;
+        settings.aovs.file.replace_extension(".exr");
+    }
 
-        if (current_progress_percent > last_progress_percent) {
-            last_progress_percent = current_progress_percent;
-            Style::logStatusBar(static_cast<double>(current_progress_percent) / 100.0);
+    std::vector<std::filesystem::path> paths;
+    std::vector<Framebuffer> images;
+    if (!cameras_.empty()) {
+        std::vector<Camera> cameras;
+        std::vector<std::string> names;
+        for (const auto& named : cameras_) {
+            cameras.push_back(named.second);
+            names.push_back(named.first);
+            paths.push_back(output_dir /
+                            (filename.stem().string() + "_" + named.first + ".ppm"));
+        }
+        if (!settings.checkpoint.file.empty()) {
+            Style::logWarning("multi-view renders are not checkpointed.");
         }
+        images = renderViews(cameras, settings, nullptr, names);
+    } else if (settings.composite.empty()) {
+        paths.push_back(full_path);
+        images.push_back(renderImage(settings, nullptr, preview));
+    } else {
+        paths.push_back(full_path);
+        images.push_back(Framebuffer::readPPM(settings.composite));
+        renderInto(images.back(), settings, nullptr, preview);
+    }
+    try {
+        for (size_t i = 0; i < images.size(); ++i) {
+            images[i].writePPM(paths[i]);
+        }
+    } catch (const std::runtime_error&) {
+        Style::logError("could not open the file for writing.");
+        return;
+    }
+    // The image is safely written, so an interruption from here on loses nothing
+    if (!settings.checkpoint.file.empty() && cameras_.empty()) {
+        std::error_code error;
+        std::filesystem::remove(settings.checkpoint.file, error);
     }
-    image_file.close();
 
     auto end_time = std::chrono::steady_clock::now();
     std::chrono::duration<double> elapsed_seconds = end_time - start_time;
 
     Style::logDone("Rendering complete.");
     Style::logDone("Total render time: " + Prism::Style::CYAN + std::to_string(elapsed_seconds.count()) + "s");
-    Style::logDone("Image saved as: " + Prism::Style::CYAN + full_path.string());
+    for (const auto& path : paths) {
+        Style::logDone("Image saved as: " + Prism::Style::CYAN + path.string());
+    }
+
+    GeometryCache::Stats cache_stats = GeometryCache::instance().stats();
+    if (cache_stats.hits + cache_stats.misses > 0) {
+        std::ostringstream report;
+        report << "Geometry cache: " << cache_stats.misses << " misses, " << cache_stats.hits
+               << " hits (" << std::fixed << std::setprecision(2)
+               << cache_stats.missRate() * 100.0 << "% miss rate), " << cache_stats.evictions
+               << " evictions, peak " << (cache_stats.peak_resident_bytes >> 10) << " of "
+               << (cache_stats.budget_bytes >> 10) << " KiB";
+        Style::logInfo(report.str());
+    }
 
 }
 
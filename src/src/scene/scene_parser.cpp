@@ -8,17 +8,25 @@
 #include "Prism/core/point.hpp"
 #include "Prism/core/style.hpp"
 #include "Prism/core/vector.hpp"
+#include "Prism/objects/geometry_cache.hpp"
 #include "Prism/objects/mesh.hpp"
+#include "Prism/objects/mesh_proxy.hpp"
+#include "Prism/objects/out_of_core_mesh.hpp"
 #include "Prism/objects/plane.hpp"
 #include "Prism/objects/sphere.hpp"
 #include "Prism/objects/triangle.hpp"
 #include "Prism/scene/camera.hpp"
+#include "Prism/scene/render_settings.hpp"
 
 #include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 #ifndef M_PI
@@ -52,6 +60,14 @@ Color parseColor(const YAML::Node& node) {
     return Color(node[0].as<double>(), node[1].as<double>(), node[2].as<double>());
 }
 
+// Converts a YAML node {min: [x, y, z], max: [x, y, z]} to an AABB
+AABB parseBounds(const YAML::Node& node) {
+    if (!node.IsMap() || !node["min"] || !node["max"]) {
+        throw std::runtime_error("Parsing error: Malformed bounds, expected 'min' and 'max'.");
+    }
+    return AABB(parsePoint(node["min"]), parsePoint(node["max"]));
+}
+
 // Converts a YAML node with material properties to a Material
 std::shared_ptr<Material> parseMaterial(const YAML::Node& node) {
     auto mat = std::make_shared<Material>();
@@ -107,6 +123,516 @@ Matrix parseTransformations(const YAML::Node& node) {
     return final_transform;
 }
 
+// Number of records read from a raw bulk file per chunk. Keeps memory bounded regardless of the
+// file size, as objects are created while the file is being read.
+constexpr size_t kBulkChunkRecords = 4096;
+
+// Resolves a path found in the scene file relative to the scene file's directory
+std::filesystem::path resolvePath(const std::string& scene_file, const std::string& relative) {
+    return std::filesystem::path(scene_file).parent_path() / relative;
+}
+
+// Streams a raw file of packed little-endian float32 records with `record_size` floats each,
+// calling `emit` once per record. Only one chunk of records is held in memory at a time. Floats
+// are byte-swapped on big-endian hosts; a file that does not end on a record boundary is
+// rejected.
+template <typename Callback>
+void streamFloatRecords(const std::filesystem::path& path, size_t record_size, Callback emit) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open bulk data file: " + path.string());
+    }
+
+    const uint32_t probe = 1;
+    const bool big_endian = *reinterpret_cast<const unsigned char*>(&probe) == 0;
+    const size_t record_bytes = record_size * sizeof(float);
+    std::vector<float> chunk(kBulkChunkRecords * record_size);
+    const std::streamsize chunk_bytes = static_cast<std::streamsize>(chunk.size() * sizeof(float));
+
+    while (file) {
+        file.read(reinterpret_cast<char*>(chunk.data()), chunk_bytes);
+        const size_t bytes_read = static_cast<size_t>(file.gcount());
+        if (bytes_read % record_bytes != 0) {
+            throw std::runtime_error("Bulk data file is truncated: " + path.string());
+        }
+        const size_t floats_read = bytes_read / sizeof(float);
+        if (big_endian) {
+            for (size_t i = 0; i < floats_read; ++i) {
+                unsigned char* bytes = reinterpret_cast<unsigned char*>(&chunk[i]);
+                std::swap(bytes[0], bytes[3]);
+                std::swap(bytes[1], bytes[2]);
+            }
+        }
+        for (size_t i = 0; i < floats_read; i += record_size) {
+            emit(&chunk[i]);
+        }
+    }
+}
+
+// Reads a YAML sequence of scalars into a flat array of doubles
+std::vector<double> parsePackedArray(const YAML::Node& node, size_t stride, const char* what) {
+    if (!node.IsSequence() || node.size() % stride != 0) {
+        throw std::runtime_error(std::string("Parsing error: Malformed packed array '") + what +
+                                 "'.");
+    }
+    std::vector<double> values;
+    values.reserve(node.size());
+    for (const auto& value : node) {
+        values.push_back(value.as<double>());
+    }
+    return values;
+}
+
+// Creates one Sphere per record of a 'spheres' block, either from the packed 'centers'/'radii'
+// arrays or streamed from a raw float file with records [cx, cy, cz, r].
+void parseSphereBlock(const YAML::Node& node, const std::string& scene_file,
+                      const std::shared_ptr<Material>& material, Scene& scene) {
+    const bool has_transform = static_cast<bool>(node["transform"]);
+    const Matrix transform = parseTransformations(node["transform"]);
+
+    size_t index = 0;
+    auto emit = [&](double cx, double cy, double cz, double r) {
+        // Also rejects NaN, which fails every comparison
+        if (!(r > 0.0)) {
+            throw std::runtime_error("Parsing error: sphere " + std::to_string(index) +
+                                     " of a 'spheres' block has an invalid radius.");
+        }
+        index++;
+        auto sphere = std::make_unique<Sphere>(Point3(cx, cy, cz), r, material);
+        if (has_transform) {
+            sphere->setTransform(transform);
+        }
+        scene.addObject(std::move(sphere));
+    };
+
+    if (node["file"]) {
+        auto path = resolvePath(scene_file, node["file"].as<std::string>());
+        scene.reserveObjects(std::filesystem::file_size(path) / (4 * sizeof(float)));
+        streamFloatRecords(path, 4,
+                           [&](const float* rec) { emit(rec[0], rec[1], rec[2], rec[3]); });
+        return;
+    }
+
+    std::vector<double> centers = parsePackedArray(node["centers"], 3, "centers");
+    const size_t count = centers.size() / 3;
+    std::vector<double> radii;
+    if (node["radii"]) {
+        radii = parsePackedArray(node["radii"], 1, "radii");
+        if (radii.size() != count) {
+            throw std::runtime_error("Parsing error: 'radii' and 'centers' sizes do not match.");
+        }
+    } else {
+        radii.assign(count, node["radius"].as<double>());
+    }
+
+    scene.reserveObjects(count);
+    for (size_t i = 0; i < count; ++i) {
+        emit(centers[3 * i], centers[3 * i + 1], centers[3 * i + 2], radii[i]);
+    }
+}
+
+// Creates one Triangle per record of a 'triangles' block, either from the packed 'vertices'
+// array or streamed from a raw float file with records [x1, y1, z1, x2, y2, z2, x3, y3, z3].
+void parseTriangleBlock(const YAML::Node& node, const std::string& scene_file,
+                        const std::shared_ptr<Material>& material, Scene& scene) {
+    const bool has_transform = static_cast<bool>(node["transform"]);
+    const Matrix transform = parseTransformations(node["transform"]);
+
+    auto emit = [&](const auto* v) {
+        auto triangle = std::make_unique<Triangle>(Point3(v[0], v[1], v[2]),
+                                                   Point3(v[3], v[4], v[5]),
+                                                   Point3(v[6], v[7], v[8]), material);
+        if (has_transform) {
+            triangle->setTransform(transform);
+        }
+        scene.addObject(std::move(triangle));
+    };
+
+    if (node["file"]) {
+        auto path = resolvePath(scene_file, node["file"].as<std::string>());
+        scene.reserveObjects(std::filesystem::file_size(path) / (9 * sizeof(float)));
+        streamFloatRecords(path, 9, emit);
+        return;
+    }
+
+    std::vector<double> vertices = parsePackedArray(node["vertices"], 9, "vertices");
+    scene.reserveObjects(vertices.size() / 9);
+    for (size_t i = 0; i < vertices.size(); i += 9) {
+        emit(&vertices[i]);
+    }
+}
+
+// Parses the 'lod' block of a mesh: levels read from files, then generated ones, then the
+// selection parameters
+void parseLod(const YAML::Node& node, const std::string& scene_path, Mesh& mesh) {
+    if (node["files"]) {
+        for (const auto& file : node["files"]) {
+            mesh.addLevel(MeshLevel::fromObj(
+                resolvePath(scene_path, file.as<std::string>()).string()));
+        }
+    }
+    if (node["levels"]) {
+        double ratio = node["ratio"] ? node["ratio"].as<double>() : 0.25;
+        if (ratio <= 0.0 || ratio >= 1.0) {
+            throw std::runtime_error("Parsing error: 'lod.ratio' must be between 0 and 1.");
+        }
+        mesh.generateLevels(node["levels"].as<int>(), ratio);
+    }
+    LodSettings settings;
+    if (node["triangle_pixels"]) {
+        settings.triangle_pixels = node["triangle_pixels"].as<double>();
+    }
+    if (node["pin"]) {
+        settings.pinned = node["pin"].as<int>();
+    }
+    mesh.setLodSettings(settings);
+}
+
+// Parses a camera; keys it does not set are taken from `defaults`, or are required without it
+Camera parseCamera(const YAML::Node& node, const Camera* defaults) {
+    auto has = [&](const char* key) { return node[key] || !defaults; };
+    return Camera(has("lookfrom") ? parsePoint(node["lookfrom"]) : defaults->pos,
+                  has("lookat") ? parsePoint(node["lookat"]) : defaults->aim,
+                  has("vup") ? parseVector(node["vup"]) : defaults->up,
+                  has("screen_distance") ? node["screen_distance"].as<double>()
+                                         : defaults->screen_distance,
+                  has("viewport_height") ? node["viewport_height"].as<double>()
+                                         : defaults->screen_height,
+                  has("viewport_width") ? node["viewport_width"].as<double>()
+                                        : defaults->screen_width,
+                  has("image_height") ? node["image_height"].as<int>() : defaults->pixel_height,
+                  has("image_width") ? node["image_width"].as<int>() : defaults->pixel_width);
+}
+
+// Parses the optional top-level 'render' block
+RenderSettings parseRenderSettings(const YAML::Node& node, const std::string& scene_path) {
+    RenderSettings settings;
+    if (node["max_depth"]) {
+        settings.max_depth = node["max_depth"].as<int>();
+    }
+    if (node["seed"]) {
+        settings.seed = node["seed"].as<uint64_t>();
+    }
+    if (node["min_contribution"]) {
+        settings.min_contribution = node["min_contribution"].as<double>();
+    }
+    if (node["tile_size"]) {
+        settings.tile_size = node["tile_size"].as<int>();
+    }
+    if (node["threads"]) {
+        settings.threads = node["threads"].as<int>();
+    }
+    if (node["russian_roulette"]) {
+        settings.russian_roulette = node["russian_roulette"].as<bool>();
+    }
+    if (node["roulette_threshold"]) {
+        settings.roulette_threshold = node["roulette_threshold"].as<double>();
+    }
+    const YAML::Node samples = node["samples"];
+    if (samples) {
+        SamplingSettings& sampling = settings.sampling;
+        if (samples.IsScalar()) {
+            sampling.min_samples = sampling.max_samples = samples.as<int>();
+        } else {
+            sampling.min_samples = samples["min"] ? samples["min"].as<int>() : 4;
+            sampling.max_samples =
+                samples["max"] ? samples["max"].as<int>() : 4 * sampling.min_samples;
+            if (samples["variance_threshold"]) {
+                sampling.variance_threshold = samples["variance_threshold"].as<double>();
+            }
+            if (samples["contrast_threshold"]) {
+                sampling.contrast_threshold = samples["contrast_threshold"].as<double>();
+            }
+        }
+        if (sampling.min_samples < 1 || sampling.max_samples < sampling.min_samples) {
+            throw std::runtime_error(
+                "Parsing error: 'render.samples' needs 1 <= min <= max samples per pixel.");
+        }
+    }
+    const YAML::Node lights = node["lights"];
+    if (lights) {
+        LightSettings& light_settings = settings.lights;
+        std::string mode = lights["mode"] ? lights["mode"].as<std::string>() : "tree";
+        if (mode == "all") {
+            light_settings.selection = LightSelection::All;
+        } else if (mode == "tree") {
+            light_settings.selection = LightSelection::Tree;
+        } else if (mode == "sample") {
+            light_settings.selection = LightSelection::Sample;
+        } else {
+            throw std::runtime_error("Parsing error: unknown 'render.lights.mode' '" + mode +
+                                     "' (expected all, tree or sample).");
+        }
+        if (lights["threshold"]) {
+            light_settings.threshold = lights["threshold"].as<double>();
+        }
+        if (lights["samples"]) {
+            light_settings.samples = lights["samples"].as<int>();
+        }
+        if (light_settings.threshold < 0.0 || light_settings.samples < 1) {
+            throw std::runtime_error("Parsing error: 'render.lights' needs threshold >= 0 and "
+                                     "at least 1 sample.");
+        }
+    }
+    const YAML::Node shadows = node["shadows"];
+    if (shadows) {
+        ShadowSettings& shadow_settings = settings.shadows;
+        if (shadows["min_samples"]) {
+            shadow_settings.min_samples = shadows["min_samples"].as<int>();
+        }
+        if (shadows["max_samples"]) {
+            shadow_settings.max_samples = shadows["max_samples"].as<int>();
+        }
+        if (shadow_settings.min_samples < 1 ||
+            shadow_settings.max_samples < shadow_settings.min_samples) {
+            throw std::runtime_error("Parsing error: 'render.shadows' needs 1 <= min_samples <= "
+                                     "max_samples.");
+        }
+    }
+    const YAML::Node shadow_maps = node["shadow_maps"];
+    if (shadow_maps) {
+        ShadowMapSettings& map_settings = settings.shadow_maps;
+        if (shadow_maps.IsScalar()) {
+            map_settings.enabled = shadow_maps.as<bool>();
+        } else {
+            map_settings.enabled =
+                shadow_maps["enabled"] ? shadow_maps["enabled"].as<bool>() : true;
+            if (shadow_maps["resolution"]) {
+                map_settings.resolution = shadow_maps["resolution"].as<int>();
+            }
+            if (shadow_maps["bias"]) {
+                map_settings.bias = shadow_maps["bias"].as<double>();
+            }
+            if (shadow_maps["filter"]) {
+                map_settings.filter = shadow_maps["filter"].as<int>();
+            }
+        }
+        if (map_settings.resolution < 1 || map_settings.bias < 0.0 || map_settings.filter < 0) {
+            throw std::runtime_error("Parsing error: 'render.shadow_maps' needs resolution >= 1, "
+                                     "bias >= 0 and filter >= 0.");
+        }
+    }
+    const YAML::Node denoise = node["denoise"];
+    if (denoise) {
+        DenoiseSettings& denoise_settings = settings.denoise;
+        if (denoise.IsScalar()) {
+            denoise_settings.enabled = denoise.as<bool>();
+        } else {
+            denoise_settings.enabled = denoise["enabled"] ? denoise["enabled"].as<bool>() : true;
+            if (denoise["levels"]) {
+                denoise_settings.levels = denoise["levels"].as<int>();
+            }
+            if (denoise["color_sigma"]) {
+                denoise_settings.color_sigma = denoise["color_sigma"].as<double>();
+            }
+            if (denoise["normal_sigma"]) {
+                denoise_settings.normal_sigma = denoise["normal_sigma"].as<double>();
+            }
+            if (denoise["depth_sigma"]) {
+                denoise_settings.depth_sigma = denoise["depth_sigma"].as<double>();
+            }
+            if (denoise["albedo_sigma"]) {
+                denoise_settings.albedo_sigma = denoise["albedo_sigma"].as<double>();
+            }
+        }
+        if (denoise_settings.levels < 1 || denoise_settings.levels > 10 ||
+            denoise_settings.color_sigma <= 0.0 || denoise_settings.normal_sigma <= 0.0 ||
+            denoise_settings.depth_sigma <= 0.0 || denoise_settings.albedo_sigma <= 0.0) {
+            throw std::runtime_error("Parsing error: 'render.denoise' needs 1 to 10 levels and "
+                                     "positive sigmas.");
+        }
+    }
+    if (node["scale"]) {
+        settings.resolution_scale = node["scale"].as<double>();
+        if (settings.resolution_scale <= 0.0) {
+            throw std::runtime_error("Parsing error: 'render.scale' must be positive.");
+        }
+    }
+    if (node["regions"]) {
+        for (const auto& region : node["regions"]) {
+            if (!region.IsSequence() || region.size() != 4 || region[2].as<int>() < 1 ||
+                region[3].as<int>() < 1) {
+                throw std::runtime_error("Parsing error: each of 'render.regions' must be "
+                                         "[x, y, width, height] with a positive size.");
+            }
+            settings.regions.push_back(ImageRegion{region[0].as<int>(), region[1].as<int>(),
+                                                   region[2].as<int>(), region[3].as<int>()});
+        }
+    }
+    if (node["crop"]) {
+        settings.crop = node["crop"].as<bool>();
+    }
+    if (node["composite"]) {
+        settings.composite = resolvePath(scene_path, node["composite"].as<std::string>());
+    }
+    if (node["integrator"]) {
+        std::string integrator = node["integrator"].as<std::string>();
+        if (integrator == "whitted") {
+            settings.integrator = Integrator::Whitted;
+        } else if (integrator == "albedo") {
+            settings.integrator = Integrator::Albedo;
+        } else if (integrator == "normals") {
+            settings.integrator = Integrator::Normals;
+        } else if (integrator == "depth") {
+            settings.integrator = Integrator::Depth;
+        } else if (integrator == "ambient") {
+            settings.integrator = Integrator::Ambient;
+        } else if (integrator == "direct") {
+            settings.integrator = Integrator::Direct;
+        } else {
+            throw std::runtime_error("Parsing error: unknown 'render.integrator' '" + integrator +
+                                     "' (expected whitted, albedo, normals, depth, ambient or "
+                                     "direct).");
+        }
+    }
+    if (node["depth_scale"]) {
+        settings.depth_scale = node["depth_scale"].as<double>();
+        if (settings.depth_scale <= 0.0) {
+            throw std::runtime_error("Parsing error: 'render.depth_scale' must be positive.");
+        }
+    }
+    if (node["aovs"]) {
+        AovSettings& aovs = settings.aovs;
+        for (const auto& channel : node["aovs"]) {
+            std::string name = channel.as<std::string>();
+            if (name == "depth") {
+                aovs.depth = true;
+            } else if (name == "normal") {
+                aovs.normal = true;
+            } else if (name == "albedo") {
+                aovs.albedo = true;
+            } else if (name == "object_id") {
+                aovs.object_id = true;
+            } else if (name == "material_id") {
+                aovs.material_id = true;
+            } else {
+                throw std::runtime_error("Parsing error: unknown AOV '" + name +
+                                         "' (expected depth, normal, albedo, object_id or "
+                                         "material_id).");
+            }
+        }
+    }
+    if (node["aov_file"]) {
+        settings.aovs.file = resolvePath(scene_path, node["aov_file"].as<std::string>());
+    }
+    const YAML::Node progressive = node["progressive"];
+    if (progressive) {
+        ProgressiveSettings& progressive_settings = settings.progressive;
+        if (progressive.IsScalar()) {
+            progressive_settings.enabled = progressive.as<bool>();
+        } else {
+            progressive_settings.enabled =
+                progressive["enabled"] ? progressive["enabled"].as<bool>() : true;
+            if (progressive["interval"]) {
+                progressive_settings.interval = progressive["interval"].as<double>();
+            }
+            if (progressive["preview"]) {
+                progressive_settings.preview =
+                    resolvePath(scene_path, progressive["preview"].as<std::string>());
+            }
+        }
+        if (progressive_settings.interval < 0.0) {
+            throw std::runtime_error("Parsing error: 'render.progressive.interval' must not be "
+                                     "negative.");
+        }
+    }
+    const YAML::Node checkpoint = node["checkpoint"];
+    if (checkpoint) {
+        const YAML::Node file = checkpoint.IsScalar() ? checkpoint : checkpoint["file"];
+        if (!file) {
+            throw std::runtime_error("Parsing error: 'render.checkpoint' needs a 'file'.");
+        }
+        settings.checkpoint.file = resolvePath(scene_path, file.as<std::string>());
+        if (checkpoint["interval"]) {
+            settings.checkpoint.interval = checkpoint["interval"].as<double>();
+        }
+        if (settings.checkpoint.interval < 0.0) {
+            throw std::runtime_error("Parsing error: 'render.checkpoint.interval' must not be "
+                                     "negative.");
+        }
+    }
+    if (node["deadline"]) {
+        settings.deadline = node["deadline"].as<double>();
+        if (settings.deadline < 0.0) {
+            throw std::runtime_error("Parsing error: 'render.deadline' must not be negative.");
+        }
+    }
+    if (node["rasterize"]) {
+        settings.rasterize = node["rasterize"].as<bool>();
+    }
+    if (settings.max_depth < 1) {
+        throw std::runtime_error("Parsing error: 'render.max_depth' must be at least 1.");
+    }
+    if (settings.threads < 0) {
+        throw std::runtime_error("Parsing error: 'render.threads' must not be negative.");
+    }
+    if (settings.tile_size < 1) {
+        throw std::runtime_error("Parsing error: 'render.tile_size' must be at least 1.");
+    }
+    if (settings.min_contribution < 0.0 || settings.roulette_threshold <= 0.0) {
+        throw std::runtime_error(
+            "Parsing error: 'render' contribution thresholds must not be negative.");
+    }
+    return settings;
+}
+
+// A named object of the scene file: its index in the scene and its transformation
+struct NamedObject {
+    size_t index;
+    Matrix transform;
+};
+
+// Parses the optional top-level 'animation' block
+Animation parseAnimation(const YAML::Node& node, const std::map<std::string, NamedObject>& named) {
+    Animation animation;
+    animation.setFrameCount(node["frames"] ? node["frames"].as<int>() : 0);
+    if (animation.frameCount() <= 0) {
+        throw std::runtime_error("Parsing error: 'animation.frames' must be at least 1.");
+    }
+
+    if (node["camera"]) {
+        std::vector<CameraKey> keys;
+        for (const auto& key_node : node["camera"]) {
+            CameraKey key;
+            key.frame = key_node["frame"].as<double>();
+            key.lookfrom = parsePoint(key_node["lookfrom"]);
+            key.lookat = parsePoint(key_node["lookat"]);
+            keys.push_back(key);
+        }
+        animation.setCameraKeys(std::move(keys));
+    }
+
+    if (node["objects"]) {
+        for (const auto& track_node : node["objects"]) {
+            std::string name = track_node["name"].as<std::string>();
+            auto object = named.find(name);
+            if (object == named.end()) {
+                throw std::runtime_error("Parsing error: animated object not found: " + name);
+            }
+            std::vector<TransformKey> keys;
+            for (const auto& key_node : track_node["keys"]) {
+                TransformKey key;
+                key.frame = key_node["frame"].as<double>();
+                if (key_node["translate"]) {
+                    key.translation = parseVector(key_node["translate"]);
+                }
+                if (key_node["rotate"]) {
+                    key.axis = parseVector(key_node["rotate"]["axis"]);
+                    key.angle = key_node["rotate"]["angle"].as<double>() * (M_PI / 180.0);
+                }
+                if (key_node["scale"]) {
+                    const YAML::Node scale = key_node["scale"];
+                    key.scale = scale.IsScalar() ? Vector3(1, 1, 1) * scale.as<double>()
+                                                 : parseVector(scale);
+                }
+                keys.push_back(key);
+            }
+            animation.addTrack(object->second.index, object->second.transform, std::move(keys));
+        }
+    }
+    return animation;
+}
+
 // --- SceneParser Class Implementation ---
 
 SceneParser::SceneParser(const std::string& sceneFilePath) : filePath(sceneFilePath) {
@@ -122,15 +648,16 @@ Scene SceneParser::parse() {
 
     Style::logInfo("Parsing scene from file: " + Style::CYAN + filePath);
 
-    // Parse the Camera
-    if (!root["camera"]) {
+    // Parse the Camera; without one, the first named camera is the main one
+    const YAML::Node cameras = root["cameras"];
+    if (cameras && (!cameras.IsSequence() || cameras.size() == 0)) {
+        throw std::runtime_error("Parsing error: 'cameras' must be a non-empty list.");
+    }
+    if (!root["camera"] && !cameras) {
         throw std::runtime_error("'camera' node not found in the scene file.");
     }
-    const auto& cam_node = root["camera"];
-    Camera camera(parsePoint(cam_node["lookfrom"]), parsePoint(cam_node["lookat"]),
-                  parseVector(cam_node["vup"]), cam_node["screen_distance"].as<double>(),
-                  cam_node["viewport_height"].as<double>(), cam_node["viewport_width"].as<double>(),
-                  cam_node["image_height"].as<int>(), cam_node["image_width"].as<int>());
+    Camera camera = root["camera"] ? parseCamera(root["camera"], nullptr)
+                                   : parseCamera(cameras[0], nullptr);
 
     Color ambient_light(0.1, 0.1, 0.1); // Valor padrão
     if (root["ambient_light"]) {
@@ -140,7 +667,36 @@ Scene SceneParser::parse() {
         Style::logWarning("Ambient light not defined. Using default (0.1, 0.1, 0.1).");
     }
 
-    Scene scene(std::move(camera), ambient_light);
+    Scene scene(camera, ambient_light);
+    if (cameras) {
+        for (const auto& camera_node : cameras) {
+            if (!camera_node["name"]) {
+                throw std::runtime_error("Parsing error: every camera of 'cameras' needs a name.");
+            }
+            scene.addCamera(camera_node["name"].as<std::string>(),
+                            parseCamera(camera_node, &camera));
+        }
+    }
+
+    if (root["geometry_cache"] && root["geometry_cache"]["budget_mb"]) {
+        double budget_mb = root["geometry_cache"]["budget_mb"].as<double>();
+        if (budget_mb <= 0.0) {
+            throw std::runtime_error("Parsing error: 'geometry_cache.budget_mb' must be positive.");
+        }
+        GeometryCache::instance().setBudget(static_cast<size_t>(budget_mb * 1024.0 * 1024.0));
+    }
+
+    if (root["render"]) {
+        scene.setRenderSettings(parseRenderSettings(root["render"], filePath));
+    }
+
+    if (root["memory_budget_mb"]) {
+        double budget_mb = root["memory_budget_mb"].as<double>();
+        if (budget_mb <= 0.0) {
+            throw std::runtime_error("Parsing error: 'memory_budget_mb' must be positive.");
+        }
+        scene.setMemoryBudget(static_cast<size_t>(budget_mb * 1024.0 * 1024.0));
+    }
 
     // Parse Material Definitions (for reuse)
     std::map<std::string, std::shared_ptr<Material>> materials;
@@ -156,7 +712,30 @@ Scene SceneParser::parse() {
             Point3 pos = parsePoint(light_node["position"]);
             Vector3 color_vec = parseVector(light_node["color"]);
             Color color(color_vec.x, color_vec.y, color_vec.z);
-            scene.addLight(std::make_unique<Light>(pos, color));
+            double radius = light_node["radius"] ? light_node["radius"].as<double>() : 0.0;
+            if (radius < 0.0) {
+                throw std::runtime_error("Parsing error: light 'radius' must not be negative.");
+            }
+            std::string type =
+                light_node["type"] ? light_node["type"].as<std::string>() : "point";
+            if (type == "point") {
+                scene.addLight(std::make_unique<Light>(pos, color, radius));
+            } else if (type == "rectangle") {
+                Vector3 u = parseVector(light_node["u"]);
+                Vector3 v = parseVector(light_node["v"]);
+                scene.addLight(
+                    std::make_unique<Light>(Light::rectangle(pos, u, v, color, radius)));
+            } else if (type == "sphere") {
+                double size = light_node["size"] ? light_node["size"].as<double>() : 0.0;
+                if (size <= 0.0) {
+                    throw std::runtime_error(
+                        "Parsing error: sphere light needs a positive 'size' (its radius).");
+                }
+                scene.addLight(std::make_unique<Light>(Light::sphere(pos, size, color, radius)));
+            } else {
+                throw std::runtime_error("Parsing error: unknown light type '" + type +
+                                         "' (expected point, rectangle or sphere).");
+            }
         }
     } else {
         Style::logWarning("'lights' node not found or is not a list. No lights will be added.");
@@ -166,16 +745,20 @@ Scene SceneParser::parse() {
     if (!root["objects"] || !root["objects"].IsSequence()) {
         throw std::runtime_error("'objects' node not found or is not a list.");
     }
+    std::map<std::string, NamedObject> named_objects;
 
     for (const auto& obj_node : root["objects"]) {
         std::string type = obj_node["type"].as<std::string>();
 
         // Find the material (whether defined inline or by reference)
         std::shared_ptr<Material> material;
-        if (obj_node["material"].IsMap()) {
-            material = parseMaterial(obj_node["material"]);
-        } else if (obj_node["material"].IsScalar()) {
-            std::string mat_name = obj_node["material"].as<std::string>();
+        const YAML::Node mat_node = obj_node["material"];
+        if (!mat_node) {
+            material = std::make_shared<Material>(); // Default material
+        } else if (mat_node.IsMap()) {
+            material = parseMaterial(mat_node);
+        } else if (mat_node.IsScalar()) {
+            std::string mat_name = mat_node.as<std::string>();
             if (materials.count(mat_name)) {
                 material = materials.at(mat_name);
             } else {
@@ -185,6 +768,14 @@ Scene SceneParser::parse() {
             material = std::make_shared<Material>(); // Default material
         }
 
+        if (type == "spheres") {
+            parseSphereBlock(obj_node, filePath, material, scene);
+            continue;
+        } else if (type == "triangles") {
+            parseTriangleBlock(obj_node, filePath, material, scene);
+            continue;
+        }
+
         std::unique_ptr<Object> object;
 
         if (type == "sphere") {
@@ -198,15 +789,41 @@ Scene SceneParser::parse() {
                 std::make_unique<Triangle>(parsePoint(obj_node["p1"]), parsePoint(obj_node["p2"]),
                                            parsePoint(obj_node["p3"]), material);
         } else if (type == "mesh") {
-            std::filesystem::path scene_dir = std::filesystem::path(filePath).parent_path();
-            std::string mesh_path_str = obj_node["path"].as<std::string>();
-            std::filesystem::path full_mesh_path = scene_dir / mesh_path_str;
+            std::filesystem::path full_mesh_path =
+                resolvePath(filePath, obj_node["path"].as<std::string>());
+
+            const bool lazy = obj_node["lazy"] && obj_node["lazy"].as<bool>();
+            const bool out_of_core = obj_node["out_of_core"] && obj_node["out_of_core"].as<bool>();
+            if (obj_node["lod"] && (lazy || out_of_core)) {
+                throw std::runtime_error("Parsing error: 'lod' is only supported for meshes held "
+                                         "in memory (not lazy or out_of_core).");
+            }
 
-            object = std::make_unique<Mesh>(full_mesh_path);
-            // Overrides the .obj material with the one from the .yml, if specified
-            if (obj_node["material"]) {
+            if (lazy) {
+                // Only the bounds are needed now; the OBJ is read when a ray first reaches them
+                AABB bounds = obj_node["bounds"] ? parseBounds(obj_node["bounds"])
+                                                 : MeshProxy::readBounds(full_mesh_path);
+                object = std::make_unique<MeshProxy>(full_mesh_path, bounds,
+                                                     obj_node["material"] ? material : nullptr);
+            } else if (out_of_core) {
+                size_t cluster_size = obj_node["cluster_size"]
+                                          ? obj_node["cluster_size"].as<size_t>()
+                                          : OutOfCoreMesh::kDefaultClusterTriangles;
+                auto mesh = OutOfCoreMesh::fromObj(full_mesh_path, cluster_size);
+                if (obj_node["material"]) {
+                    mesh->setMaterial(material);
+                }
+                object = std::move(mesh);
+            } else {
+                object = std::make_unique<Mesh>(full_mesh_path);
                 auto mesh_ptr = static_cast<Mesh*>(object.get());
-                mesh_ptr->setMaterial(material);
+                // Overrides the .obj material with the one from the .yml, if specified
+                if (obj_node["material"]) {
+                    mesh_ptr->setMaterial(material);
+                }
+                if (obj_node["lod"]) {
+                    parseLod(obj_node["lod"], filePath, *mesh_ptr);
+                }
             }
         } else {
             Style::logWarning("Unknown object type: " + type + ". Skipping this object.");
@@ -214,11 +831,23 @@ Scene SceneParser::parse() {
         }
 
         if (object) {
-            object->setTransform(parseTransformations(obj_node["transform"]));
+            // Objects default to the identity transform, so the inverse is only computed when
+            // the scene actually specifies one.
+            Matrix transform = Matrix::identity(4);
+            if (obj_node["transform"]) {
+                transform = parseTransformations(obj_node["transform"]);
+                object->setTransform(transform);
+            }
+            if (obj_node["name"]) {
+                named_objects.insert_or_assign(obj_node["name"].as<std::string>(),
+                                               NamedObject{scene.objectCount(), transform});
+            }
             scene.addObject(std::move(object));
         }
     }
 
+    animation_ = root["animation"] ? parseAnimation(root["animation"], named_objects) : Animation();
+    scene.setAnimation(animation_);
     return scene;
 }
 
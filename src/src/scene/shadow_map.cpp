@@ -0,0 +1,181 @@
+#include "Prism/scene/shadow_map.hpp"
+
+#include "Prism/core/style.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Prism {
+
+namespace {
+
+// Bound of the slope-scaled depth tolerance, reached at grazing incidence (~84 degrees)
+constexpr double kMaxSlope = 10.0;
+
+} // namespace
+
+ShadowCubemap::ShadowCubemap(const Point3& center, int resolution,
+                             const std::function<double(const Ray&)>& cast)
+    : center_(center), resolution_(resolution) {
+    if (resolution <= 0) {
+        throw std::runtime_error("ShadowCubemap: the resolution must be positive.");
+    }
+    const size_t face_texels = static_cast<size_t>(resolution) * resolution;
+    depth_.resize(6 * face_texels);
+
+    // Rows of all faces are shared out among the cores
+    const int rows = 6 * resolution;
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        for (int row = next++; row < rows; row = next++) {
+            const int face = row / resolution;
+            const int j = row % resolution;
+            const double v = (j + 0.5) / resolution * 2.0 - 1.0;
+            float* depths =
+                depth_.data() + face * face_texels + static_cast<size_t>(j) * resolution;
+            for (int i = 0; i < resolution; ++i) {
+                const double u = (i + 0.5) / resolution * 2.0 - 1.0;
+                depths[i] = static_cast<float>(cast(Ray(center, unproject(face, u, v))));
+            }
+        }
+    };
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::future<void>> helpers;
+    for (unsigned i = 1; i < std::min<unsigned>(cores, static_cast<unsigned>(rows)); ++i) {
+        helpers.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& helper : helpers) {
+        helper.get();
+    }
+}
+
+int ShadowCubemap::project(const Vector3& direction, double& u, double& v) {
+    const double ax = std::abs(direction.x);
+    const double ay = std::abs(direction.y);
+    const double az = std::abs(direction.z);
+    if (ax >= ay && ax >= az) {
+        u = (direction.x > 0 ? -direction.z : direction.z) / ax;
+        v = direction.y / ax;
+        return direction.x > 0 ? 0 : 1;
+    }
+    if (ay >= az) {
+        u = direction.x / ay;
+        v = (direction.y > 0 ? -direction.z : direction.z) / ay;
+        return direction.y > 0 ? 2 : 3;
+    }
+    u = (direction.z > 0 ? direction.x : -direction.x) / az;
+    v = direction.y / az;
+    return direction.z > 0 ? 4 : 5;
+}
+
+Vector3 ShadowCubemap::unproject(int face, double u, double v) {
+    switch (face) {
+        case 0:
+            return Vector3(1, v, -u).normalize();
+        case 1:
+            return Vector3(-1, v, u).normalize();
+        case 2:
+            return Vector3(u, 1, -v).normalize();
+        case 3:
+            return Vector3(u, -1, v).normalize();
+        case 4:
+            return Vector3(u, v, 1).normalize();
+        default:
+            return Vector3(-u, v, -1).normalize();
+    }
+}
+
+double ShadowCubemap::visibility(const Point3& p, const Vector3& normal, double bias,
+                                 int filter) const {
+    const Vector3 to_point = p - center_;
+    const double distance = to_point.magnitude();
+    if (distance == 0.0) {
+        return 1.0;
+    }
+    double u;
+    double v;
+    const int face = project(to_point, u, v);
+    auto texel = [&](double coordinate) {
+        return std::clamp(static_cast<int>((coordinate + 1.0) * 0.5 * resolution_), 0,
+                          resolution_ - 1);
+    };
+    const int ci = texel(u);
+    const int cj = texel(v);
+
+    // The surface seen through a neighbouring texel can be closer by about the tangent of the
+    // light's incidence times one texel's footprint, for each texel of offset
+    filter = std::max(filter, 0);
+    const double cosine = std::abs(normal.dot(to_point)) / distance;
+    const double slope = std::min(std::sqrt(std::max(1.0 - cosine * cosine, 0.0)) /
+                                      std::max(cosine, 1e-6),
+                                  kMaxSlope);
+    const double tolerance = distance * (bias + 2.0 * (filter + 1) / resolution_ * (1.0 + slope));
+    const float* depths = depth_.data() + static_cast<size_t>(face) * resolution_ * resolution_;
+    int lit = 0;
+    int taps = 0;
+    for (int j = std::max(cj - filter, 0); j <= std::min(cj + filter, resolution_ - 1); ++j) {
+        for (int i = std::max(ci - filter, 0); i <= std::min(ci + filter, resolution_ - 1); ++i) {
+            if (distance <= depths[static_cast<size_t>(j) * resolution_ + i] + tolerance) {
+                lit++;
+            }
+            taps++;
+        }
+    }
+    return static_cast<double>(lit) / taps;
+}
+
+ShadowMaps ShadowMapCache::prepare(const std::vector<std::unique_ptr<Light>>& lights,
+                                   const ShadowMapSettings& settings, uint64_t geometry_version,
+                                   const std::function<double(const Ray&)>& cast) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (geometry_version != geometry_version_) {
+        maps_.clear();
+        geometry_version_ = geometry_version;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t built = 0;
+    ShadowMaps maps;
+    for (const auto& light : lights) {
+        if (light->isArea()) {
+            continue;
+        }
+        std::shared_ptr<const ShadowCubemap>& cached = maps_[light.get()];
+        if (!cached || cached->resolution() != settings.resolution ||
+            !(cached->center() == light->position)) {
+            cached = std::make_shared<const ShadowCubemap>(light->position, settings.resolution,
+                                                           cast);
+            built++;
+        }
+        maps.emplace(light.get(), cached);
+    }
+
+    if (built > 0) {
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::ostringstream report;
+        report << "Shadow maps: " << built << " built in " << elapsed.count() << " ms, "
+               << maps.size() - built << " reused (" << settings.resolution << "x"
+               << settings.resolution << " per face)";
+        Style::logInfo(report.str());
+    }
+    return maps;
+}
+
+size_t ShadowMapCache::memoryBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t bytes = 0;
+    for (const auto& entry : maps_) {
+        bytes += sizeof(ShadowCubemap) + entry.second->memoryBytes();
+    }
+    return bytes;
+}
+
+} // namespace Prism
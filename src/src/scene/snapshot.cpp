@@ -0,0 +1,873 @@
+#include "Prism/scene/scene.hpp"
+
+#include "Prism/core/material.hpp"
+#include "Prism/core/matrix.hpp"
+#include "Prism/core/style.hpp"
+#include "Prism/objects/mesh.hpp"
+#include "Prism/objects/mesh_proxy.hpp"
+#include "Prism/objects/out_of_core_mesh.hpp"
+#include "Prism/objects/plane.hpp"
+#include "Prism/objects/sphere.hpp"
+#include "Prism/objects/triangle.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Prism {
+
+namespace {
+
+// --- On-disk layout ---
+//
+// [SnapshotHeader][materials][lights][objects][meshes][vertices][normals][faces]
+// [cameras][regions][camera keys][tracks][transform keys][text]
+//
+// Every record is a fixed-size POD made of 8-byte fields (or pairs of 4-byte fields), and every
+// section starts at an 8-byte aligned offset, so a memory-mapped file can be read in place.
+// Strings (file paths and camera names) are slices of the text section, which is padded to a
+// multiple of 8 bytes. Out-of-core meshes are stored by the path of their backing file, which
+// must still exist when the snapshot is loaded. Animation tracks refer to a slice of the pooled
+// transform keys, as meshes do to the pooled geometry.
+
+constexpr char kSnapshotMagic[8] = {'P', 'R', 'S', 'M', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kSnapshotVersion = 8;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint32_t kNoMaterial = 0xFFFFFFFF;
+
+enum class SnapshotObjectType : uint32_t {
+    Sphere = 1,
+    Plane = 2,
+    Triangle = 3,
+    Mesh = 4,
+    OutOfCoreMesh = 5
+};
+
+struct SnapshotSection {
+    uint64_t offset; ///< Byte offset of the first record from the start of the file
+    uint64_t count;  ///< Number of records in the section
+};
+
+struct CameraRecord {
+    double position[3];
+    double target[3];
+    double up[3];
+    double screen_distance;
+    double viewport_height;
+    double viewport_width;
+    int32_t image_height;
+    int32_t image_width;
+};
+
+struct StringRecord {
+    uint64_t offset; ///< Byte offset of the first character in the text section
+    uint64_t length; ///< Number of characters
+};
+
+// RenderSettings, with booleans and enumerations widened to 64 bits
+struct SettingsRecord {
+    int64_t max_depth;
+    int64_t min_samples;
+    int64_t max_samples;
+    double variance_threshold;
+    double contrast_threshold;
+    uint64_t seed;
+    double min_contribution;
+    int64_t russian_roulette;
+    double roulette_threshold;
+    int64_t recursive_trace;
+    int64_t light_selection; ///< A LightSelection
+    double light_threshold;
+    int64_t light_samples;
+    int64_t shadow_min_samples;
+    int64_t shadow_max_samples;
+    int64_t shadow_maps;
+    int64_t shadow_map_resolution;
+    double shadow_map_bias;
+    int64_t shadow_map_filter;
+    int64_t tile_size;
+    int64_t denoise;
+    int64_t denoise_levels;
+    double denoise_color_sigma;
+    double denoise_normal_sigma;
+    double denoise_depth_sigma;
+    double denoise_albedo_sigma;
+    double resolution_scale;
+    int64_t crop;
+    StringRecord composite;
+    int64_t progressive;
+    double progressive_interval;
+    StringRecord progressive_preview;
+    int64_t integrator; ///< An Integrator
+    double depth_scale;
+    int64_t aov_depth;
+    int64_t aov_normal;
+    int64_t aov_albedo;
+    int64_t aov_object_id;
+    int64_t aov_material_id;
+    StringRecord aov_file;
+    int64_t threads;
+    StringRecord checkpoint_file;
+    double checkpoint_interval;
+    double deadline;
+    int64_t rasterize;
+};
+
+struct NamedCameraRecord {
+    CameraRecord camera;
+    StringRecord name;
+};
+
+struct RegionRecord {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+};
+
+struct CameraKeyRecord {
+    double frame;
+    double lookfrom[3];
+    double lookat[3];
+};
+
+struct TrackRecord {
+    uint64_t object; ///< Index of the keyed object
+    double base[16]; ///< Transformation of the object in the scene file
+    uint64_t first_key;
+    uint64_t key_count;
+};
+
+struct TransformKeyRecord {
+    double frame;
+    double translation[3];
+    double axis[3];
+    double angle;
+    double scale[3];
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    CameraRecord camera;
+    SettingsRecord settings;
+    double ambient[3];
+    uint64_t memory_budget; ///< Bytes, 0 if unlimited
+    int64_t frame_count;    ///< Frames of the animation, 0 if none
+    SnapshotSection materials;
+    SnapshotSection lights;
+    SnapshotSection objects;
+    SnapshotSection meshes;
+    SnapshotSection vertices;
+    SnapshotSection normals;
+    SnapshotSection faces;
+    SnapshotSection cameras; ///< Named cameras
+    SnapshotSection regions; ///< Render regions of the settings
+    SnapshotSection camera_keys;
+    SnapshotSection tracks;
+    SnapshotSection transform_keys;
+    SnapshotSection text; ///< Characters of the strings, counted in bytes
+};
+
+struct MaterialRecord {
+    double color[3];
+    double ka[3];
+    double ks[3];
+    double ke[3];
+    double ns;
+    double ni;
+    double d;
+};
+
+struct LightRecord {
+    double position[3];
+    double color[3];
+    double radius;
+    uint32_t shape;       ///< A LightShape
+    uint32_t padding;
+    double edge_u[3];     ///< Rectangle lights
+    double edge_v[3];     ///< Rectangle lights
+    double sphere_radius; ///< Sphere lights
+};
+
+struct ObjectRecord {
+    uint32_t type;     ///< A SnapshotObjectType
+    uint32_t material; ///< Index into the material table, or kNoMaterial
+    uint64_t mesh;     ///< Index into the mesh table (meshes only)
+    uint64_t levels;   ///< Simplified levels of detail, in the mesh records after `mesh`
+    double params[9];  ///< Sphere: center, radius. Plane: point, normal. Triangle: vertices.
+                       ///< Mesh: LodSettings::triangle_pixels.
+    double transform[16];
+    double inverse[16];
+    StringRecord file; ///< Backing file (out-of-core meshes only)
+};
+
+struct MeshRecord {
+    uint64_t first_vertex;
+    uint64_t vertex_count;
+    uint64_t first_normal;
+    uint64_t normal_count;
+    uint64_t first_face;
+    uint64_t face_count;
+};
+
+struct FaceRecord {
+    uint32_t vertex[3];
+    uint32_t normal[3];
+};
+
+struct Vec3Record {
+    double v[3];
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "Snapshot records must be POD");
+static_assert(sizeof(CameraRecord) % 8 == 0 && sizeof(SnapshotHeader) % 8 == 0 &&
+                  sizeof(MaterialRecord) % 8 == 0 && sizeof(LightRecord) % 8 == 0 &&
+                  sizeof(ObjectRecord) % 8 == 0 && sizeof(MeshRecord) % 8 == 0 &&
+                  sizeof(FaceRecord) % 8 == 0 && sizeof(Vec3Record) % 8 == 0 &&
+                  sizeof(SettingsRecord) % 8 == 0 && sizeof(RegionRecord) % 8 == 0 &&
+                  sizeof(NamedCameraRecord) % 8 == 0 && sizeof(CameraKeyRecord) % 8 == 0 &&
+                  sizeof(TrackRecord) % 8 == 0 && sizeof(TransformKeyRecord) % 8 == 0,
+              "Snapshot records must keep 8-byte alignment");
+
+// --- Conversion helpers ---
+
+void store(double out[3], const Point3& p) {
+    out[0] = p.x;
+    out[1] = p.y;
+    out[2] = p.z;
+}
+
+void store(double out[3], const Vector3& v) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+void store(double out[3], const Color& c) {
+    out[0] = c.r;
+    out[1] = c.g;
+    out[2] = c.b;
+}
+
+void store(double out[16], const Matrix& m) {
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            out[i * 4 + j] = m[i][j];
+        }
+    }
+}
+
+Matrix loadMatrix(const double in[16]) {
+    Matrix m(4, 4);
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            m[i][j] = in[i * 4 + j];
+        }
+    }
+    return m;
+}
+
+Color loadColor(const double in[3]) {
+    return Color(in[0], in[1], in[2]);
+}
+
+Point3 loadPoint(const double in[3]) {
+    return Point3(in[0], in[1], in[2]);
+}
+
+Vector3 loadVector(const double in[3]) {
+    return Vector3(in[0], in[1], in[2]);
+}
+
+template <typename T> void appendSection(std::vector<char>& out, const std::vector<T>& records) {
+    const char* bytes = reinterpret_cast<const char*>(records.data());
+    out.insert(out.end(), bytes, bytes + records.size() * sizeof(T));
+}
+
+// Returns a pointer to the records of a section after validating it against the buffer bounds.
+template <typename T>
+const T* sectionData(const std::vector<char>& buffer, const SnapshotSection& section) {
+    if (section.offset % alignof(T) != 0 || section.offset > buffer.size() ||
+        section.count > (buffer.size() - section.offset) / sizeof(T)) {
+        throw std::runtime_error("Snapshot file is corrupted: section out of bounds.");
+    }
+    return reinterpret_cast<const T*>(buffer.data() + section.offset);
+}
+
+void store(CameraRecord& rec, const Camera& camera) {
+    store(rec.position, camera.pos);
+    store(rec.target, camera.aim);
+    store(rec.up, camera.up);
+    rec.screen_distance = camera.screen_distance;
+    rec.viewport_height = camera.screen_height;
+    rec.viewport_width = camera.screen_width;
+    rec.image_height = camera.pixel_height;
+    rec.image_width = camera.pixel_width;
+}
+
+Camera loadCamera(const CameraRecord& rec) {
+    return Camera(Point3(rec.position[0], rec.position[1], rec.position[2]),
+                  Point3(rec.target[0], rec.target[1], rec.target[2]),
+                  Vector3(rec.up[0], rec.up[1], rec.up[2]), rec.screen_distance,
+                  rec.viewport_height, rec.viewport_width, rec.image_height, rec.image_width);
+}
+
+// Appends a string to the text section
+StringRecord storeString(std::vector<char>& text, const std::string& value) {
+    StringRecord rec{text.size(), value.size()};
+    text.insert(text.end(), value.begin(), value.end());
+    return rec;
+}
+
+std::string loadString(const std::vector<char>& text, const StringRecord& rec) {
+    if (rec.offset > text.size() || rec.length > text.size() - rec.offset) {
+        throw std::runtime_error("Snapshot file is corrupted: string out of bounds.");
+    }
+    return std::string(text.data() + rec.offset, rec.length);
+}
+
+void storeSettings(const RenderSettings& settings, SettingsRecord& rec,
+                   std::vector<RegionRecord>& regions, std::vector<char>& text) {
+    rec.max_depth = settings.max_depth;
+    rec.min_samples = settings.sampling.min_samples;
+    rec.max_samples = settings.sampling.max_samples;
+    rec.variance_threshold = settings.sampling.variance_threshold;
+    rec.contrast_threshold = settings.sampling.contrast_threshold;
+    rec.seed = settings.seed;
+    rec.min_contribution = settings.min_contribution;
+    rec.russian_roulette = settings.russian_roulette;
+    rec.roulette_threshold = settings.roulette_threshold;
+    rec.recursive_trace = settings.recursive_trace;
+    rec.light_selection = static_cast<int64_t>(settings.lights.selection);
+    rec.light_threshold = settings.lights.threshold;
+    rec.light_samples = settings.lights.samples;
+    rec.shadow_min_samples = settings.shadows.min_samples;
+    rec.shadow_max_samples = settings.shadows.max_samples;
+    rec.shadow_maps = settings.shadow_maps.enabled;
+    rec.shadow_map_resolution = settings.shadow_maps.resolution;
+    rec.shadow_map_bias = settings.shadow_maps.bias;
+    rec.shadow_map_filter = settings.shadow_maps.filter;
+    rec.tile_size = settings.tile_size;
+    rec.denoise = settings.denoise.enabled;
+    rec.denoise_levels = settings.denoise.levels;
+    rec.denoise_color_sigma = settings.denoise.color_sigma;
+    rec.denoise_normal_sigma = settings.denoise.normal_sigma;
+    rec.denoise_depth_sigma = settings.denoise.depth_sigma;
+    rec.denoise_albedo_sigma = settings.denoise.albedo_sigma;
+    rec.resolution_scale = settings.resolution_scale;
+    rec.crop = settings.crop;
+    rec.composite = storeString(text, settings.composite.string());
+    rec.progressive = settings.progressive.enabled;
+    rec.progressive_interval = settings.progressive.interval;
+    rec.progressive_preview = storeString(text, settings.progressive.preview.string());
+    rec.integrator = static_cast<int64_t>(settings.integrator);
+    rec.depth_scale = settings.depth_scale;
+    rec.aov_depth = settings.aovs.depth;
+    rec.aov_normal = settings.aovs.normal;
+    rec.aov_albedo = settings.aovs.albedo;
+    rec.aov_object_id = settings.aovs.object_id;
+    rec.aov_material_id = settings.aovs.material_id;
+    rec.aov_file = storeString(text, settings.aovs.file.string());
+    rec.threads = settings.threads;
+    rec.checkpoint_file = storeString(text, settings.checkpoint.file.string());
+    rec.checkpoint_interval = settings.checkpoint.interval;
+    rec.deadline = settings.deadline;
+    rec.rasterize = settings.rasterize;
+    for (const ImageRegion& region : settings.regions) {
+        regions.push_back({region.x, region.y, region.width, region.height});
+    }
+}
+
+RenderSettings loadSettings(const SettingsRecord& rec, const RegionRecord* regions,
+                            uint64_t region_count, const std::vector<char>& text) {
+    if (rec.light_selection < 0 ||
+        rec.light_selection > static_cast<int64_t>(LightSelection::Sample) ||
+        rec.integrator < 0 || rec.integrator > static_cast<int64_t>(Integrator::Direct)) {
+        throw std::runtime_error("Snapshot file is corrupted: unknown render setting.");
+    }
+    RenderSettings settings;
+    settings.max_depth = static_cast<int>(rec.max_depth);
+    settings.sampling.min_samples = static_cast<int>(rec.min_samples);
+    settings.sampling.max_samples = static_cast<int>(rec.max_samples);
+    settings.sampling.variance_threshold = rec.variance_threshold;
+    settings.sampling.contrast_threshold = rec.contrast_threshold;
+    settings.seed = rec.seed;
+    settings.min_contribution = rec.min_contribution;
+    settings.russian_roulette = rec.russian_roulette != 0;
+    settings.roulette_threshold = rec.roulette_threshold;
+    settings.recursive_trace = rec.recursive_trace != 0;
+    settings.lights.selection = static_cast<LightSelection>(rec.light_selection);
+    settings.lights.threshold = rec.light_threshold;
+    settings.lights.samples = static_cast<int>(rec.light_samples);
+    settings.shadows.min_samples = static_cast<int>(rec.shadow_min_samples);
+    settings.shadows.max_samples = static_cast<int>(rec.shadow_max_samples);
+    settings.shadow_maps.enabled = rec.shadow_maps != 0;
+    settings.shadow_maps.resolution = static_cast<int>(rec.shadow_map_resolution);
+    settings.shadow_maps.bias = rec.shadow_map_bias;
+    settings.shadow_maps.filter = static_cast<int>(rec.shadow_map_filter);
+    settings.tile_size = static_cast<int>(rec.tile_size);
+    settings.denoise.enabled = rec.denoise != 0;
+    settings.denoise.levels = static_cast<int>(rec.denoise_levels);
+    settings.denoise.color_sigma = rec.denoise_color_sigma;
+    settings.denoise.normal_sigma = rec.denoise_normal_sigma;
+    settings.denoise.depth_sigma = rec.denoise_depth_sigma;
+    settings.denoise.albedo_sigma = rec.denoise_albedo_sigma;
+    settings.resolution_scale = rec.resolution_scale;
+    settings.crop = rec.crop != 0;
+    settings.composite = loadString(text, rec.composite);
+    settings.progressive.enabled = rec.progressive != 0;
+    settings.progressive.interval = rec.progressive_interval;
+    settings.progressive.preview = loadString(text, rec.progressive_preview);
+    settings.integrator = static_cast<Integrator>(rec.integrator);
+    settings.depth_scale = rec.depth_scale;
+    settings.aovs.depth = rec.aov_depth != 0;
+    settings.aovs.normal = rec.aov_normal != 0;
+    settings.aovs.albedo = rec.aov_albedo != 0;
+    settings.aovs.object_id = rec.aov_object_id != 0;
+    settings.aovs.material_id = rec.aov_material_id != 0;
+    settings.aovs.file = loadString(text, rec.aov_file);
+    settings.threads = static_cast<int>(rec.threads);
+    settings.checkpoint.file = loadString(text, rec.checkpoint_file);
+    settings.checkpoint.interval = rec.checkpoint_interval;
+    settings.deadline = rec.deadline;
+    settings.rasterize = rec.rasterize != 0;
+    for (uint64_t i = 0; i < region_count; ++i) {
+        settings.regions.push_back(
+            ImageRegion{regions[i].x, regions[i].y, regions[i].width, regions[i].height});
+    }
+    return settings;
+}
+
+// Gets the geometry of meshes and mesh proxies. Snapshots hold the committed scene, so proxies
+// are loaded and stored as regular meshes.
+const Mesh* meshOf(const Object& object) {
+    if (auto proxy = dynamic_cast<const MeshProxy*>(&object)) {
+        return &proxy->geometry();
+    }
+    return dynamic_cast<const Mesh*>(&object);
+}
+
+} // namespace
+
+void Scene::save_snapshot(const std::filesystem::path& path) const {
+    std::vector<MaterialRecord> materials;
+    std::vector<LightRecord> lights;
+    std::vector<ObjectRecord> objects;
+    std::vector<MeshRecord> meshes;
+    std::vector<Vec3Record> vertices;
+    std::vector<Vec3Record> normals;
+    std::vector<FaceRecord> faces;
+    std::vector<NamedCameraRecord> cameras;
+    std::vector<RegionRecord> regions;
+    std::vector<CameraKeyRecord> camera_keys;
+    std::vector<TrackRecord> tracks;
+    std::vector<TransformKeyRecord> transform_keys;
+    std::vector<char> text;
+
+    // Materials are shared between objects, so they are stored once in a table
+    std::map<const Material*, uint32_t> material_index;
+    auto materialIndex = [&](const std::shared_ptr<Material>& mat) {
+        if (!mat) {
+            return kNoMaterial;
+        }
+        auto it = material_index.find(mat.get());
+        if (it != material_index.end()) {
+            return it->second;
+        }
+        MaterialRecord rec;
+        store(rec.color, mat->color);
+        store(rec.ka, mat->ka);
+        store(rec.ks, mat->ks);
+        store(rec.ke, mat->ke);
+        rec.ns = mat->ns;
+        rec.ni = mat->ni;
+        rec.d = mat->d;
+        materials.push_back(rec);
+        uint32_t index = static_cast<uint32_t>(materials.size() - 1);
+        material_index[mat.get()] = index;
+        return index;
+    };
+
+    // Appends the geometry of a mesh or of one of its levels of detail to the pools
+    auto storeGeometry = [&](const std::vector<Point3>& points,
+                             const std::vector<Vector3>& point_normals,
+                             const std::vector<ObjReader::FaceIndices>& triangles) {
+        meshes.push_back(MeshRecord{vertices.size(), points.size(), normals.size(),
+                                    point_normals.size(), faces.size(), triangles.size()});
+        for (const auto& p : points) {
+            vertices.push_back({{p.x, p.y, p.z}});
+        }
+        for (const auto& n : point_normals) {
+            normals.push_back({{n.x, n.y, n.z}});
+        }
+        for (const auto& face : triangles) {
+            FaceRecord face_rec;
+            for (int i = 0; i < 3; ++i) {
+                face_rec.vertex[i] = face.vertex_indices[i];
+                face_rec.normal[i] = face.normal_indices[i];
+            }
+            faces.push_back(face_rec);
+        }
+    };
+
+    for (const auto& light : lights_) {
+        LightRecord rec;
+        store(rec.position, light->position);
+        store(rec.color, light->color);
+        rec.radius = light->radius;
+        rec.shape = static_cast<uint32_t>(light->shape);
+        rec.padding = 0;
+        store(rec.edge_u, light->edge_u);
+        store(rec.edge_v, light->edge_v);
+        rec.sphere_radius = light->sphere_radius;
+        lights.push_back(rec);
+    }
+
+    objects.reserve(objects_.size());
+    for (const auto& object : objects_) {
+        ObjectRecord rec{};
+        store(rec.transform, object->getTransform());
+        store(rec.inverse, object->getInverseTransform());
+
+        if (auto sphere = dynamic_cast<const Sphere*>(object.get())) {
+            rec.type = static_cast<uint32_t>(SnapshotObjectType::Sphere);
+            rec.material = materialIndex(sphere->getMaterial());
+            store(rec.params, sphere->getCenter());
+            rec.params[3] = sphere->getRadius();
+        } else if (auto plane = dynamic_cast<const Plane*>(object.get())) {
+            rec.type = static_cast<uint32_t>(SnapshotObjectType::Plane);
+            rec.material = materialIndex(plane->getMaterial());
+            store(rec.params, plane->getPoint());
+            store(rec.params + 3, plane->getNormal());
+        } else if (auto triangle = dynamic_cast<const Triangle*>(object.get())) {
+            rec.type = static_cast<uint32_t>(SnapshotObjectType::Triangle);
+            rec.material = materialIndex(triangle->getMaterial());
+            store(rec.params, triangle->getPoint1());
+            store(rec.params + 3, triangle->getPoint2());
+            store(rec.params + 6, triangle->getPoint3());
+        } else if (auto clustered = dynamic_cast<const OutOfCoreMesh*>(object.get())) {
+            rec.type = static_cast<uint32_t>(SnapshotObjectType::OutOfCoreMesh);
+            rec.material = materialIndex(clustered->getMaterial());
+            rec.file =
+                storeString(text, std::filesystem::absolute(clustered->getBackingPath()).string());
+        } else if (const Mesh* mesh = meshOf(*object)) {
+            rec.type = static_cast<uint32_t>(SnapshotObjectType::Mesh);
+            rec.material = materialIndex(mesh->getMaterial());
+            rec.mesh = meshes.size();
+            rec.levels = mesh->levelCount() - 1;
+            rec.params[0] = mesh->getLodSettings().triangle_pixels;
+            storeGeometry(mesh->getVertices(), mesh->getNormals(), mesh->getFaces());
+            for (size_t level = 1; level < mesh->levelCount(); ++level) {
+                const MeshLevel& detail = mesh->getLevel(level);
+                storeGeometry(detail.vertices, detail.normals, detail.faces);
+            }
+        } else {
+            throw std::runtime_error("Cannot snapshot the scene: unsupported object type.");
+        }
+        objects.push_back(rec);
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.byte_order = kByteOrderMark;
+    store(header.camera, camera_);
+    store(header.ambient, ambient_color_);
+    storeSettings(settings_, header.settings, regions, text);
+    for (const auto& [name, camera] : cameras_) {
+        NamedCameraRecord rec{};
+        store(rec.camera, camera);
+        rec.name = storeString(text, name);
+        cameras.push_back(rec);
+    }
+    header.memory_budget = memory_budget_;
+    header.frame_count = animation_.frameCount();
+    for (const CameraKey& key : animation_.cameraKeys()) {
+        CameraKeyRecord rec;
+        rec.frame = key.frame;
+        store(rec.lookfrom, key.lookfrom);
+        store(rec.lookat, key.lookat);
+        camera_keys.push_back(rec);
+    }
+    for (const Animation::Track& track : animation_.tracks()) {
+        TrackRecord rec;
+        rec.object = track.object;
+        store(rec.base, track.base);
+        rec.first_key = transform_keys.size();
+        rec.key_count = track.keys.size();
+        tracks.push_back(rec);
+        for (const TransformKey& key : track.keys) {
+            TransformKeyRecord key_rec;
+            key_rec.frame = key.frame;
+            store(key_rec.translation, key.translation);
+            store(key_rec.axis, key.axis);
+            key_rec.angle = key.angle;
+            store(key_rec.scale, key.scale);
+            transform_keys.push_back(key_rec);
+        }
+    }
+    text.resize((text.size() + 7) / 8 * 8, '\0');
+
+    uint64_t offset = sizeof(SnapshotHeader);
+    auto place = [&offset](SnapshotSection& section, size_t count, size_t record_size) {
+        section.offset = offset;
+        section.count = count;
+        offset += count * record_size;
+    };
+    place(header.materials, materials.size(), sizeof(MaterialRecord));
+    place(header.lights, lights.size(), sizeof(LightRecord));
+    place(header.objects, objects.size(), sizeof(ObjectRecord));
+    place(header.meshes, meshes.size(), sizeof(MeshRecord));
+    place(header.vertices, vertices.size(), sizeof(Vec3Record));
+    place(header.normals, normals.size(), sizeof(Vec3Record));
+    place(header.faces, faces.size(), sizeof(FaceRecord));
+    place(header.cameras, cameras.size(), sizeof(NamedCameraRecord));
+    place(header.regions, regions.size(), sizeof(RegionRecord));
+    place(header.camera_keys, camera_keys.size(), sizeof(CameraKeyRecord));
+    place(header.tracks, tracks.size(), sizeof(TrackRecord));
+    place(header.transform_keys, transform_keys.size(), sizeof(TransformKeyRecord));
+    place(header.text, text.size(), sizeof(char));
+    header.file_size = offset;
+
+    std::vector<char> buffer;
+    buffer.reserve(offset);
+    const char* header_bytes = reinterpret_cast<const char*>(&header);
+    buffer.insert(buffer.end(), header_bytes, header_bytes + sizeof(header));
+    appendSection(buffer, materials);
+    appendSection(buffer, lights);
+    appendSection(buffer, objects);
+    appendSection(buffer, meshes);
+    appendSection(buffer, vertices);
+    appendSection(buffer, normals);
+    appendSection(buffer, faces);
+    appendSection(buffer, cameras);
+    appendSection(buffer, regions);
+    appendSection(buffer, camera_keys);
+    appendSection(buffer, tracks);
+    appendSection(buffer, transform_keys);
+    appendSection(buffer, text);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open snapshot file for writing: " + path.string());
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        throw std::runtime_error("Could not write snapshot file: " + path.string());
+    }
+
+    Style::logDone("Scene snapshot saved as: " + Style::CYAN + path.string());
+}
+
+Scene Scene::load_snapshot(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open snapshot file: " + path.string());
+    }
+    std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        throw std::runtime_error("Could not read snapshot file: " + path.string());
+    }
+
+    if (buffer.size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("Snapshot file is truncated: " + path.string());
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        throw std::runtime_error("Not a Prism scene snapshot: " + path.string());
+    }
+    if (header.version != kSnapshotVersion || header.byte_order != kByteOrderMark) {
+        throw std::runtime_error("Incompatible scene snapshot version or byte order: " +
+                                 path.string());
+    }
+    if (header.file_size != buffer.size()) {
+        throw std::runtime_error("Snapshot file is truncated: " + path.string());
+    }
+
+    Style::logInfo("Loading scene snapshot: " + Style::CYAN + path.string());
+
+    Scene scene(loadCamera(header.camera), loadColor(header.ambient));
+    scene.setMemoryBudget(static_cast<size_t>(header.memory_budget));
+
+    const char* text_data = sectionData<char>(buffer, header.text);
+    const std::vector<char> text(text_data, text_data + header.text.count);
+    const RegionRecord* region_recs = sectionData<RegionRecord>(buffer, header.regions);
+    scene.setRenderSettings(loadSettings(header.settings, region_recs, header.regions.count, text));
+    const NamedCameraRecord* camera_recs = sectionData<NamedCameraRecord>(buffer, header.cameras);
+    for (uint64_t i = 0; i < header.cameras.count; ++i) {
+        scene.addCamera(loadString(text, camera_recs[i].name), loadCamera(camera_recs[i].camera));
+    }
+
+    const MaterialRecord* material_recs = sectionData<MaterialRecord>(buffer, header.materials);
+    std::vector<std::shared_ptr<Material>> materials;
+    materials.reserve(header.materials.count);
+    for (uint64_t i = 0; i < header.materials.count; ++i) {
+        const MaterialRecord& rec = material_recs[i];
+        materials.push_back(std::make_shared<Material>(loadColor(rec.color), loadColor(rec.ka),
+                                                       loadColor(rec.ks), loadColor(rec.ke),
+                                                       rec.ns, rec.ni, rec.d));
+    }
+    auto material = [&materials](uint32_t index) -> std::shared_ptr<Material> {
+        if (index == kNoMaterial) {
+            return nullptr;
+        }
+        if (index >= materials.size()) {
+            throw std::runtime_error("Snapshot file is corrupted: bad material index.");
+        }
+        return materials[index];
+    };
+
+    const LightRecord* light_recs = sectionData<LightRecord>(buffer, header.lights);
+    for (uint64_t i = 0; i < header.lights.count; ++i) {
+        const LightRecord& rec = light_recs[i];
+        if (rec.shape > static_cast<uint32_t>(LightShape::Sphere)) {
+            throw std::runtime_error("Snapshot file is corrupted: unknown light shape.");
+        }
+        auto light = std::make_unique<Light>(
+            Point3(rec.position[0], rec.position[1], rec.position[2]), loadColor(rec.color),
+            rec.radius);
+        light->shape = static_cast<LightShape>(rec.shape);
+        light->edge_u = Vector3(rec.edge_u[0], rec.edge_u[1], rec.edge_u[2]);
+        light->edge_v = Vector3(rec.edge_v[0], rec.edge_v[1], rec.edge_v[2]);
+        light->sphere_radius = rec.sphere_radius;
+        scene.addLight(std::move(light));
+    }
+
+    const ObjectRecord* object_recs = sectionData<ObjectRecord>(buffer, header.objects);
+    const MeshRecord* mesh_recs = sectionData<MeshRecord>(buffer, header.meshes);
+    const Vec3Record* vertex_recs = sectionData<Vec3Record>(buffer, header.vertices);
+    const Vec3Record* normal_recs = sectionData<Vec3Record>(buffer, header.normals);
+    const FaceRecord* face_recs = sectionData<FaceRecord>(buffer, header.faces);
+
+    // Reads the geometry of a mesh or of one of its levels of detail from the pools
+    auto loadGeometry = [&](const MeshRecord& mesh) {
+        if (mesh.first_vertex + mesh.vertex_count > header.vertices.count ||
+            mesh.first_normal + mesh.normal_count > header.normals.count ||
+            mesh.first_face + mesh.face_count > header.faces.count) {
+            throw std::runtime_error("Snapshot file is corrupted: bad mesh range.");
+        }
+        MeshLevel geometry;
+        geometry.vertices.reserve(mesh.vertex_count);
+        for (uint64_t v = 0; v < mesh.vertex_count; ++v) {
+            const double* xyz = vertex_recs[mesh.first_vertex + v].v;
+            geometry.vertices.emplace_back(xyz[0], xyz[1], xyz[2]);
+        }
+        geometry.normals.reserve(mesh.normal_count);
+        for (uint64_t n = 0; n < mesh.normal_count; ++n) {
+            const double* xyz = normal_recs[mesh.first_normal + n].v;
+            geometry.normals.emplace_back(xyz[0], xyz[1], xyz[2]);
+        }
+        geometry.faces.resize(mesh.face_count);
+        for (uint64_t f = 0; f < mesh.face_count; ++f) {
+            const FaceRecord& face = face_recs[mesh.first_face + f];
+            for (int k = 0; k < 3; ++k) {
+                if (face.vertex[k] >= mesh.vertex_count || face.normal[k] >= mesh.normal_count) {
+                    throw std::runtime_error("Snapshot file is corrupted: bad face index.");
+                }
+                geometry.faces[f].vertex_indices[k] = face.vertex[k];
+                geometry.faces[f].normal_indices[k] = face.normal[k];
+            }
+        }
+        return geometry;
+    };
+
+    scene.reserveObjects(header.objects.count);
+    for (uint64_t i = 0; i < header.objects.count; ++i) {
+        const ObjectRecord& rec = object_recs[i];
+        const double* p = rec.params;
+        std::unique_ptr<Object> object;
+
+        switch (static_cast<SnapshotObjectType>(rec.type)) {
+            case SnapshotObjectType::Sphere:
+                object = std::make_unique<Sphere>(Point3(p[0], p[1], p[2]), p[3],
+                                                  material(rec.material));
+                break;
+            case SnapshotObjectType::Plane:
+                object = std::make_unique<Plane>(Point3(p[0], p[1], p[2]),
+                                                 Vector3(p[3], p[4], p[5]),
+                                                 material(rec.material));
+                break;
+            case SnapshotObjectType::Triangle:
+                object = std::make_unique<Triangle>(Point3(p[0], p[1], p[2]),
+                                                    Point3(p[3], p[4], p[5]),
+                                                    Point3(p[6], p[7], p[8]),
+                                                    material(rec.material));
+                break;
+            case SnapshotObjectType::Mesh: {
+                if (rec.mesh >= header.meshes.count ||
+                    rec.levels >= header.meshes.count - rec.mesh) {
+                    throw std::runtime_error("Snapshot file is corrupted: bad mesh index.");
+                }
+                MeshLevel full = loadGeometry(mesh_recs[rec.mesh]);
+                auto mesh =
+                    std::make_unique<Mesh>(std::move(full.vertices), std::move(full.normals),
+                                           std::move(full.faces), material(rec.material));
+                for (uint64_t level = 1; level <= rec.levels; ++level) {
+                    mesh->addLevel(loadGeometry(mesh_recs[rec.mesh + level]));
+                }
+                mesh->setLodSettings(LodSettings{p[0], -1});
+                object = std::move(mesh);
+                break;
+            }
+            case SnapshotObjectType::OutOfCoreMesh: {
+                auto mesh = std::make_unique<OutOfCoreMesh>(loadString(text, rec.file));
+                mesh->setMaterial(material(rec.material));
+                object = std::move(mesh);
+                break;
+            }
+            default:
+                throw std::runtime_error("Snapshot file is corrupted: unknown object type.");
+        }
+
+        object->setTransform(loadMatrix(rec.transform), loadMatrix(rec.inverse));
+        scene.addObject(std::move(object));
+    }
+
+    Animation animation;
+    animation.setFrameCount(static_cast<int>(header.frame_count));
+    const CameraKeyRecord* camera_key_recs =
+        sectionData<CameraKeyRecord>(buffer, header.camera_keys);
+    if (header.camera_keys.count > 0) {
+        std::vector<CameraKey> keys;
+        for (uint64_t i = 0; i < header.camera_keys.count; ++i) {
+            const CameraKeyRecord& rec = camera_key_recs[i];
+            keys.push_back(CameraKey{rec.frame, loadPoint(rec.lookfrom), loadPoint(rec.lookat)});
+        }
+        animation.setCameraKeys(std::move(keys));
+    }
+    const TrackRecord* track_recs = sectionData<TrackRecord>(buffer, header.tracks);
+    const TransformKeyRecord* transform_key_recs =
+        sectionData<TransformKeyRecord>(buffer, header.transform_keys);
+    for (uint64_t i = 0; i < header.tracks.count; ++i) {
+        const TrackRecord& rec = track_recs[i];
+        if (rec.object >= header.objects.count || rec.key_count == 0 ||
+            rec.first_key > header.transform_keys.count ||
+            rec.key_count > header.transform_keys.count - rec.first_key) {
+            throw std::runtime_error("Snapshot file is corrupted: bad animation track.");
+        }
+        std::vector<TransformKey> keys;
+        for (uint64_t k = rec.first_key; k < rec.first_key + rec.key_count; ++k) {
+            const TransformKeyRecord& key = transform_key_recs[k];
+            keys.push_back(TransformKey{key.frame, loadVector(key.translation),
+                                        loadVector(key.axis), key.angle, loadVector(key.scale)});
+        }
+        animation.addTrack(rec.object, loadMatrix(rec.base), std::move(keys));
+    }
+    scene.setAnimation(animation);
+
+    return scene;
+}
+
+} // namespace Prism
@@ -0,0 +1,199 @@
+#include "Prism/scene/visibility_buffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Prism {
+
+namespace {
+
+// Depth of the near plane that triangles are clipped against. Camera rays start hitting
+// surfaces at a distance of 1e-4, so nothing nearer can be seen anyway.
+constexpr double kNearDepth = 1e-4;
+
+// Pixels by which the coverage of a triangle is widened on every side
+constexpr double kCoverageMargin = 0.01;
+
+// Fraction of the diagonal of its bounding box by which the enclosing triangles of an object may
+// stick out of the box
+constexpr double kEnclosingMargin = 0.02;
+
+} // namespace
+
+VisibilityBuffer::VisibilityBuffer(const Camera& camera, const ImageRegion& region)
+    : camera_(camera), region_(region) {
+    depth_.assign(region.area(), std::numeric_limits<float>::infinity());
+    object_.assign(region.area(), VisibilitySample::kNone);
+    primitive_.assign(region.area(), 0);
+    b1_.assign(region.area(), 0.0f);
+    b2_.assign(region.area(), 0.0f);
+}
+
+bool VisibilityBuffer::add(uint32_t index, const Object& object) {
+    if (covered_.size() <= index) {
+        covered_.resize(static_cast<size_t>(index) + 1, 0);
+    }
+    covered_[index] = 0;
+
+    // From inside, enclosing triangles are behind the surface they stand for
+    const AABB box = object.boundingBox();
+    if (box.distanceTo(camera_.pos) <= kEnclosingMargin * box.diagonal().magnitude()) {
+        auto ignore = [](uint32_t, const Point3&, const Point3&, const Point3&) {};
+        if (object.tessellate(ignore) != Tessellation::Exact) {
+            return false;
+        }
+    }
+
+    const Tessellation tessellation = object.tessellate(
+        [&](uint32_t primitive, const Point3& p1, const Point3& p2, const Point3& p3) {
+            rasterize(index, primitive, p1, p2, p3);
+        });
+    covered_[index] = tessellation != Tessellation::None;
+    return covered_[index];
+}
+
+void VisibilityBuffer::rasterize(uint32_t object, uint32_t primitive, const Point3& p1,
+                                 const Point3& p2, const Point3& p3) {
+    struct Corner {
+        Point3 p;
+        double depth;
+        double b1;
+        double b2;
+    };
+    double x;
+    double y;
+    const Corner corners[3] = {{p1, camera_.project(p1, x, y), 0.0, 0.0},
+                               {p2, camera_.project(p2, x, y), 1.0, 0.0},
+                               {p3, camera_.project(p3, x, y), 0.0, 1.0}};
+
+    // The part of the triangle beyond the near plane: a triangle or a quad
+    Corner clipped[4];
+    int count = 0;
+    for (int i = 0; i < 3; ++i) {
+        const Corner& a = corners[i];
+        const Corner& b = corners[(i + 1) % 3];
+        const bool a_in = a.depth >= kNearDepth;
+        const bool b_in = b.depth >= kNearDepth;
+        if (a_in) {
+            clipped[count++] = a;
+        }
+        if (a_in != b_in) {
+            const double t = (kNearDepth - a.depth) / (b.depth - a.depth);
+            clipped[count++] = {a.p + (b.p - a.p) * t, kNearDepth, a.b1 + (b.b1 - a.b1) * t,
+                                a.b2 + (b.b2 - a.b2) * t};
+        }
+    }
+    if (count < 3) {
+        return;
+    }
+
+    Vertex vertices[4];
+    for (int i = 0; i < count; ++i) {
+        Vertex& vertex = vertices[i];
+        vertex.depth = std::max(camera_.project(clipped[i].p, vertex.x, vertex.y), kNearDepth);
+        vertex.b1 = clipped[i].b1;
+        vertex.b2 = clipped[i].b2;
+    }
+    drawTriangle(object, primitive, vertices[0], vertices[1], vertices[2]);
+    if (count == 4) {
+        drawTriangle(object, primitive, vertices[0], vertices[2], vertices[3]);
+    }
+}
+
+void VisibilityBuffer::drawTriangle(uint32_t object, uint32_t primitive, const Vertex& v0,
+                                    const Vertex& v1, const Vertex& v2) {
+    const double area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (!(std::abs(area) > 1e-12)) {
+        return;
+    }
+    triangles_++;
+
+    // Screen-space barycentric weights w_i = a_i * x + b_i * y + c_i, each 1 at its vertex and 0
+    // on the opposite edge, whatever the winding
+    const Vertex* v[3] = {&v0, &v1, &v2};
+    double a[3];
+    double b[3];
+    double c[3];
+    double margin[3];
+    for (int i = 0; i < 3; ++i) {
+        const Vertex& from = *v[(i + 1) % 3];
+        const Vertex& to = *v[(i + 2) % 3];
+        a[i] = -(to.y - from.y) / area;
+        b[i] = (to.x - from.x) / area;
+        c[i] = -(a[i] * from.x + b[i] * from.y);
+        margin[i] = -kCoverageMargin * std::hypot(a[i], b[i]);
+    }
+
+    // Pixel centers (i + 0.5, j + 0.5) inside the bounding box, within the region
+    const double min_x = std::min({v0.x, v1.x, v2.x}) - 0.5 - kCoverageMargin;
+    const double max_x = std::max({v0.x, v1.x, v2.x}) - 0.5 + kCoverageMargin;
+    const double min_y = std::min({v0.y, v1.y, v2.y}) - 0.5 - kCoverageMargin;
+    const double max_y = std::max({v0.y, v1.y, v2.y}) - 0.5 + kCoverageMargin;
+    auto clampTo = [](double value, int low, int high) {
+        return static_cast<int>(std::clamp(value, low - 1.0, high + 1.0));
+    };
+    const int x_end = region_.x + region_.width;
+    const int y_end = region_.y + region_.height;
+    const int i0 = std::max(region_.x, clampTo(std::ceil(min_x), region_.x, x_end));
+    const int i1 = std::min(x_end - 1, clampTo(std::floor(max_x), region_.x, x_end));
+    const int j0 = std::max(region_.y, clampTo(std::ceil(min_y), region_.y, y_end));
+    const int j1 = std::min(y_end - 1, clampTo(std::floor(max_y), region_.y, y_end));
+    if (i0 > i1 || j0 > j1) {
+        return;
+    }
+
+    // Inverse depth and barycentrics over depth vary linearly across the screen
+    const double iz0 = 1.0 / v0.depth;
+    const double iz1 = 1.0 / v1.depth;
+    const double iz2 = 1.0 / v2.depth;
+    const double q1[3] = {v0.b1 * iz0, v1.b1 * iz1, v2.b1 * iz2};
+    const double q2[3] = {v0.b2 * iz0, v1.b2 * iz1, v2.b2 * iz2};
+
+    // Branch-free over a row, so the compiler can process several pixels per instruction
+    for (int j = j0; j <= j1; ++j) {
+        const double py = j + 0.5;
+        const size_t row = static_cast<size_t>(j - region_.y) * region_.width - region_.x;
+        float* depths = depth_.data() + row;
+        uint32_t* objects = object_.data() + row;
+        uint32_t* primitives = primitive_.data() + row;
+        float* b1s = b1_.data() + row;
+        float* b2s = b2_.data() + row;
+        for (int i = i0; i <= i1; ++i) {
+            const double px = i + 0.5;
+            const double w0 = a[0] * px + b[0] * py + c[0];
+            const double w1 = a[1] * px + b[1] * py + c[1];
+            const double w2 = a[2] * px + b[2] * py + c[2];
+            const double inverse_depth = w0 * iz0 + w1 * iz1 + w2 * iz2;
+            const double depth = 1.0 / inverse_depth;
+            const bool pass = (w0 >= margin[0]) & (w1 >= margin[1]) & (w2 >= margin[2]) &
+                              (inverse_depth > 0.0) & (depth < depths[i]);
+            const double weight1 = (w0 * q1[0] + w1 * q1[1] + w2 * q1[2]) * depth;
+            const double weight2 = (w0 * q2[0] + w1 * q2[1] + w2 * q2[2]) * depth;
+            depths[i] = pass ? static_cast<float>(depth) : depths[i];
+            objects[i] = pass ? object : objects[i];
+            primitives[i] = pass ? primitive : primitives[i];
+            b1s[i] = pass ? static_cast<float>(weight1) : b1s[i];
+            b2s[i] = pass ? static_cast<float>(weight2) : b2s[i];
+        }
+    }
+}
+
+VisibilitySample VisibilityBuffer::at(int x, int y) const {
+    const size_t index = static_cast<size_t>(y - region_.y) * region_.width + (x - region_.x);
+    VisibilitySample sample;
+    sample.object = object_[index];
+    sample.primitive = primitive_[index];
+    sample.b1 = b1_[index];
+    sample.b2 = b2_[index];
+    sample.depth = depth_[index];
+    return sample;
+}
+
+size_t VisibilityBuffer::memoryBytes() const {
+    return depth_.capacity() * sizeof(float) + object_.capacity() * sizeof(uint32_t) +
+           primitive_.capacity() * sizeof(uint32_t) + b1_.capacity() * sizeof(float) +
+           b2_.capacity() * sizeof(float) + covered_.capacity();
+}
+
+} // namespace Prism
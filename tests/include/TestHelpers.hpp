@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
 namespace Prism {
 
 /**
@@ -55,6 +57,58 @@ inline void AssertMatrixAlmostEqual(const Matrix& m1, const Matrix& m2, double e
     }
 }
 
+/**
+ * @brief Asserts that two images have the same size and almost equal pixels.
+ * @param image The image to check.
+ * @param expected The reference image.
+ * @param eps The tolerance of each color channel (default is 0, an exact match).
+ * @note This function reports the first pixel that differs, by its coordinates.
+ */
+inline void AssertImageAlmostEqual(const Framebuffer& image, const Framebuffer& expected,
+                                   double eps = 0.0) {
+    ASSERT_EQ(image.width(), expected.width());
+    ASSERT_EQ(image.height(), expected.height());
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            ASSERT_NEAR(image.at(x, y).r, expected.at(x, y).r, eps) << x << ", " << y;
+            ASSERT_NEAR(image.at(x, y).g, expected.at(x, y).g, eps) << x << ", " << y;
+            ASSERT_NEAR(image.at(x, y).b, expected.at(x, y).b, eps) << x << ", " << y;
+        }
+    }
+}
+
+/**
+ * @brief Builds the shared render test scene: two spheres over a plane, seen from (0, 1, 4) and
+ * lit from (2, 4, 3), so every part of the image has something different in it.
+ * @param size The width and height of the image, in pixels.
+ * @param left The material of the sphere on the left (default is a diffuse red).
+ * @param grey The material of the plane and of the sphere on the right (default is a diffuse
+ * grey).
+ * @param light_radius The radius of the light, or 0 for a point light.
+ */
+inline Scene MakeTwoSpheresScene(int size, std::shared_ptr<Material> left = nullptr,
+                                 std::shared_ptr<Material> grey = nullptr,
+                                 double light_radius = 0.0) {
+    if (!left) {
+        left = std::make_shared<Material>(Color(0.9, 0.2, 0.2), Color(0.0, 0.0, 0.0));
+    }
+    if (!grey) {
+        grey = std::make_shared<Material>(Color(0.6, 0.6, 0.6), Color(0.2, 0.2, 0.2));
+    }
+    Camera camera(Point3(0, 1, 4), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, size, size);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), grey));
+    scene.addObject(std::make_unique<Sphere>(Point3(-0.8, 0, 0), 0.7, left));
+    scene.addObject(std::make_unique<Sphere>(Point3(0.9, 0, -0.5), 0.8, grey));
+    auto light = std::make_unique<Light>(Point3(2, 4, 3), Color(1.0, 1.0, 1.0));
+    if (light_radius > 0.0) {
+        light->shape = LightShape::Sphere;
+        light->sphere_radius = light_radius;
+    }
+    scene.addLight(std::move(light));
+    return scene;
+}
+
 } // namespace Prism
 
 #endif // TESTS_TESTHELPERS_HPP
\ No newline at end of file
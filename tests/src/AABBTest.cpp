@@ -0,0 +1,71 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace Prism;
+
+TEST(AABBTest, DefaultIsEmptyAndExpands) {
+    AABB box;
+    EXPECT_TRUE(box.isEmpty());
+
+    box.expand(Point3(1, 2, 3));
+    box.expand(Point3(-1, 0, 5));
+
+    EXPECT_FALSE(box.isEmpty());
+    EXPECT_TRUE(box.isFinite());
+    AssertPointAlmostEqual(box.min, Point3(-1, 0, 3));
+    AssertPointAlmostEqual(box.max, Point3(1, 2, 5));
+    AssertPointAlmostEqual(box.center(), Point3(0, 1, 4));
+}
+
+TEST(AABBTest, RayHitAndMiss) {
+    AABB box(Point3(-1, -1, -1), Point3(1, 1, 1));
+
+    Ray hits(Point3(0, 0, -5), Vector3(0, 0, 1));
+    Ray misses(Point3(0, 2, -5), Vector3(0, 0, 1));
+    Ray parallel_inside(Point3(0, 0, -5), Vector3(0, 0, 1));
+
+    EXPECT_TRUE(box.hit(hits, 0, INFINITY));
+    EXPECT_FALSE(box.hit(misses, 0, INFINITY));
+    EXPECT_FALSE(box.hit(hits, 0, 3.0)); // Box starts at t = 4
+    EXPECT_TRUE(box.hit(parallel_inside, 0, INFINITY));
+
+    double t_min = 0, t_max = INFINITY;
+    ASSERT_TRUE(box.clip(hits, t_min, t_max));
+    EXPECT_NEAR(t_min, 4.0, 1e-12);
+    EXPECT_NEAR(t_max, 6.0, 1e-12);
+}
+
+TEST(AABBTest, TransformedEnclosesRotatedBox) {
+    AABB box(Point3(-1, -1, -1), Point3(1, 1, 1));
+    AABB rotated = box.transformed(Matrix::rotation(M_PI / 4.0, Vector3(0, 1, 0)));
+
+    EXPECT_NEAR(rotated.max.x, std::sqrt(2.0), 1e-9);
+    EXPECT_NEAR(rotated.min.z, -std::sqrt(2.0), 1e-9);
+    EXPECT_NEAR(rotated.max.y, 1.0, 1e-9);
+
+    AABB moved = box.transformed(Matrix::translation(10, 0, 0));
+    AssertPointAlmostEqual(moved.center(), Point3(10, 0, 0));
+}
+
+TEST(AABBTest, InfiniteBoxOverlapsEverything) {
+    AABB all = AABB::infinite();
+    EXPECT_FALSE(all.isFinite());
+    EXPECT_TRUE(all.overlaps(AABB(Point3(5, 5, 5), Point3(6, 6, 6))));
+    EXPECT_TRUE(all.hit(Ray(Point3(0, 0, 0), Vector3(1, 1, 0)), 0, INFINITY));
+}
+
+TEST(AABBTest, ObjectBoundingBoxes) {
+    Sphere sphere(Point3(0, 0, 0), 2.0, nullptr);
+    sphere.setTransform(Matrix::translation(5, 0, 0));
+    AABB sphere_box = sphere.boundingBox();
+    AssertPointAlmostEqual(sphere_box.min, Point3(3, -2, -2));
+    AssertPointAlmostEqual(sphere_box.max, Point3(7, 2, 2));
+
+    Plane plane(Point3(0, 0, 0), Vector3(0, 1, 0), nullptr);
+    EXPECT_FALSE(plane.boundingBox().isFinite());
+}
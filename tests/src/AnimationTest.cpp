@@ -0,0 +1,117 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+using namespace Prism;
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::string toPPM(const Framebuffer& image, const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    image.writePPM(path);
+    return readFile(path);
+}
+
+// A sphere on a floor, turning around the vertical axis while the camera rises
+Scene makeTurntable(Animation& animation) {
+    Camera camera(Point3(0, 1, 6), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 16, 16);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    auto material = std::make_shared<Material>(Color(0.8, 0.3, 0.3));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), material));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, 0), 0.5, material));
+    scene.addLight(std::make_unique<Light>(Point3(2, 4, 3), Color(1.0, 1.0, 1.0)));
+
+    animation.setFrameCount(4);
+    animation.setCameraKeys({{0, Point3(0, 1, 6), Point3(0, 0, 0)},
+                             {3, Point3(0, 4, 6), Point3(0, 0, 0)}});
+    TransformKey start;
+    TransformKey end;
+    end.frame = 4;
+    end.translation = Vector3(1, 0, 0);
+    end.angle = 2 * M_PI;
+    animation.addTrack(1, Matrix::identity(4), {start, end});
+    return scene;
+}
+
+} // namespace
+
+TEST(AnimationTest, InterpolatesBetweenKeyframes) {
+    Animation animation;
+    Scene scene = makeTurntable(animation);
+    const Camera& base = scene.getCamera();
+
+    AssertPointAlmostEqual(animation.cameraAt(base, 1.5).pos, Point3(0, 2.5, 6));
+    AssertPointAlmostEqual(animation.cameraAt(base, -1).pos, Point3(0, 1, 6));
+    AssertPointAlmostEqual(animation.cameraAt(base, 10).pos, Point3(0, 4, 6));
+    EXPECT_EQ(animation.cameraAt(base, 2).pixel_width, 16);
+
+    const Animation::Track& track = animation.tracks()[0];
+    AssertPointAlmostEqual(Animation::transformAt(track, 2) * Point3(1, 0, 0),
+                           Point3(-0.5, 0, 0));
+    AssertPointAlmostEqual(Animation::transformAt(track, 4) * Point3(1, 0, 0), Point3(2, 0, 0));
+}
+
+TEST(AnimationTest, SequenceFramesMatchStillRenders) {
+    Animation animation;
+    Scene scene = makeTurntable(animation);
+    const Camera base = scene.getCamera();
+    auto dir = std::filesystem::temp_directory_path() / "prism_animation_test";
+    std::filesystem::remove_all(dir);
+
+    TraceStats stats;
+    scene.renderSequence(animation, dir, &stats);
+    EXPECT_GE(stats.rays, 4u * 16u * 16u);
+
+    // The scene is back to its loaded state afterwards
+    AssertPointAlmostEqual(scene.getCamera().pos, base.pos);
+    std::string first = readFile(dir / "frame_0000.ppm");
+    EXPECT_EQ(first, toPPM(scene.renderImage(RenderSettings()), "prism_animation_still.ppm"));
+
+    for (int frame = 1; frame < 4; ++frame) {
+        animation.apply(scene, frame, base);
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%04d.ppm", frame);
+        EXPECT_EQ(readFile(dir / name),
+                  toPPM(scene.renderImage(RenderSettings()), "prism_animation_still.ppm"))
+            << "frame " << frame;
+    }
+    EXPECT_NE(first, readFile(dir / "frame_0003.ppm"));
+}
+
+TEST(AnimationTest, FailedSequenceRestoresTheScene) {
+    Animation animation;
+    Scene scene = makeTurntable(animation);
+    const Camera base = scene.getCamera();
+    auto dir = std::filesystem::temp_directory_path() / "prism_animation_failure_test";
+    std::filesystem::remove_all(dir);
+    // The second frame cannot be written over a directory
+    std::filesystem::create_directories(dir / "frame_0001.ppm");
+
+    EXPECT_THROW(scene.renderSequence(animation, dir), std::runtime_error);
+    AssertPointAlmostEqual(scene.getCamera().pos, base.pos);
+    EXPECT_EQ(readFile(dir / "frame_0000.ppm"),
+              toPPM(scene.renderImage(RenderSettings()), "prism_animation_still.ppm"));
+}
+
+TEST(AnimationTest, RejectsEmptySequence) {
+    Animation animation;
+    Scene scene = makeTurntable(animation);
+    animation.setFrameCount(0);
+    EXPECT_THROW(scene.renderSequence(animation, std::filesystem::temp_directory_path()),
+                 std::runtime_error);
+}
@@ -0,0 +1,166 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+// The channels of an uncompressed scanline OpenEXR file, as written by writeAovs()
+struct ExrImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::string> channels;
+    std::vector<std::vector<float>> planes;
+
+    float at(const std::string& channel, int x, int y) const {
+        for (size_t i = 0; i < channels.size(); ++i) {
+            if (channels[i] == channel) {
+                return planes[i][static_cast<size_t>(y) * width + x];
+            }
+        }
+        throw std::runtime_error("no channel " + channel);
+    }
+};
+
+ExrImage readExr(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    size_t pos = 0;
+    auto u32 = [&] {
+        uint32_t value;
+        std::memcpy(&value, &bytes[pos], 4);
+        pos += 4;
+        return value;
+    };
+    auto str = [&] {
+        std::string value(&bytes[pos]);
+        pos += value.size() + 1;
+        return value;
+    };
+
+    ExrImage image;
+    EXPECT_EQ(u32(), 20000630u);
+    EXPECT_EQ(u32(), 2u);
+    for (std::string name = str(); !name.empty(); name = str()) {
+        str(); // Type
+        uint32_t size = u32();
+        if (name == "channels") {
+            size_t end = pos + size - 1;
+            while (pos < end) {
+                image.channels.push_back(str());
+                EXPECT_EQ(u32(), 2u); // Float
+                pos += 12;
+            }
+            pos++;
+        } else if (name == "dataWindow") {
+            u32();
+            u32();
+            image.width = static_cast<int>(u32()) + 1;
+            image.height = static_cast<int>(u32()) + 1;
+        } else {
+            pos += size;
+        }
+    }
+
+    pos += static_cast<size_t>(image.height) * 8; // Offset table
+    image.planes.assign(image.channels.size(),
+                        std::vector<float>(static_cast<size_t>(image.width) * image.height));
+    for (int y = 0; y < image.height; ++y) {
+        EXPECT_EQ(u32(), static_cast<uint32_t>(y));
+        u32(); // Size of the line
+        for (auto& plane : image.planes) {
+            std::memcpy(&plane[static_cast<size_t>(y) * image.width], &bytes[pos],
+                        image.width * sizeof(float));
+            pos += image.width * sizeof(float);
+        }
+    }
+    EXPECT_EQ(pos, bytes.size());
+    return image;
+}
+
+// A floor and a sphere seen from the front, with a different material each
+Scene makeScene() {
+    Camera camera(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 2.0, 2.0, 16, 16);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto floor = std::make_shared<Material>(Color(0.2, 0.4, 0.6));
+    auto ball = std::make_shared<Material>(Color(0.9, 0.1, 0.1));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), floor));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, -3), 1.0, ball));
+    scene.addLight(std::make_unique<Light>(Point3(0, 0, 0), Color(1.0, 1.0, 1.0)));
+    return scene;
+}
+
+RenderSettings allChannels(const std::filesystem::path& file) {
+    RenderSettings settings;
+    settings.aovs.depth = settings.aovs.normal = settings.aovs.albedo = true;
+    settings.aovs.object_id = settings.aovs.material_id = true;
+    settings.aovs.file = file;
+    return settings;
+}
+
+} // namespace
+
+TEST(AovTest, WritesFirstHitChannels) {
+    Scene scene = makeScene();
+    auto path = std::filesystem::temp_directory_path() / "prism_aov_test.exr";
+    scene.renderImage(allChannels(path));
+
+    ExrImage aovs = readExr(path);
+    ASSERT_EQ(aovs.width, 16);
+    ASSERT_EQ(aovs.height, 16);
+    std::vector<std::string> expected = {"N.X",      "N.Y",      "N.Z",        "Z",       "albedo.B",
+                                         "albedo.G", "albedo.R", "materialId", "objectId"};
+    EXPECT_EQ(aovs.channels, expected);
+
+    // Center: the sphere (pixel 8 is just off the axis), the second object and material
+    EXPECT_NEAR(aovs.at("Z", 8, 8), 2.0, 0.05);
+    EXPECT_NEAR(aovs.at("N.Z", 8, 8), 1.0, 0.05);
+    EXPECT_FLOAT_EQ(aovs.at("albedo.R", 8, 8), 0.9f);
+    EXPECT_EQ(aovs.at("objectId", 8, 8), 2.0f);
+    EXPECT_EQ(aovs.at("materialId", 8, 8), 2.0f);
+
+    // Bottom: the floor; top: the background
+    EXPECT_NEAR(aovs.at("N.Y", 8, 15), 1.0, 1e-6);
+    EXPECT_FLOAT_EQ(aovs.at("albedo.B", 8, 15), 0.6f);
+    EXPECT_EQ(aovs.at("objectId", 8, 15), 1.0f);
+    EXPECT_EQ(aovs.at("materialId", 8, 15), 1.0f);
+    EXPECT_EQ(aovs.at("objectId", 8, 0), 0.0f);
+    EXPECT_EQ(aovs.at("Z", 8, 0), 0.0f);
+}
+
+TEST(AovTest, CollectedInTheSamePass) {
+    Scene scene = makeScene();
+    TraceStats plain_stats, aov_stats;
+    Framebuffer plain = scene.renderImage(RenderSettings(), &plain_stats);
+    auto path = std::filesystem::temp_directory_path() / "prism_aov_test_pass.exr";
+    Framebuffer image = scene.renderImage(allChannels(path), &aov_stats);
+
+    EXPECT_EQ(aov_stats.rays, plain_stats.rays);
+    for (size_t i = 0; i < image.pixels().size(); ++i) {
+        EXPECT_EQ(image.pixels()[i].r, plain.pixels()[i].r);
+    }
+
+    // Only the selected channels are written
+    RenderSettings depth_only;
+    depth_only.aovs.depth = true;
+    depth_only.aovs.file = path;
+    scene.renderImage(depth_only);
+    EXPECT_EQ(readExr(path).channels, std::vector<std::string>{"Z"});
+
+    depth_only.aovs.file.clear();
+    EXPECT_THROW(scene.renderImage(depth_only), std::runtime_error);
+}
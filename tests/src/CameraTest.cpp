@@ -92,4 +92,23 @@ TEST(CameraTest, IteratorGeneratesGeometricallyCorrectRays) {
 
     AssertPointAlmostEqual(actual_top_left, expected_top_left);
     AssertPointAlmostEqual(actual_bottom_right, expected_bottom_right);
-}
\ No newline at end of file
+}
+
+TEST(CameraTest, RayAtPixelCenterMatchesIterator) {
+    Camera cam(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 2.0, 3.0, 4, 6);
+
+    int index = 0;
+    for (const Ray& ray : cam) {
+        int x = index % cam.pixel_width;
+        int y = index / cam.pixel_width;
+        Ray centered = cam.rayAt(x + 0.5, y + 0.5);
+        EXPECT_EQ(centered.direction().x, ray.direction().x);
+        EXPECT_EQ(centered.direction().y, ray.direction().y);
+        EXPECT_EQ(centered.direction().z, ray.direction().z);
+        ++index;
+    }
+
+    // The top-left corner of the image is half a pixel up and left of the first pixel center
+    Ray corner = cam.rayAt(0.0, 0.0);
+    AssertVectorAlmostEqual(corner.direction(), Vector3(-1.5, 1.0, -1.0).normalize());
+}
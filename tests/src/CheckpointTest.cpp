@@ -0,0 +1,103 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+using namespace Prism;
+
+namespace {
+
+RenderSettings checkpointSettings(const std::string& name) {
+    RenderSettings settings;
+    settings.tile_size = 8;
+    settings.checkpoint.file = std::filesystem::temp_directory_path() / name;
+    settings.checkpoint.interval = 0.0;
+    std::filesystem::remove(settings.checkpoint.file);
+    return settings;
+}
+
+} // namespace
+
+TEST(CheckpointTest, FinishedRenderIsRestoredWithoutTracing) {
+    Scene scene = MakeTwoSpheresScene(30);
+    Framebuffer expected = scene.renderImage(RenderSettings());
+    RenderSettings settings = checkpointSettings("prism_checkpoint_test_full.prckpt");
+
+    TraceStats first;
+    AssertImageAlmostEqual(scene.renderImage(settings, &first), expected, 1e-6);
+    EXPECT_GT(first.rays, 0u);
+
+    TraceStats resumed;
+    AssertImageAlmostEqual(scene.renderImage(settings, &resumed), expected, 1e-6);
+    EXPECT_EQ(resumed.rays, 0u);
+    std::filesystem::remove(settings.checkpoint.file);
+}
+
+TEST(CheckpointTest, InterruptedRenderResumesFromCompleteTiles) {
+    Scene scene = MakeTwoSpheresScene(30);
+    Framebuffer expected = scene.renderImage(RenderSettings());
+    RenderSettings settings = checkpointSettings("prism_checkpoint_test_cut.prckpt");
+    TraceStats full;
+    scene.renderImage(settings, &full);
+
+    // Cut the journal in the middle of a record, as an interruption while writing would
+    auto size = std::filesystem::file_size(settings.checkpoint.file);
+    std::filesystem::resize_file(settings.checkpoint.file, size / 2);
+
+    TraceStats resumed;
+    AssertImageAlmostEqual(scene.renderImage(settings, &resumed), expected, 1e-6);
+    EXPECT_GT(resumed.rays, 0u);
+    EXPECT_LT(resumed.rays, full.rays);
+
+    // The torn record was replaced, so the journal is whole again
+    TraceStats restored;
+    AssertImageAlmostEqual(scene.renderImage(settings, &restored), expected, 1e-6);
+    EXPECT_EQ(restored.rays, 0u);
+    std::filesystem::remove(settings.checkpoint.file);
+}
+
+TEST(CheckpointTest, OtherSettingsStartOver) {
+    Scene scene = MakeTwoSpheresScene(30);
+    RenderSettings settings = checkpointSettings("prism_checkpoint_test_other.prckpt");
+    scene.renderImage(settings);
+
+    settings.max_depth = 2;
+    TraceStats stats;
+    RenderSettings plain;
+    plain.max_depth = 2;
+    AssertImageAlmostEqual(scene.renderImage(settings, &stats), scene.renderImage(plain), 1e-6);
+    EXPECT_GT(stats.rays, 0u);
+    std::filesystem::remove(settings.checkpoint.file);
+}
+
+TEST(CheckpointTest, EmissionEditStartsOver) {
+    Scene scene = MakeTwoSpheresScene(30);
+    RenderSettings settings = checkpointSettings("prism_checkpoint_test_emission.prckpt");
+    Framebuffer dark = scene.renderImage(settings);
+
+    scene.updateObject(1, [](Object& sphere) { sphere.getMaterial()->ke = Color(0.5, 0.3, 0.0); });
+    TraceStats stats;
+    Framebuffer glowing = scene.renderImage(settings, &stats);
+    EXPECT_GT(stats.rays, 0u);
+    AssertImageAlmostEqual(glowing, scene.renderImage(RenderSettings()), 1e-6);
+    EXPECT_NE(glowing.at(8, 15).r, dark.at(8, 15).r);
+    std::filesystem::remove(settings.checkpoint.file);
+}
+
+TEST(CheckpointTest, DenoiserGuidesAreRestored) {
+    Scene scene = MakeTwoSpheresScene(30);
+    RenderSettings settings = checkpointSettings("prism_checkpoint_test_guides.prckpt");
+    settings.sampling.min_samples = 2;
+    settings.sampling.max_samples = 8;
+    settings.denoise.enabled = true;
+    Framebuffer first = scene.renderImage(settings);
+
+    auto size = std::filesystem::file_size(settings.checkpoint.file);
+    std::filesystem::resize_file(settings.checkpoint.file, size / 3);
+    AssertImageAlmostEqual(scene.renderImage(settings), first, 1e-6);
+    std::filesystem::remove(settings.checkpoint.file);
+}
@@ -0,0 +1,72 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace Prism;
+
+namespace {
+
+// A mirror sphere next to a diffuse one, lit by an area light, so the depth and the shadow
+// samples both change the image
+Scene makeScene() {
+    auto mirror = std::make_shared<Material>(Color(0.2, 0.2, 0.2), Color(0.0, 0.0, 0.0),
+                                             Color(0.9, 0.9, 0.9));
+    auto grey = std::make_shared<Material>(Color(0.6, 0.6, 0.6), Color(0.0, 0.0, 0.0));
+    return MakeTwoSpheresScene(32, mirror, grey, 0.5);
+}
+
+} // namespace
+
+TEST(DeadlineRenderTest, GenerousDeadlineReachesFullQuality) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    settings.tile_size = 8;
+    Framebuffer full = scene.renderImage(settings);
+
+    settings.deadline = 60.0;
+    AssertImageAlmostEqual(scene.renderImage(settings), full);
+}
+
+TEST(DeadlineRenderTest, RetracedTilesReplaceTheFirstPassGuides) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    settings.tile_size = 8;
+    // Jittered samples, so the pixel centers of the first pass would change the guides
+    settings.sampling.min_samples = settings.sampling.max_samples = 4;
+    settings.denoise.enabled = true;
+    Framebuffer full = scene.renderImage(settings);
+
+    // Guides of the tiles traced again hold only the samples of their final level
+    settings.deadline = 60.0;
+    AssertImageAlmostEqual(scene.renderImage(settings), full);
+}
+
+TEST(DeadlineRenderTest, ExpiredDeadlineKeepsTheFirstPass) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    settings.tile_size = 8;
+    settings.sampling.min_samples = 4;
+    settings.sampling.max_samples = 16;
+    settings.deadline = 1e-9;
+    Framebuffer rushed = scene.renderImage(settings);
+
+    // One pixel per 4x4 block is traced, with one bounce and one shadow ray, and fills its block
+    RenderSettings cheapest;
+    cheapest.max_depth = 1;
+    cheapest.shadows.min_samples = 1;
+    cheapest.shadows.max_samples = 1;
+    Framebuffer expected = scene.renderImage(cheapest);
+    for (int y = 0; y < rushed.height(); ++y) {
+        for (int x = 0; x < rushed.width(); ++x) {
+            const Color& traced = expected.at(x / 4 * 4, y / 4 * 4);
+            EXPECT_EQ(rushed.at(x, y).r, traced.r) << x << ", " << y;
+            EXPECT_EQ(rushed.at(x, y).g, traced.g) << x << ", " << y;
+            EXPECT_EQ(rushed.at(x, y).b, traced.b) << x << ", " << y;
+        }
+    }
+    EXPECT_NE(rushed.at(16, 16).r, 0.0);
+}
@@ -0,0 +1,120 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+using namespace Prism;
+
+namespace {
+
+// Guides of a wall split down the middle: the left half faces +z, the right half faces +x and is
+// red, so the features change at x = width / 2
+GuideBuffers splitGuides(int width, int height) {
+    GuideBuffers guides(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            bool left = x < width / 2;
+            guides.add(static_cast<size_t>(y) * width + x, 5.0,
+                       left ? Vector3(0, 0, 1) : Vector3(1, 0, 0),
+                       left ? Color(0.8, 0.8, 0.8) : Color(0.8, 0.1, 0.1));
+        }
+    }
+    guides.resolve();
+    return guides;
+}
+
+// The same image plus uniform noise of +-amplitude
+void addNoise(Framebuffer& image, double amplitude) {
+    Rng rng(7);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            double n = (rng.nextDouble() * 2.0 - 1.0) * amplitude;
+            image.at(x, y) = image.at(x, y) + Color(n, n, n);
+        }
+    }
+}
+
+double meanSquaredError(const Framebuffer& a, const Framebuffer& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.pixels().size(); ++i) {
+        Color d = a.pixels()[i] + b.pixels()[i] * -1.0;
+        sum += d.r * d.r + d.g * d.g + d.b * d.b;
+    }
+    return sum / a.pixels().size();
+}
+
+// A floor lit by a rectangle light, with a sphere casting a soft shadow
+Scene makeSoftShadowScene() {
+    Camera camera(Point3(0, 8, 0.01), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.2, 1.2, 48, 48);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto material = std::make_shared<Material>(Color(0.8, 0.8, 0.8), Color(0.0, 0.0, 0.0));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, 0), Vector3(0, 1, 0), material));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 1.5, 0), 0.8, material));
+    scene.addLight(std::make_unique<Light>(Light::rectangle(
+        Point3(0, 4, 0), Vector3(2, 0, 0), Vector3(0, 0, 2), Color(1, 1, 1))));
+    return scene;
+}
+
+} // namespace
+
+TEST(DenoiserTest, SmoothsNoiseWithinASurface) {
+    Framebuffer clean(32, 32);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            clean.at(x, y) = Color(0.5, 0.5, 0.5);
+        }
+    }
+    Framebuffer noisy = clean;
+    addNoise(noisy, 0.2);
+
+    Framebuffer filtered = noisy;
+    GuideBuffers guides = splitGuides(32, 32);
+    denoise(filtered, guides, DenoiseSettings());
+    EXPECT_LT(meanSquaredError(filtered, clean), meanSquaredError(noisy, clean) / 10);
+}
+
+TEST(DenoiserTest, KeepsEdgesBetweenSurfaces) {
+    Framebuffer clean(32, 32);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            clean.at(x, y) = x < 16 ? Color(0.8, 0.8, 0.8) : Color(0.4, 0.05, 0.05);
+        }
+    }
+    Framebuffer noisy = clean;
+    addNoise(noisy, 0.1);
+
+    Framebuffer filtered = noisy;
+    GuideBuffers guides = splitGuides(32, 32);
+    denoise(filtered, guides, DenoiseSettings());
+    for (int y = 0; y < 32; ++y) {
+        EXPECT_NEAR(filtered.at(15, y).g, 0.8, 0.08) << "row " << y;
+        EXPECT_NEAR(filtered.at(16, y).g, 0.05, 0.08) << "row " << y;
+    }
+}
+
+TEST(DenoiserTest, BringsFewShadowSamplesCloserToReference) {
+    Scene scene = makeSoftShadowScene();
+    RenderSettings reference_settings;
+    reference_settings.shadows.min_samples = 64;
+    reference_settings.shadows.max_samples = 64;
+    Framebuffer reference = scene.renderImage(reference_settings);
+
+    RenderSettings settings;
+    settings.shadows.min_samples = 1;
+    settings.shadows.max_samples = 2;
+    Framebuffer noisy = scene.renderImage(settings);
+    settings.denoise.enabled = true;
+    Framebuffer denoised = scene.renderImage(settings);
+
+    EXPECT_LT(meanSquaredError(denoised, reference), meanSquaredError(noisy, reference) / 2);
+}
+
+TEST(DenoiserTest, RejectsMismatchedGuides) {
+    Framebuffer image(8, 8);
+    GuideBuffers guides(8, 4);
+    EXPECT_THROW(denoise(image, guides, DenoiseSettings()), std::runtime_error);
+}
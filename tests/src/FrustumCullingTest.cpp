@@ -0,0 +1,139 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+struct Ball {
+    Point3 center;
+    double radius;
+    Color color;
+};
+
+// A grid of small coloured spheres over a plane, seen from above, so most tiles see a few of
+// them and many spheres straddle tile borders; a large sphere around the camera is hit from inside
+std::vector<Ball> makeBalls() {
+    std::vector<Ball> balls;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            balls.push_back({Point3(-7 + 2 * i, 0.5, -7 + 2 * j), 0.7,
+                             Color(0.1 + 0.1 * i, 0.1 + 0.1 * j, 0.5)});
+        }
+    }
+    balls.push_back({Point3(0, 20, 0), 0.5, Color(1.0, 0.0, 0.0)}); // Behind the camera
+    balls.push_back({Point3(0, 12, 0), 40.0, Color(0.0, 0.0, 1.0)}); // Around everything
+    return balls;
+}
+
+Scene makeScene(const std::vector<Ball>& balls, int size) {
+    Camera camera(Point3(0, 12, 0.01), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.5, 1.5, size,
+                  size);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    scene.addObject(std::make_unique<Plane>(
+        Point3(0, 0, 0), Vector3(0, 1, 0),
+        std::make_shared<Material>(Color(0.3, 0.3, 0.3), Color(0.0, 0.0, 0.0))));
+    for (const Ball& ball : balls) {
+        scene.addObject(std::make_unique<Sphere>(
+            ball.center, ball.radius,
+            std::make_shared<Material>(ball.color, Color(0.0, 0.0, 0.0))));
+    }
+    return scene;
+}
+
+// A sphere that counts the rays tested against it
+class CountingSphere : public Sphere {
+  public:
+    CountingSphere(const Point3& center, double radius, std::atomic<int>& tests)
+        : Sphere(center, radius, nullptr), tests_(tests) {}
+
+    bool hit(const Ray& ray, double t_min, double t_max, HitRecord& rec) const override {
+        tests_++;
+        return Sphere::hit(ray, t_min, t_max, rec);
+    }
+
+  private:
+    std::atomic<int>& tests_;
+};
+
+} // namespace
+
+TEST(FrustumCullingTest, CameraRaysFindTheSameHitsAsWithoutCulling) {
+    std::vector<Ball> balls = makeBalls();
+    Scene scene = makeScene(balls, 64);
+    RenderSettings settings;
+    settings.integrator = Integrator::Albedo;
+    settings.tile_size = 4;
+    Framebuffer image = scene.renderImage(settings);
+
+    // Every object tested for every ray
+    std::vector<std::unique_ptr<Object>> objects;
+    objects.push_back(std::make_unique<Plane>(Point3(0, 0, 0), Vector3(0, 1, 0), nullptr));
+    for (const Ball& ball : balls) {
+        objects.push_back(std::make_unique<Sphere>(ball.center, ball.radius, nullptr));
+    }
+    const Camera& camera = scene.getCamera();
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            Ray ray = camera.rayAt(x + 0.5, y + 0.5);
+            double closest = INFINITY;
+            Color expected(0.3, 0.3, 0.3);
+            for (size_t i = 0; i < objects.size(); ++i) {
+                HitRecord rec;
+                if (objects[i]->hit(ray, 1e-4, closest, rec)) {
+                    closest = rec.t;
+                    expected = i == 0 ? Color(0.3, 0.3, 0.3) : balls[i - 1].color;
+                }
+            }
+            EXPECT_EQ(image.at(x, y).r, expected.r) << x << ", " << y;
+            EXPECT_EQ(image.at(x, y).g, expected.g) << x << ", " << y;
+            EXPECT_EQ(image.at(x, y).b, expected.b) << x << ", " << y;
+        }
+    }
+}
+
+TEST(FrustumCullingTest, TileSizeDoesNotChangeTheImage) {
+    Scene scene = makeScene(makeBalls(), 48);
+    RenderSettings settings;
+    settings.sampling.min_samples = 4;
+    settings.sampling.max_samples = 16;
+    settings.tile_size = 1;
+    Framebuffer fine = scene.renderImage(settings);
+    settings.tile_size = 1000;
+    Framebuffer whole = scene.renderImage(settings);
+
+    for (size_t i = 0; i < fine.pixels().size(); ++i) {
+        EXPECT_EQ(fine.pixels()[i].r, whole.pixels()[i].r) << i;
+        EXPECT_EQ(fine.pixels()[i].g, whole.pixels()[i].g) << i;
+        EXPECT_EQ(fine.pixels()[i].b, whole.pixels()[i].b) << i;
+    }
+}
+
+TEST(FrustumCullingTest, EveryRenderModeCullsCameraRays) {
+    Scene scene = makeScene(makeBalls(), 32);
+    std::atomic<int> tests{0};
+    scene.addObject(std::make_unique<CountingSphere>(Point3(0, 20, 0), 0.5, tests));
+    RenderSettings settings;
+    settings.integrator = Integrator::Albedo;
+    settings.tile_size = 8;
+    Framebuffer tiled = scene.renderImage(settings);
+    EXPECT_EQ(tests, 0);
+
+    // The sphere behind the camera is never tested by the camera rays of the coarse and final
+    // passes of a progressive render, nor by those of the lattice and final passes of a deadline
+    settings.progressive.enabled = true;
+    AssertImageAlmostEqual(scene.renderImage(settings), tiled);
+    EXPECT_EQ(tests, 0);
+    settings.progressive.enabled = false;
+    settings.deadline = 60.0;
+    AssertImageAlmostEqual(scene.renderImage(settings), tiled);
+    EXPECT_EQ(tests, 0);
+}
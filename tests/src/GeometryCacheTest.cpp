@@ -0,0 +1,75 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace Prism;
+
+namespace {
+
+std::shared_ptr<const GeometryCluster> makeCluster(size_t triangles) {
+    auto cluster = std::make_shared<GeometryCluster>();
+    cluster->vertices.resize(triangles * 3);
+    cluster->normals.resize(triangles * 3);
+    return cluster;
+}
+
+} // namespace
+
+TEST(GeometryCacheTest, CountsHitsAndMisses) {
+    GeometryCache cache;
+    int loads = 0;
+    auto loader = [&] {
+        ++loads;
+        return makeCluster(4);
+    };
+
+    auto first = cache.acquire(1, 0, loader);
+    auto second = cache.acquire(1, 0, loader);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(loads, 1);
+
+    GeometryCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.resident_clusters, 1u);
+    EXPECT_EQ(stats.resident_bytes, first->byteSize());
+}
+
+TEST(GeometryCacheTest, EvictsLeastRecentlyUsedWithinBudget) {
+    const size_t cluster_bytes = makeCluster(4)->byteSize();
+    GeometryCache cache(cluster_bytes * 2);
+    auto loader = [] { return makeCluster(4); };
+
+    cache.acquire(1, 0, loader);
+    cache.acquire(1, 1, loader);
+    cache.acquire(1, 0, loader); // Cluster 1 is now the least recently used
+    cache.acquire(1, 2, loader);
+
+    GeometryCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.resident_clusters, 2u);
+    EXPECT_LE(stats.resident_bytes, stats.budget_bytes);
+
+    cache.acquire(1, 0, loader);
+    EXPECT_EQ(cache.stats().misses, 3u); // Cluster 0 survived
+    cache.acquire(1, 1, loader);
+    EXPECT_EQ(cache.stats().misses, 4u); // Cluster 1 was evicted
+}
+
+TEST(GeometryCacheTest, PinnedClustersOutliveEviction) {
+    GeometryCache cache(1);
+    auto pinned = cache.acquire(1, 0, [] { return makeCluster(8); });
+    cache.acquire(2, 0, [] { return makeCluster(8); });
+
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    ASSERT_TRUE(pinned);
+    EXPECT_EQ(pinned->vertices.size(), 24u);
+
+    cache.evictOwner(2);
+    EXPECT_EQ(cache.stats().resident_clusters, 0u);
+    EXPECT_EQ(cache.stats().resident_bytes, 0u);
+}
@@ -0,0 +1,87 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+using namespace Prism;
+
+namespace {
+
+// A floor, a mirror sphere in the middle and a small sphere (object 2) in a corner of the frame
+Scene makeScene(std::shared_ptr<Material> corner_material) {
+    Camera camera(Point3(0, 2, 6), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 64, 64);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    auto floor = std::make_shared<Material>(Color(0.6, 0.6, 0.6), Color(0.0, 0.0, 0.0));
+    auto mirror = std::make_shared<Material>(Color(0.2, 0.2, 0.2), Color(0.0, 0.0, 0.0),
+                                             Color(0.7, 0.7, 0.7));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), floor));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, 0), 1.0, mirror));
+    scene.addObject(std::make_unique<Sphere>(Point3(2.2, 1.8, 0), 0.3, corner_material));
+    scene.addLight(std::make_unique<Light>(Point3(-3, 5, 4), Color(1.0, 1.0, 1.0)));
+
+    RenderSettings settings;
+    settings.tile_size = 16;
+    scene.setRenderSettings(settings);
+    return scene;
+}
+
+} // namespace
+
+TEST(IncrementalRenderTest, FirstRenderMatchesFullRender) {
+    Scene scene = makeScene(std::make_shared<Material>(Color(1.0, 0.0, 0.0)));
+    AssertImageAlmostEqual(scene.renderIncremental(), scene.renderImage(scene.getRenderSettings()));
+}
+
+TEST(IncrementalRenderTest, MaterialEditRetracesOnlyAffectedTiles) {
+    auto red = std::make_shared<Material>(Color(1.0, 0.0, 0.0));
+    Scene scene = makeScene(red);
+    TraceStats full;
+    scene.renderIncremental(&full);
+
+    scene.updateMaterial(red, [](Material& material) { material.color = Color(0.0, 0.0, 1.0); });
+    TraceStats partial;
+    const Framebuffer& image = scene.renderIncremental(&partial);
+
+    EXPECT_GT(partial.rays, 0u);
+    EXPECT_LT(partial.rays, full.rays / 4);
+    AssertImageAlmostEqual(image, scene.renderImage(scene.getRenderSettings()));
+
+    // Nothing changed since, so nothing is traced again
+    TraceStats none;
+    scene.renderIncremental(&none);
+    EXPECT_EQ(none.rays, 0u);
+}
+
+TEST(IncrementalRenderTest, MovedObjectRetracesOldAndNewPlaces) {
+    Scene scene = makeScene(std::make_shared<Material>(Color(1.0, 0.0, 0.0)));
+    TraceStats full;
+    const Framebuffer before = scene.renderIncremental(&full);
+
+    // Moving the sphere onto the floor also changes the shadow it casts and its reflection
+    scene.updateObject(2, [](Object& object) {
+        object.setTransform(Matrix::translation(-4.2, -2.5, 1.0));
+    });
+    TraceStats partial;
+    const Framebuffer& image = scene.renderIncremental(&partial);
+
+    EXPECT_LT(partial.rays, full.rays);
+    AssertImageAlmostEqual(image, scene.renderImage(scene.getRenderSettings()));
+
+    // The sphere now shows in the mirror, which the sphere itself does not cover on screen
+    int reflected = 0;
+    for (int y = 24; y < 40; ++y) {
+        for (int x = 24; x < 40; ++x) {
+            reflected += image.at(x, y).r != before.at(x, y).r;
+        }
+    }
+    EXPECT_GT(reflected, 0);
+}
+
+TEST(IncrementalRenderTest, RejectsUnknownObject) {
+    Scene scene = makeScene(std::make_shared<Material>(Color(1.0, 0.0, 0.0)));
+    EXPECT_THROW(scene.updateObject(3, [](Object&) {}), std::runtime_error);
+}
@@ -0,0 +1,88 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+using namespace Prism;
+
+namespace {
+
+// A floor under a light, with a small sphere casting a shadow in the middle of the image
+Scene makeShadowScene(std::unique_ptr<Light> light) {
+    Camera camera(Point3(0, 8, 0.01), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.2, 1.2, 32, 32);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto material = std::make_shared<Material>(Color(0.8, 0.8, 0.8), Color(0.0, 0.0, 0.0));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, 0), Vector3(0, 1, 0), material));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 1.5, 0), 0.8, material));
+    scene.addLight(std::move(light));
+    return scene;
+}
+
+} // namespace
+
+TEST(LightTest, RectangleSamplesStayOnTheRectangle) {
+    Light light = Light::rectangle(Point3(1, 2, 3), Vector3(2, 0, 0), Vector3(0, 0, 4),
+                                   Color(1, 1, 1));
+    EXPECT_TRUE(light.isArea());
+    AssertPointAlmostEqual(light.samplePoint(Point3(0, 0, 0), 0.5, 0.5), Point3(1, 2, 3));
+    AssertPointAlmostEqual(light.samplePoint(Point3(0, 0, 0), 0.0, 0.0), Point3(0, 2, 1));
+    AssertPointAlmostEqual(light.bounds().min, Point3(0, 2, 1));
+    AssertPointAlmostEqual(light.bounds().max, Point3(2, 2, 5));
+}
+
+TEST(LightTest, SphereSamplesFaceTheShadingPoint) {
+    Light light = Light::sphere(Point3(0, 5, 0), 1.0, Color(1, 1, 1));
+    for (double s : {0.0, 0.3, 0.99}) {
+        for (double t : {0.0, 0.5, 0.75}) {
+            Point3 p = light.samplePoint(Point3(0, 0, 0), s, t);
+            // The disk facing a point straight below is horizontal
+            EXPECT_NEAR(p.y, 5.0, 1e-12);
+            EXPECT_LE((p - light.position).magnitude(), 1.0 + 1e-12);
+        }
+    }
+    EXPECT_FALSE(Light(Point3(0, 0, 0), Color(1, 1, 1)).isArea());
+}
+
+TEST(LightTest, FullyLitAreaLightMatchesPointLight) {
+    Scene point = makeShadowScene(std::make_unique<Light>(Point3(0, 4, 0), Color(1, 1, 1)));
+    Scene area = makeShadowScene(std::make_unique<Light>(
+        Light::rectangle(Point3(0, 4, 0), Vector3(1, 0, 0), Vector3(0, 0, 1), Color(1, 1, 1))));
+    Framebuffer hard = point.renderImage(RenderSettings());
+    Framebuffer soft = area.renderImage(RenderSettings());
+
+    // The corners see the whole light, so visibility is exactly 1 and shading is the same
+    EXPECT_EQ(hard.at(0, 0).r, soft.at(0, 0).r);
+    EXPECT_EQ(hard.at(31, 31).g, soft.at(31, 31).g);
+}
+
+TEST(LightTest, AreaLightsCastPenumbrasAdaptively) {
+    Scene hard_scene = makeShadowScene(std::make_unique<Light>(Point3(0, 4, 0), Color(1, 1, 1)));
+    Scene soft_scene = makeShadowScene(std::make_unique<Light>(
+        Light::sphere(Point3(0, 4, 0), 1.0, Color(1, 1, 1))));
+    RenderSettings settings;
+    TraceStats stats;
+    Framebuffer hard = hard_scene.renderImage(settings);
+    Framebuffer soft = soft_scene.renderImage(settings, &stats);
+
+    // Soft shading is the hard shading scaled by the visible fraction of the light, so pixels
+    // differ only in the penumbra, some of which lies outside the hard shadow
+    int penumbra = 0;
+    int lit_in_hard_shadow = 0;
+    for (size_t i = 0; i < hard.pixels().size(); ++i) {
+        if (soft.pixels()[i].r != hard.pixels()[i].r) {
+            penumbra++;
+            lit_in_hard_shadow += hard.pixels()[i].r == 0.0 && soft.pixels()[i].r > 0.0;
+        }
+    }
+    EXPECT_GT(penumbra, 0);
+    EXPECT_GT(lit_in_hard_shadow, 0);
+
+    // Outside the penumbra, only the first batch of shadow rays is traced
+    const uint64_t shading_points = 32 * 32;
+    EXPECT_GE(stats.shadow_rays, shading_points * settings.shadows.min_samples);
+    EXPECT_LT(stats.shadow_rays, shading_points * settings.shadows.max_samples / 2);
+}
@@ -0,0 +1,126 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+// A grid of small colored lights with a limited reach, 2 units apart on the plane y = 1
+std::vector<std::unique_ptr<Light>> makeLightGrid(int n, double radius) {
+    std::vector<std::unique_ptr<Light>> lights;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            Color color(0.05 * (1 + i % 3), 0.05 * (1 + j % 3), 0.05);
+            lights.push_back(
+                std::make_unique<Light>(Point3(2.0 * i - n, 1.0, 2.0 * j - n), color, radius));
+        }
+    }
+    return lights;
+}
+
+// A floor and a sphere under a grid of local lights
+Scene makeManyLightScene(int n) {
+    Camera camera(Point3(0, 6, 8), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 24, 24);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto material = std::make_shared<Material>(Color(0.8, 0.8, 0.8), Color(0.3, 0.3, 0.3));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, 0), Vector3(0, 1, 0), material));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0.5, 0), 0.5, material));
+    for (auto& light : makeLightGrid(n, 3.0)) {
+        scene.addLight(std::move(light));
+    }
+    return scene;
+}
+
+} // namespace
+
+TEST(LightTreeTest, FalloffIsSmoothAndBounded) {
+    EXPECT_DOUBLE_EQ(Light::falloff(100.0, 0.0), 1.0);
+    EXPECT_DOUBLE_EQ(Light::falloff(0.0, 2.0), 1.0);
+    EXPECT_DOUBLE_EQ(Light::falloff(2.0, 2.0), 0.0);
+    EXPECT_DOUBLE_EQ(Light::falloff(3.0, 2.0), 0.0);
+    EXPECT_GT(Light::falloff(1.0, 2.0), Light::falloff(1.5, 2.0));
+}
+
+TEST(LightTreeTest, CollectFindsExactlyTheLightsInReach) {
+    auto lights = makeLightGrid(8, 3.0);
+    LightTree tree(lights);
+    EXPECT_EQ(tree.size(), lights.size());
+
+    std::vector<uint32_t> found;
+    for (const Point3& p : {Point3(0, 0, 0), Point3(-7, 0, 5), Point3(30, 0, 0)}) {
+        tree.collect(p, 0.0, found);
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < lights.size(); ++i) {
+            if ((lights[i]->position - p).magnitude() < lights[i]->radius) {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(LightTreeTest, SampleProbabilitiesSumToOne) {
+    auto lights = makeLightGrid(4, 0.0);
+    LightTree tree(lights);
+
+    // Every light is reachable, so the leaf pdfs must cover the whole unit interval
+    const int samples = 4096;
+    std::vector<double> pdf_of(lights.size(), 0.0);
+    for (int i = 0; i < samples; ++i) {
+        uint32_t light;
+        double pdf;
+        ASSERT_TRUE(tree.sample(Point3(0, 0, 0), (i + 0.5) / samples, light, pdf));
+        ASSERT_LT(light, lights.size());
+        EXPECT_GT(pdf, 0.0);
+        pdf_of[light] = pdf;
+    }
+    double total = 0.0;
+    for (double pdf : pdf_of) {
+        total += pdf;
+    }
+    EXPECT_NEAR(total, 1.0, 1e-9);
+
+    uint32_t light;
+    double pdf;
+    EXPECT_FALSE(LightTree(makeLightGrid(2, 1.0)).sample(Point3(50, 0, 0), 0.5, light, pdf));
+}
+
+TEST(LightTreeTest, TreeSelectionMatchesAllLights) {
+    Scene scene = makeManyLightScene(6);
+    RenderSettings settings;
+    Framebuffer all = scene.renderImage(settings);
+    settings.lights.selection = LightSelection::Tree;
+    Framebuffer tree = scene.renderImage(settings);
+
+    for (size_t i = 0; i < all.pixels().size(); ++i) {
+        EXPECT_EQ(all.pixels()[i].r, tree.pixels()[i].r);
+        EXPECT_EQ(all.pixels()[i].g, tree.pixels()[i].g);
+        EXPECT_EQ(all.pixels()[i].b, tree.pixels()[i].b);
+    }
+}
+
+TEST(LightTreeTest, SampledLightsAreReproducibleAndUnbiasedOnAverage) {
+    Scene scene = makeManyLightScene(6);
+    RenderSettings settings;
+    Framebuffer all = scene.renderImage(settings);
+    settings.lights.selection = LightSelection::Sample;
+    settings.lights.samples = 8;
+    Framebuffer first = scene.renderImage(settings);
+    Framebuffer second = scene.renderImage(settings);
+
+    double all_sum = 0.0;
+    double sampled_sum = 0.0;
+    for (size_t i = 0; i < all.pixels().size(); ++i) {
+        EXPECT_EQ(first.pixels()[i].g, second.pixels()[i].g);
+        all_sum += all.pixels()[i].g;
+        sampled_sum += first.pixels()[i].g;
+    }
+    EXPECT_NEAR(sampled_sum / all_sum, 1.0, 0.1);
+}
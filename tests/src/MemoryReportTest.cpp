@@ -0,0 +1,101 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+using namespace Prism;
+
+namespace {
+
+Camera makeCamera(int width, int height) {
+    return Camera(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 2.0, 2.0, height,
+                  width);
+}
+
+} // namespace
+
+TEST(MemoryReportTest, CountsSharedMaterialsOnce) {
+    Scene scene(makeCamera(4, 4));
+    auto material = std::make_shared<Material>();
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, -5), 1.0, material));
+    MemoryReport one = scene.memoryReport();
+
+    scene.addObject(std::make_unique<Sphere>(Point3(2, 0, -5), 1.0, material));
+    MemoryReport two = scene.memoryReport();
+
+    EXPECT_EQ(two.materials, one.materials);
+    EXPECT_EQ(two.geometry, 2 * one.geometry);
+    EXPECT_EQ(two.transforms, 2 * one.transforms);
+    EXPECT_EQ(one.framebuffer, 16 * sizeof(Color));
+}
+
+TEST(MemoryReportTest, BreaksDownMeshStorage) {
+    std::vector<Point3> vertices = {Point3(0, 0, 0), Point3(1, 0, 0), Point3(0, 1, 0)};
+    std::vector<Vector3> normals = {Vector3(0, 0, -1)};
+    ObjReader::FaceIndices face{};
+    face.vertex_indices = {0, 1, 2};
+    face.normal_indices = {0, 0, 0};
+    Mesh mesh(vertices, normals, {face}, std::make_shared<Material>());
+
+    MemoryReport report;
+    mesh.accountMemory(report);
+    EXPECT_GE(report.geometry, 3 * sizeof(Point3) + sizeof(Vector3));
+    EXPECT_GE(report.indices, sizeof(ObjReader::FaceIndices));
+    EXPECT_GE(report.acceleration, sizeof(AABB));
+    EXPECT_GE(report.transforms, 3 * 16 * sizeof(double));
+    EXPECT_EQ(report.materials, sizeof(Material) + 2 * sizeof(long));
+    EXPECT_EQ(report.total(), report.geometry + report.indices + report.acceleration +
+                                  report.transforms + report.materials + report.framebuffer +
+                                  report.other);
+}
+
+TEST(MemoryReportTest, BudgetFailsWhileLoading) {
+    Scene scene(makeCamera(4, 4));
+    scene.setMemoryBudget(scene.memoryReport().total() + 4096);
+
+    auto material = std::make_shared<Material>();
+    EXPECT_THROW(
+        {
+            for (int i = 0; i < 1000; ++i) {
+                scene.addObject(std::make_unique<Sphere>(Point3(i, 0, -5), 1.0, material));
+            }
+        },
+        std::runtime_error);
+    EXPECT_LT(scene.objectCount(), 1000u);
+}
+
+TEST(MemoryReportTest, BudgetTooSmallForFramebufferIsRejected) {
+    Scene scene(makeCamera(1920, 1080));
+    EXPECT_THROW(scene.setMemoryBudget(1024 * 1024), std::runtime_error);
+}
+
+TEST(MemoryReportTest, ParserAppliesMemoryBudget) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_memory_report_test";
+    std::filesystem::create_directories(dir);
+    auto path = dir / "budget.yml";
+    std::ofstream(path) << R"(
+memory_budget_mb: 0.01
+camera:
+  image_width: 4
+  image_height: 4
+  screen_distance: 1.0
+  viewport_width: 2.0
+  viewport_height: 2.0
+  lookfrom: [0, 0, 0]
+  lookat: [0, 0, -1]
+  vup: [0, 1, 0]
+objects:
+  - type: spheres
+    centers: [0, 0, -5,  1, 0, -5,  2, 0, -5,  3, 0, -5,  4, 0, -5,  5, 0, -5,  6, 0, -5,  7, 0, -5,
+              0, 1, -5,  1, 1, -5,  2, 1, -5,  3, 1, -5,  4, 1, -5,  5, 1, -5,  6, 1, -5,  7, 1, -5,
+              0, 2, -5,  1, 2, -5,  2, 2, -5,  3, 2, -5,  4, 2, -5,  5, 2, -5,  6, 2, -5,  7, 2, -5]
+    radius: 0.1
+)";
+
+    EXPECT_THROW(SceneParser(path.string()).parse(), std::runtime_error);
+}
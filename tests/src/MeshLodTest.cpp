@@ -0,0 +1,153 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using namespace Prism;
+
+namespace {
+
+// A unit sphere made of `stacks` x `slices` quads, with smooth normals
+MeshLevel makeSphere(int stacks, int slices) {
+    MeshLevel mesh;
+    for (int i = 0; i <= stacks; ++i) {
+        double theta = M_PI * i / stacks;
+        for (int j = 0; j < slices; ++j) {
+            double phi = 2 * M_PI * j / slices;
+            Vector3 n(std::sin(theta) * std::cos(phi), std::cos(theta),
+                      std::sin(theta) * std::sin(phi));
+            mesh.vertices.emplace_back(n.x, n.y, n.z);
+            mesh.normals.push_back(n);
+        }
+    }
+    auto index = [&](int i, int j) { return static_cast<unsigned>(i * slices + j % slices); };
+    auto addFace = [&](unsigned a, unsigned b, unsigned c) {
+        ObjReader::FaceIndices face;
+        face.vertex_indices = face.normal_indices = {a, b, c};
+        mesh.faces.push_back(face);
+    };
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            if (i > 0) {
+                addFace(index(i, j), index(i, j + 1), index(i + 1, j));
+            }
+            if (i < stacks - 1) {
+                addFace(index(i, j + 1), index(i + 1, j + 1), index(i + 1, j));
+            }
+        }
+    }
+    return mesh;
+}
+
+// A flat square [0, 1] x [0, 1] at z = 0, made of n x n quads that do not share vertices
+MeshLevel makeGrid(int n) {
+    MeshLevel mesh;
+    mesh.normals.emplace_back(0, 0, 1);
+    auto addFace = [&](const Point3& a, const Point3& b, const Point3& c) {
+        unsigned first = static_cast<unsigned>(mesh.vertices.size());
+        mesh.vertices.insert(mesh.vertices.end(), {a, b, c});
+        ObjReader::FaceIndices face;
+        face.vertex_indices = {first, first + 1, first + 2};
+        face.normal_indices = {0, 0, 0};
+        mesh.faces.push_back(face);
+    };
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double x0 = static_cast<double>(i) / n, x1 = static_cast<double>(i + 1) / n;
+            double y0 = static_cast<double>(j) / n, y1 = static_cast<double>(j + 1) / n;
+            addFace(Point3(x0, y0, 0), Point3(x1, y0, 0), Point3(x1, y1, 0));
+            addFace(Point3(x0, y0, 0), Point3(x1, y1, 0), Point3(x0, y1, 0));
+        }
+    }
+    return mesh;
+}
+
+std::unique_ptr<Mesh> makeSphereMesh() {
+    MeshLevel sphere = makeSphere(32, 64);
+    return std::make_unique<Mesh>(sphere.vertices, sphere.normals, sphere.faces,
+                                  std::make_shared<Material>());
+}
+
+} // namespace
+
+TEST(MeshLodTest, SimplifiedSphereKeepsItsShape) {
+    MeshLevel sphere = makeSphere(32, 64);
+    MeshLevel simplified = simplifyMesh(sphere, 500);
+
+    EXPECT_LE(simplified.faces.size(), 500u);
+    EXPECT_GT(simplified.faces.size(), 400u);
+    EXPECT_EQ(simplified.normals.size(), simplified.vertices.size());
+    for (size_t i = 0; i < simplified.vertices.size(); ++i) {
+        const Point3& p = simplified.vertices[i];
+        EXPECT_NEAR(std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z), 1.0, 0.05);
+        EXPECT_NEAR(simplified.normals[i].magnitude(), 1.0, 1e-9);
+    }
+}
+
+TEST(MeshLodTest, FlatGridCollapsesInsideItsBorder) {
+    MeshLevel simplified = simplifyMesh(makeGrid(8), 2);
+
+    EXPECT_LE(simplified.faces.size(), 8u);
+    AABB bounds;
+    for (const Point3& p : simplified.vertices) {
+        EXPECT_NEAR(p.z, 0.0, 1e-9);
+        bounds.expand(p);
+    }
+    AssertPointAlmostEqual(bounds.min, Point3(0, 0, 0));
+    AssertPointAlmostEqual(bounds.max, Point3(1, 1, 0));
+}
+
+TEST(MeshLodTest, DistantMeshesUseCoarserLevels) {
+    auto mesh = makeSphereMesh();
+    mesh->generateLevels(2);
+    ASSERT_EQ(mesh->levelCount(), 3u);
+    EXPECT_LT(mesh->levelFaceCount(2), mesh->levelFaceCount(1));
+    EXPECT_LT(mesh->levelFaceCount(1), mesh->levelFaceCount(0));
+
+    const double pixel_angle = 1.0 / 512;
+    mesh->setViewpoint(Point3(0, 0, 3), pixel_angle);
+    EXPECT_EQ(mesh->currentLevel(), 0u);
+    mesh->setViewpoint(Point3(0, 0, 1000), pixel_angle);
+    EXPECT_EQ(mesh->currentLevel(), 2u);
+
+    // The coarse level is still a sphere to the rays that reach it
+    HitRecord rec;
+    ASSERT_TRUE(mesh->hit(Ray(Point3(0, 0, 1000), Vector3(0, 0, -1)), 1e-4, INFINITY, rec));
+    EXPECT_NEAR(rec.t, 999.0, 0.05);
+}
+
+TEST(MeshLodTest, PinnedLevelReplacesTheFullMesh) {
+    auto mesh = makeSphereMesh();
+    MemoryReport full;
+    mesh->accountMemory(full);
+    mesh->generateLevels(1);
+    size_t coarse_faces = mesh->levelFaceCount(1);
+
+    EXPECT_THROW(mesh->setLodSettings(LodSettings{0.5, 2}), std::runtime_error);
+    mesh->setLodSettings(LodSettings{0.5, 1});
+    EXPECT_EQ(mesh->levelCount(), 1u);
+    EXPECT_EQ(mesh->getFaces().size(), coarse_faces);
+
+    MemoryReport pinned;
+    mesh->accountMemory(pinned);
+    EXPECT_LT(pinned.geometry + pinned.indices, full.geometry + full.indices);
+}
+
+TEST(MeshLodTest, SceneChoosesLevelFromCamera) {
+    Camera near(Point3(0, 0, 3), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 64, 64);
+    Scene scene(near);
+    auto mesh = makeSphereMesh();
+    mesh->generateLevels(2);
+    Mesh* lod_mesh = mesh.get();
+    scene.addObject(std::move(mesh));
+    EXPECT_EQ(lod_mesh->currentLevel(), 0u);
+
+    scene.setCamera(Camera(Point3(0, 0, 200), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0,
+                           64, 64));
+    EXPECT_EQ(lod_mesh->currentLevel(), 2u);
+}
@@ -0,0 +1,69 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace Prism;
+
+namespace {
+
+// A single triangle facing -z, spanning [0, 1] in x and y
+std::filesystem::path writeTriangleObj(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_mesh_proxy_test";
+    std::filesystem::create_directories(dir);
+    auto path = dir / name;
+    std::ofstream(path) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 -1\n"
+                        << "f 1/1/1 2/1/1 3/1/1\n";
+    std::filesystem::remove(path.string() + ".bounds");
+    return path;
+}
+
+} // namespace
+
+TEST(MeshProxyTest, LoadsOnlyWhenBoundsAreReached) {
+    auto path = writeTriangleObj("lazy.obj");
+    MeshProxy proxy(path, AABB(Point3(0, 0, 0), Point3(1, 1, 0)));
+    HitRecord rec;
+
+    Ray misses(Point3(5, 5, -5), Vector3(0, 0, 1));
+    EXPECT_FALSE(proxy.hit(misses, 1e-4, INFINITY, rec));
+    EXPECT_FALSE(proxy.isLoaded());
+
+    Ray hits(Point3(0.25, 0.25, -5), Vector3(0, 0, 1));
+    EXPECT_TRUE(proxy.hit(hits, 1e-4, INFINITY, rec));
+    EXPECT_TRUE(proxy.isLoaded());
+    EXPECT_NEAR(rec.t, 5.0, 1e-9);
+}
+
+TEST(MeshProxyTest, AppliesTransformToLoadedGeometry) {
+    auto path = writeTriangleObj("moved.obj");
+    MeshProxy proxy(path, AABB(Point3(0, 0, 0), Point3(1, 1, 0)));
+    proxy.setTransform(Matrix::translation(10, 0, 0));
+    HitRecord rec;
+
+    EXPECT_FALSE(proxy.hit(Ray(Point3(0.25, 0.25, -5), Vector3(0, 0, 1)), 1e-4, INFINITY, rec));
+    EXPECT_TRUE(proxy.hit(Ray(Point3(10.25, 0.25, -5), Vector3(0, 0, 1)), 1e-4, INFINITY, rec));
+    AssertPointAlmostEqual(rec.p, Point3(10.25, 0.25, 0));
+
+    // Moving the proxy after loading also moves the geometry
+    proxy.setTransform(Matrix::translation(0, 10, 0));
+    EXPECT_TRUE(proxy.hit(Ray(Point3(0.25, 10.25, -5), Vector3(0, 0, 1)), 1e-4, INFINITY, rec));
+}
+
+TEST(MeshProxyTest, ReadsBoundsThroughCache) {
+    auto path = writeTriangleObj("cached.obj");
+
+    AABB scanned = MeshProxy::readBounds(path);
+    EXPECT_TRUE(std::filesystem::exists(path.string() + ".bounds"));
+    AABB cached = MeshProxy::readBounds(path);
+
+    AssertPointAlmostEqual(scanned.min, Point3(0, 0, 0));
+    AssertPointAlmostEqual(scanned.max, Point3(1, 1, 0));
+    AssertPointAlmostEqual(cached.min, scanned.min);
+    AssertPointAlmostEqual(cached.max, scanned.max);
+}
@@ -0,0 +1,112 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+Camera makeCamera(const Point3& position, int width, int height) {
+    return Camera(position, Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, height, width);
+}
+
+} // namespace
+
+TEST(MultiViewTest, ViewsMatchSeparateRenders) {
+    Scene scene = MakeTwoSpheresScene(24);
+    std::vector<Camera> cameras = {makeCamera(Point3(0, 1, 4), 24, 24),
+                                   makeCamera(Point3(3, 2, 3), 20, 16),
+                                   makeCamera(Point3(-4, 0.5, 1), 17, 23)};
+    RenderSettings settings;
+    settings.tile_size = 8;
+    settings.threads = 4;
+    std::vector<Framebuffer> views = scene.renderViews(cameras, settings);
+    ASSERT_EQ(views.size(), cameras.size());
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        scene.setCamera(cameras[i]);
+        Framebuffer single = scene.renderImage(settings);
+        ASSERT_EQ(views[i].width(), single.width());
+        ASSERT_EQ(views[i].height(), single.height());
+        for (int y = 0; y < single.height(); ++y) {
+            for (int x = 0; x < single.width(); ++x) {
+                EXPECT_EQ(views[i].at(x, y).r, single.at(x, y).r) << i << ": " << x << ", " << y;
+                EXPECT_EQ(views[i].at(x, y).g, single.at(x, y).g) << i << ": " << x << ", " << y;
+                EXPECT_EQ(views[i].at(x, y).b, single.at(x, y).b) << i << ": " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST(MultiViewTest, NamedCamerasAreUnique) {
+    Scene scene = MakeTwoSpheresScene(24);
+    scene.addCamera("front", makeCamera(Point3(0, 1, 4), 8, 8));
+    scene.addCamera("side", makeCamera(Point3(4, 1, 0), 8, 8));
+
+    EXPECT_EQ(scene.cameraNames(), (std::vector<std::string>{"front", "side"}));
+    AssertPointAlmostEqual(scene.getCamera("side").pos, Point3(4, 1, 0));
+    EXPECT_THROW(scene.addCamera("front", makeCamera(Point3(0, 0, 4), 8, 8)),
+                 std::runtime_error);
+    EXPECT_THROW(scene.getCamera("top"), std::runtime_error);
+    EXPECT_THROW(scene.renderViews({}, RenderSettings()), std::runtime_error);
+}
+
+TEST(MultiViewTest, AovsAreWrittenPerView) {
+    Scene scene = MakeTwoSpheresScene(24);
+    std::vector<Camera> cameras = {makeCamera(Point3(0, 1, 4), 12, 12),
+                                   makeCamera(Point3(3, 2, 3), 10, 8)};
+    auto dir = std::filesystem::temp_directory_path() / "prism_multi_view_aovs";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    RenderSettings settings;
+    settings.aovs.depth = settings.aovs.object_id = true;
+    EXPECT_THROW(scene.renderViews(cameras, settings), std::runtime_error);
+
+    settings.aovs.file = dir / "views.exr";
+    scene.renderViews(cameras, settings, nullptr, {"front", "side"});
+    EXPECT_TRUE(std::filesystem::exists(dir / "views_front.exr"));
+    EXPECT_TRUE(std::filesystem::exists(dir / "views_side.exr"));
+    EXPECT_FALSE(std::filesystem::exists(dir / "views.exr"));
+    EXPECT_THROW(scene.renderViews(cameras, settings, nullptr, {"front"}), std::runtime_error);
+}
+
+TEST(MultiViewTest, ParsedCamerasInheritTheMainCamera) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_multi_view_test";
+    std::filesystem::create_directories(dir);
+    auto path = dir / "views.yml";
+    std::ofstream(path) << R"(
+camera:
+  image_width: 16
+  image_height: 12
+  screen_distance: 1.0
+  viewport_width: 2.0
+  viewport_height: 1.5
+  lookfrom: [0, 0, 4]
+  lookat: [0, 0, 0]
+  vup: [0, 1, 0]
+cameras:
+  - name: left
+    lookfrom: [-4, 0, 0]
+  - name: wide
+    image_width: 32
+objects: []
+)";
+
+    Scene scene = SceneParser(path.string()).parse();
+    ASSERT_EQ(scene.cameraNames(), (std::vector<std::string>{"left", "wide"}));
+    const Camera& left = scene.getCamera("left");
+    AssertPointAlmostEqual(left.pos, Point3(-4, 0, 0));
+    EXPECT_EQ(left.pixel_width, 16);
+    EXPECT_DOUBLE_EQ(left.screen_height, 1.5);
+    const Camera& wide = scene.getCamera("wide");
+    AssertPointAlmostEqual(wide.pos, Point3(0, 0, 4));
+    EXPECT_EQ(wide.pixel_width, 32);
+    EXPECT_EQ(wide.pixel_height, 12);
+}
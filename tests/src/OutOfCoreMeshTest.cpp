@@ -0,0 +1,115 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+using namespace Prism;
+
+namespace {
+
+std::filesystem::path testDir() {
+    auto dir = std::filesystem::temp_directory_path() / "prism_out_of_core_test";
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// A bumpy n x n height field in the xy plane, facing -z
+Mesh makeGrid(int n) {
+    std::vector<Point3> vertices;
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i <= n; ++i) {
+            vertices.emplace_back(i, j, 0.25 * std::sin(i * 0.7) * std::cos(j * 0.3));
+        }
+    }
+    std::vector<Vector3> normals = {Vector3(0, 0, -1)};
+    std::vector<ObjReader::FaceIndices> faces;
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            unsigned a = j * (n + 1) + i;
+            unsigned b = a + 1;
+            unsigned c = a + (n + 1);
+            unsigned d = c + 1;
+            ObjReader::FaceIndices lower{};
+            lower.vertex_indices = {a, b, c};
+            lower.normal_indices = {0, 0, 0};
+            ObjReader::FaceIndices upper{};
+            upper.vertex_indices = {b, d, c};
+            upper.normal_indices = {0, 0, 0};
+            faces.push_back(lower);
+            faces.push_back(upper);
+        }
+    }
+    return Mesh(vertices, normals, faces, std::make_shared<Material>());
+}
+
+} // namespace
+
+TEST(OutOfCoreMeshTest, MatchesInMemoryMeshUnderTightBudget) {
+    Mesh mesh = makeGrid(16);
+    GeometryCache cache(1); // Every new cluster evicts the previous one
+    auto paged = OutOfCoreMesh::build(mesh, testDir() / "grid.prclusters", 8, cache);
+
+    EXPECT_EQ(paged->triangleCount(), mesh.getFaces().size());
+    EXPECT_EQ(paged->clusterCount(), (mesh.getFaces().size() + 7) / 8);
+
+    for (double y = -0.5; y < 17.0; y += 0.75) {
+        for (double x = -0.5; x < 17.0; x += 0.75) {
+            Ray ray(Point3(x, y, -5), Vector3(0.05, 0.02, 1));
+            HitRecord expected, actual;
+            bool expected_hit = mesh.hit(ray, 1e-4, INFINITY, expected);
+            ASSERT_EQ(paged->hit(ray, 1e-4, INFINITY, actual), expected_hit);
+            if (expected_hit) {
+                EXPECT_DOUBLE_EQ(actual.t, expected.t);
+                AssertPointAlmostEqual(actual.p, expected.p);
+            }
+        }
+    }
+
+    GeometryCache::Stats stats = cache.stats();
+    EXPECT_GT(stats.misses, 0u);
+    EXPECT_GT(stats.evictions, 0u);
+    EXPECT_LE(stats.resident_clusters, 1u);
+}
+
+TEST(OutOfCoreMeshTest, VisitsOnlyClustersInFrontOfTheHit) {
+    Mesh mesh = makeGrid(16);
+    GeometryCache cache;
+    auto paged = OutOfCoreMesh::build(mesh, testDir() / "front.prclusters", 8, cache);
+
+    // Only the few clusters around the hit point are ever paged in
+    HitRecord rec;
+    Ray ray(Point3(0.3, 0.3, -5), Vector3(0, 0, 1));
+    ASSERT_TRUE(paged->hit(ray, 1e-4, INFINITY, rec));
+    EXPECT_LT(cache.stats().misses, paged->clusterCount() / 8);
+}
+
+TEST(OutOfCoreMeshTest, ReusesBackingFileOfObj) {
+    auto path = testDir() / "tri.obj";
+    std::ofstream(path) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 -1\n"
+                        << "f 1/1/1 2/1/1 3/1/1\n";
+    std::filesystem::remove(path.string() + ".prclusters");
+
+    GeometryCache cache;
+    auto first = OutOfCoreMesh::fromObj(path, 4, cache);
+    auto backing = std::filesystem::path(path.string() + ".prclusters");
+    ASSERT_TRUE(std::filesystem::exists(backing));
+    auto written = std::filesystem::last_write_time(backing);
+
+    auto second = OutOfCoreMesh::fromObj(path, 4, cache);
+    EXPECT_EQ(std::filesystem::last_write_time(backing), written);
+
+    HitRecord rec;
+    EXPECT_TRUE(second->hit(Ray(Point3(0.25, 0.25, -5), Vector3(0, 0, 1)), 1e-4, INFINITY, rec));
+    EXPECT_NEAR(rec.t, 5.0, 1e-9);
+}
+
+TEST(OutOfCoreMeshTest, RejectsForeignBackingFile) {
+    auto path = testDir() / "foreign.prclusters";
+    std::ofstream(path) << "definitely not a cluster file";
+    EXPECT_THROW(OutOfCoreMesh mesh(path), std::runtime_error);
+}
@@ -0,0 +1,88 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+RenderSettings progressiveSettings(double interval) {
+    RenderSettings settings;
+    settings.tile_size = 8;
+    settings.progressive.enabled = true;
+    settings.progressive.interval = interval;
+    return settings;
+}
+
+bool samePixel(const Color& a, const Color& b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+} // namespace
+
+TEST(ProgressiveRenderTest, FinalImageMatchesNormalRender) {
+    Scene scene = MakeTwoSpheresScene(32);
+    Framebuffer full = scene.renderImage(RenderSettings());
+
+    std::vector<Framebuffer> previews;
+    Framebuffer image = scene.renderImage(
+        progressiveSettings(1e9), nullptr,
+        [&](const Framebuffer& preview) { previews.push_back(preview); });
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            EXPECT_TRUE(samePixel(image.at(x, y), full.at(x, y))) << x << ", " << y;
+        }
+    }
+
+    // One preview after each coarse pass; the first one repeats 1 pixel in 16 over its block
+    ASSERT_EQ(previews.size(), 2u);
+    const Framebuffer& coarse = previews[0];
+    ASSERT_EQ(coarse.width(), 32);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            EXPECT_TRUE(samePixel(coarse.at(x, y), full.at(x / 4 * 4, y / 4 * 4)))
+                << x << ", " << y;
+        }
+    }
+    EXPECT_TRUE(samePixel(previews[1].at(3, 3), full.at(2, 2)));
+}
+
+TEST(ProgressiveRenderTest, TilesGoFromTheCenterOut) {
+    Scene scene = MakeTwoSpheresScene(32);
+    Framebuffer full = scene.renderImage(RenderSettings());
+    ASSERT_GT(full.at(0, 31).r, 0.0);
+
+    // With no interval, a preview follows every tile; the first one only has the central tiles
+    std::vector<Framebuffer> previews;
+    scene.renderImage(progressiveSettings(0.0), nullptr,
+                      [&](const Framebuffer& preview) { previews.push_back(preview); });
+    ASSERT_GT(previews.size(), 16u);
+    EXPECT_TRUE(samePixel(previews[0].at(12, 12), full.at(12, 12)));
+    EXPECT_EQ(previews[0].at(0, 31).r, 0.0);
+}
+
+TEST(ProgressiveRenderTest, WorksWithRegionsAndAdaptiveSampling) {
+    Scene scene = MakeTwoSpheresScene(32);
+    RenderSettings settings = progressiveSettings(1e9);
+    settings.sampling.min_samples = 4;
+    settings.sampling.max_samples = 16;
+    settings.regions = {ImageRegion{4, 6, 20, 10}};
+    Framebuffer image = scene.renderImage(settings);
+
+    settings.progressive.enabled = false;
+    Framebuffer reference = scene.renderImage(settings);
+    ASSERT_EQ(image.width(), 20);
+    ASSERT_EQ(image.height(), 10);
+    double difference = 0.0;
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 20; ++x) {
+            difference += std::abs(image.at(x, y).g - reference.at(x, y).g);
+        }
+    }
+    EXPECT_LT(difference / 200, 0.01);
+}
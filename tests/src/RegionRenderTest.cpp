@@ -0,0 +1,128 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+
+using namespace Prism;
+
+namespace {
+
+void expectSamePixels(const Framebuffer& image, const Framebuffer& full, int x0, int y0, int x,
+                      int y) {
+    EXPECT_EQ(image.at(x - x0, y - y0).r, full.at(x, y).r) << x << ", " << y;
+    EXPECT_EQ(image.at(x - x0, y - y0).g, full.at(x, y).g) << x << ", " << y;
+    EXPECT_EQ(image.at(x - x0, y - y0).b, full.at(x, y).b) << x << ", " << y;
+}
+
+} // namespace
+
+TEST(RegionRenderTest, CroppedRegionMatchesFullRender) {
+    Scene scene = MakeTwoSpheresScene(32);
+    Framebuffer full = scene.renderImage(RenderSettings());
+
+    RenderSettings settings;
+    settings.regions = {ImageRegion{5, 9, 12, 7}};
+    Framebuffer crop = scene.renderImage(settings);
+    ASSERT_EQ(crop.width(), 12);
+    ASSERT_EQ(crop.height(), 7);
+    for (int y = 9; y < 16; ++y) {
+        for (int x = 5; x < 17; ++x) {
+            expectSamePixels(crop, full, 5, 9, x, y);
+        }
+    }
+}
+
+TEST(RegionRenderTest, SeveralRegionsLeaveTheRestBlack) {
+    Scene scene = MakeTwoSpheresScene(32);
+    Framebuffer full = scene.renderImage(RenderSettings());
+
+    RenderSettings settings;
+    settings.regions = {ImageRegion{0, 0, 4, 4}, ImageRegion{20, 24, 8, 8}};
+    settings.crop = false;
+    Framebuffer image = scene.renderImage(settings);
+    ASSERT_EQ(image.width(), 32);
+    expectSamePixels(image, full, 0, 0, 3, 3);
+    expectSamePixels(image, full, 0, 0, 27, 31);
+    EXPECT_EQ(image.at(10, 10).r, 0.0);
+
+    // Cropping keeps the bounding rectangle of both regions
+    settings.crop = true;
+    Framebuffer crop = scene.renderImage(settings);
+    EXPECT_EQ(crop.width(), 28);
+    EXPECT_EQ(crop.height(), 32);
+    expectSamePixels(crop, full, 0, 0, 25, 30);
+}
+
+TEST(RegionRenderTest, CompositesIntoAnExistingImage) {
+    Scene scene = MakeTwoSpheresScene(32);
+    Framebuffer full = scene.renderImage(RenderSettings());
+
+    Framebuffer image(32, 32);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            image.at(x, y) = Color(0.5, 0.25, 0.75);
+        }
+    }
+    RenderSettings settings;
+    settings.regions = {ImageRegion{8, 8, 16, 16}, ImageRegion{30, -4, 10, 6}};
+    scene.renderInto(image, settings);
+    expectSamePixels(image, full, 0, 0, 8, 8);
+    expectSamePixels(image, full, 0, 0, 23, 23);
+    expectSamePixels(image, full, 0, 0, 31, 1);
+    EXPECT_EQ(image.at(7, 8).g, 0.25);
+    EXPECT_EQ(image.at(24, 23).b, 0.75);
+
+    Framebuffer wrong(16, 32);
+    EXPECT_THROW(scene.renderInto(wrong, settings), std::runtime_error);
+    settings.regions = {ImageRegion{40, 40, 4, 4}};
+    EXPECT_THROW(scene.renderInto(image, settings), std::runtime_error);
+}
+
+TEST(RegionRenderTest, ResolutionScaleKeepsTheView) {
+    Scene scene = MakeTwoSpheresScene(64);
+    Framebuffer small = MakeTwoSpheresScene(16).renderImage(RenderSettings());
+
+    RenderSettings settings;
+    settings.resolution_scale = 0.25;
+    Framebuffer preview = scene.renderImage(settings);
+    ASSERT_EQ(preview.width(), 16);
+    ASSERT_EQ(preview.height(), 16);
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            expectSamePixels(preview, small, 0, 0, x, y);
+        }
+    }
+
+    // Regions are given at full resolution and scaled with the image
+    settings.regions = {ImageRegion{16, 16, 32, 16}};
+    Framebuffer crop = scene.renderImage(settings);
+    EXPECT_EQ(crop.width(), 8);
+    EXPECT_EQ(crop.height(), 4);
+    expectSamePixels(crop, small, 4, 4, 7, 6);
+}
+
+TEST(RegionRenderTest, PpmImagesReadBack) {
+    Framebuffer image = MakeTwoSpheresScene(12).renderImage(RenderSettings());
+    auto path = std::filesystem::temp_directory_path() / "prism_region_render_test.ppm";
+    image.writePPM(path);
+    Framebuffer read = Framebuffer::readPPM(path);
+    ASSERT_EQ(read.width(), 12);
+    ASSERT_EQ(read.height(), 12);
+
+    // Writing the image read back gives the same bytes
+    auto copy = std::filesystem::temp_directory_path() / "prism_region_render_test_copy.ppm";
+    read.writePPM(copy);
+    EXPECT_EQ(std::filesystem::file_size(copy), std::filesystem::file_size(path));
+    Framebuffer again = Framebuffer::readPPM(copy);
+    for (int y = 0; y < 12; ++y) {
+        for (int x = 0; x < 12; ++x) {
+            expectSamePixels(again, read, 0, 0, x, y);
+        }
+    }
+    EXPECT_THROW(Framebuffer::readPPM(path.parent_path() / "prism_missing.ppm"),
+                 std::runtime_error);
+}
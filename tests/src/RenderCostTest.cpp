@@ -0,0 +1,95 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using namespace Prism;
+
+namespace {
+
+// A mirror sphere on the left half of the image and a diffuse one on the right, over a plane
+Scene makeScene(int size) {
+    auto mirror = std::make_shared<Material>(Color(0.2, 0.2, 0.2), Color(0.0, 0.0, 0.0),
+                                             Color(0.9, 0.9, 0.9));
+    auto grey = std::make_shared<Material>(Color(0.6, 0.6, 0.6), Color(0.0, 0.0, 0.0));
+    return MakeTwoSpheresScene(size, mirror, grey);
+}
+
+} // namespace
+
+TEST(RenderCostTest, FullSampleCountsEveryRay) {
+    Scene scene = makeScene(32);
+    RenderSettings settings;
+    TraceStats stats;
+    scene.renderImage(settings, &stats);
+
+    RenderCostEstimate estimate = scene.estimateRenderCost(settings, 1.0);
+    EXPECT_EQ(estimate.sampled_pixels, 32u * 32u);
+    EXPECT_EQ(estimate.rays.rays, stats.rays);
+    EXPECT_EQ(estimate.camera_samples, 32u * 32u);
+
+    size_t area = 0;
+    for (size_t i = 0; i < estimate.regions.size(); ++i) {
+        area += estimate.regions[i].region.area();
+        if (i > 0) {
+            EXPECT_GE(estimate.regions[i - 1].seconds, estimate.regions[i].seconds);
+        }
+    }
+    EXPECT_EQ(area, 32u * 32u);
+    EXPECT_GT(estimate.seconds, 0.0);
+    // One slow pixel can make the slowest tile outweigh the whole image on one thread
+    EXPECT_DOUBLE_EQ(estimate.wallSeconds(1), std::max(estimate.seconds, estimate.slowest_tile));
+    EXPECT_LE(estimate.wallSeconds(4), estimate.wallSeconds(2));
+    EXPECT_DOUBLE_EQ(estimate.wallSeconds(1 << 20), estimate.slowest_tile);
+}
+
+TEST(RenderCostTest, RasterizationIsNotSpreadOverThreads) {
+    Scene scene = makeScene(32);
+    RenderSettings settings;
+    settings.rasterize = true;
+
+    RenderCostEstimate estimate = scene.estimateRenderCost(settings, 1.0);
+    EXPECT_GT(estimate.raster_seconds, 0.0);
+    EXPECT_DOUBLE_EQ(estimate.wallSeconds(1),
+                     std::max(estimate.seconds, estimate.slowest_tile) + estimate.raster_seconds);
+    EXPECT_DOUBLE_EQ(estimate.wallSeconds(1 << 20),
+                     estimate.slowest_tile + estimate.raster_seconds);
+}
+
+TEST(RenderCostTest, SampleExtrapolatesToTheWholeImage) {
+    Scene scene = makeScene(120);
+    RenderSettings settings;
+    settings.sampling.min_samples = 4;
+    settings.sampling.max_samples = 16;
+    TraceStats stats;
+    scene.renderImage(settings, &stats);
+
+    // Cells of 7x7 pixels
+    RenderCostEstimate estimate = scene.estimateRenderCost(settings, 0.02);
+    EXPECT_EQ(estimate.sampled_pixels, 18u * 18u);
+    EXPECT_NEAR(static_cast<double>(estimate.rays.rays), static_cast<double>(stats.rays),
+                0.15 * stats.rays);
+    EXPECT_GE(estimate.camera_samples, 4u * 120u * 120u);
+
+    // Rays bounce off the mirror, on the left of the image
+    const RegionCost* most_rays = &estimate.regions.front();
+    for (const RegionCost& cost : estimate.regions) {
+        if (cost.rays_per_pixel > most_rays->rays_per_pixel) {
+            most_rays = &cost;
+        }
+    }
+    EXPECT_LT(most_rays->region.x, 60);
+    EXPECT_GT(most_rays->rays_per_pixel, 5.0);
+}
+
+TEST(RenderCostTest, RejectsInvalidFractions) {
+    Scene scene = makeScene(8);
+    EXPECT_THROW(scene.estimateRenderCost(RenderSettings(), 0.0), std::runtime_error);
+    EXPECT_THROW(scene.estimateRenderCost(RenderSettings(), 1.5), std::runtime_error);
+}
@@ -0,0 +1,231 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+using namespace Prism;
+
+namespace {
+
+// A white sphere in front of a black background, lit from the camera
+Scene makeSphereScene(int size) {
+    Camera camera(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 2.0, 2.0, size, size);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto material = std::make_shared<Material>(Color(1.0, 1.0, 1.0), Color(0.0, 0.0, 0.0));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, -3), 1.0, material));
+    scene.addLight(std::make_unique<Light>(Point3(0, 0, 0), Color(1.0, 1.0, 1.0)));
+    return scene;
+}
+
+RenderSettings adaptiveSettings() {
+    RenderSettings settings;
+    settings.sampling.min_samples = 4;
+    settings.sampling.max_samples = 16;
+    return settings;
+}
+
+} // namespace
+
+TEST(RenderTest, RngIsDeterministicPerPixel) {
+    Rng a = Rng::forPixel(7, 3, 5);
+    Rng b = Rng::forPixel(7, 3, 5);
+    Rng other = Rng::forPixel(7, 4, 5);
+    bool differs = false;
+    for (int i = 0; i < 100; ++i) {
+        double value = a.nextDouble();
+        EXPECT_EQ(value, b.nextDouble());
+        EXPECT_GE(value, 0.0);
+        EXPECT_LT(value, 1.0);
+        differs = differs || value != other.nextDouble();
+    }
+    EXPECT_TRUE(differs);
+}
+
+TEST(RenderTest, AdaptiveSamplingKeepsFlatRegionsUnchanged) {
+    Scene scene = makeSphereScene(16);
+    Framebuffer single = scene.renderImage(RenderSettings());
+    Framebuffer adaptive = scene.renderImage(adaptiveSettings());
+
+    // The corners only see the background, so every sample agrees
+    EXPECT_EQ(adaptive.at(0, 0).r, single.at(0, 0).r);
+    EXPECT_EQ(adaptive.at(15, 15).g, single.at(15, 15).g);
+}
+
+TEST(RenderTest, AdaptiveSamplingSmoothsEdges) {
+    Scene scene = makeSphereScene(16);
+    Framebuffer single = scene.renderImage(RenderSettings());
+    Framebuffer adaptive = scene.renderImage(adaptiveSettings());
+
+    // Without anti-aliasing, pixels along the silhouette are either lit or black
+    int partial = 0;
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            double value = adaptive.at(x, y).r;
+            if (single.at(x, y).r == 0.0 && value > 0.0) {
+                ++partial;
+            }
+        }
+    }
+    EXPECT_GT(partial, 0);
+}
+
+TEST(RenderTest, AdaptiveSamplingIsReproducible) {
+    Scene scene = makeSphereScene(12);
+    Framebuffer first = scene.renderImage(adaptiveSettings());
+    Framebuffer second = scene.renderImage(adaptiveSettings());
+
+    for (size_t i = 0; i < first.pixels().size(); ++i) {
+        EXPECT_EQ(first.pixels()[i].r, second.pixels()[i].r);
+    }
+
+    RenderSettings reseeded = adaptiveSettings();
+    reseeded.seed = 42;
+    Framebuffer third = scene.renderImage(reseeded);
+    bool differs = false;
+    for (size_t i = 0; i < first.pixels().size(); ++i) {
+        differs = differs || first.pixels()[i].r != third.pixels()[i].r;
+    }
+    EXPECT_TRUE(differs);
+}
+
+namespace {
+
+// A glass sphere in front of a mirror, so every camera ray spawns a deep ray tree
+Scene makeGlassScene(int size) {
+    Camera camera(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 2.0, 2.0, size, size);
+    Scene scene(camera, Color(0.2, 0.3, 0.4));
+    auto glass = std::make_shared<Material>(Color(1.0, 1.0, 1.0), Color(0.1, 0.1, 0.1),
+                                            Color(0.5, 0.5, 0.5), Color(0.0, 0.0, 0.0), 50.0, 1.5,
+                                            0.05);
+    auto mirror = std::make_shared<Material>(Color(0.2, 0.2, 0.2), Color(0.1, 0.1, 0.1),
+                                             Color(0.8, 0.8, 0.8));
+    scene.addObject(std::make_unique<Sphere>(Point3(0, 0, -3), 1.0, glass));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, -6), Vector3(0, 0, 1), mirror));
+    scene.addLight(std::make_unique<Light>(Point3(2, 2, 0), Color(1.0, 1.0, 1.0)));
+    return scene;
+}
+
+} // namespace
+
+TEST(RenderTest, ContributionPruningStaysWithinOneStep) {
+    Scene scene = makeGlassScene(24);
+    RenderSettings full;
+    full.max_depth = 8;
+    RenderSettings pruned = full;
+    pruned.min_contribution = 0.5 / 255.0;
+
+    TraceStats full_stats, pruned_stats;
+    Framebuffer reference = scene.renderImage(full, &full_stats);
+    Framebuffer image = scene.renderImage(pruned, &pruned_stats);
+
+    EXPECT_EQ(full_stats.pruned, 0u);
+    EXPECT_GT(pruned_stats.pruned, 0u);
+    EXPECT_LT(pruned_stats.rays, full_stats.rays);
+
+    for (size_t i = 0; i < image.pixels().size(); ++i) {
+        EXPECT_LE(std::abs(convert_color(image.pixels()[i].r) -
+                           convert_color(reference.pixels()[i].r)),
+                  1);
+    }
+}
+
+TEST(RenderTest, RussianRouletteIsReproducible) {
+    Scene scene = makeGlassScene(12);
+    RenderSettings settings;
+    settings.max_depth = 8;
+    settings.russian_roulette = true;
+    settings.roulette_threshold = 0.2;
+
+    TraceStats stats;
+    Framebuffer first = scene.renderImage(settings, &stats);
+    Framebuffer second = scene.renderImage(settings);
+    EXPECT_GT(stats.terminated, 0u);
+    for (size_t i = 0; i < first.pixels().size(); ++i) {
+        EXPECT_EQ(first.pixels()[i].g, second.pixels()[i].g);
+    }
+}
+
+TEST(RenderTest, IterativeTraceMatchesRecursive) {
+    Scene scene = makeGlassScene(24);
+    for (bool roulette : {false, true}) {
+        RenderSettings recursive;
+        recursive.max_depth = 8;
+        recursive.russian_roulette = roulette;
+        recursive.roulette_threshold = 0.2;
+        recursive.recursive_trace = true;
+        RenderSettings iterative = recursive;
+        iterative.recursive_trace = false;
+
+        TraceStats recursive_stats, iterative_stats;
+        Framebuffer expected = scene.renderImage(recursive, &recursive_stats);
+        Framebuffer actual = scene.renderImage(iterative, &iterative_stats);
+
+        EXPECT_EQ(iterative_stats.rays, recursive_stats.rays);
+        EXPECT_EQ(iterative_stats.terminated, recursive_stats.terminated);
+        for (size_t i = 0; i < actual.pixels().size(); ++i) {
+            EXPECT_EQ(actual.pixels()[i].r, expected.pixels()[i].r);
+            EXPECT_EQ(actual.pixels()[i].g, expected.pixels()[i].g);
+            EXPECT_EQ(actual.pixels()[i].b, expected.pixels()[i].b);
+        }
+    }
+}
+
+TEST(RenderTest, IterativeTraceHandlesDeepRayTrees) {
+    // Two facing mirrors bounce the center ray back and forth until max_depth is reached
+    Camera camera(Point3(0, 0, 0), Point3(0, 0, -1), Vector3(0, 1, 0), 1.0, 0.1, 0.1, 1, 1);
+    Scene scene(camera, Color(0.0, 0.0, 0.0));
+    auto mirror = std::make_shared<Material>(Color(0.0, 0.0, 0.0), Color(0.0, 0.0, 0.0),
+                                             Color(1.0, 1.0, 1.0));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, -1), Vector3(0, 0, 1), mirror));
+    scene.addObject(std::make_unique<Plane>(Point3(0, 0, 1), Vector3(0, 0, -1), mirror));
+
+    RenderSettings settings;
+    settings.max_depth = 100000;
+    TraceStats stats;
+    scene.renderImage(settings, &stats);
+    EXPECT_EQ(stats.rays, 100000u);
+}
+
+TEST(RenderTest, PreviewIntegratorsShadeTheFirstHitOnly) {
+    Scene scene = makeSphereScene(16);
+    RenderSettings settings;
+    TraceStats stats;
+
+    settings.integrator = Integrator::Albedo;
+    Framebuffer albedo = scene.renderImage(settings, &stats);
+    EXPECT_EQ(stats.rays, 256u);
+    EXPECT_EQ(albedo.at(8, 8).g, 1.0);
+    EXPECT_EQ(albedo.at(0, 0).g, 0.0);
+
+    // The center of the sphere faces the camera (+z)
+    settings.integrator = Integrator::Normals;
+    Framebuffer normals = scene.renderImage(settings);
+    EXPECT_NEAR(normals.at(8, 8).b, 1.0, 0.01);
+    EXPECT_NEAR(normals.at(8, 8).r, 0.5, 0.1);
+
+    settings.integrator = Integrator::Depth;
+    settings.depth_scale = 2.0;
+    Framebuffer depth = scene.renderImage(settings);
+    EXPECT_NEAR(depth.at(8, 8).r, 0.5, 0.01); // The sphere is 2 units away
+    EXPECT_EQ(depth.at(0, 0).r, 0.0);
+}
+
+TEST(RenderTest, DirectIntegratorMatchesWhittedOnDiffuseScenes) {
+    // The sphere is diffuse and opaque, so the full renderer traces no secondary rays either
+    Scene scene = makeSphereScene(16);
+    RenderSettings settings;
+    Framebuffer whitted = scene.renderImage(settings);
+    settings.integrator = Integrator::Direct;
+    Framebuffer direct = scene.renderImage(settings);
+    for (size_t i = 0; i < direct.pixels().size(); ++i) {
+        EXPECT_EQ(direct.pixels()[i].r, whitted.pixels()[i].r);
+    }
+
+    settings.integrator = Integrator::Ambient;
+    Framebuffer ambient = scene.renderImage(settings);
+    EXPECT_EQ(ambient.at(8, 8).r, 0.0); // The material has no ambient term
+}
@@ -0,0 +1,275 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+const char* kSceneHeader = R"(
+camera:
+  image_width: 4
+  image_height: 4
+  screen_distance: 1.0
+  viewport_width: 2.0
+  viewport_height: 2.0
+  lookfrom: [0, 0, 0]
+  lookat: [0, 0, -1]
+  vup: [0, 1, 0]
+lights:
+  - position: [0, 5, 0]
+    color: [1, 1, 1]
+)";
+
+std::filesystem::path writeScene(const std::string& name, const std::string& objects) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+    auto path = dir / name;
+    std::ofstream(path) << kSceneHeader << objects;
+    return path;
+}
+
+} // namespace
+
+TEST(SceneParserTest, ParsesSingleObjects) {
+    auto path = writeScene("single.yml", R"(
+objects:
+  - type: sphere
+    center: [0, 0, -5]
+    radius: 1
+  - type: plane
+    point_on_plane: [0, -1, 0]
+    normal: [0, 1, 0]
+)");
+
+    Scene scene = SceneParser(path.string()).parse();
+    EXPECT_EQ(scene.objectCount(), 2u);
+}
+
+TEST(SceneParserTest, ParsesPackedSphereBlock) {
+    auto path = writeScene("packed.yml", R"(
+objects:
+  - type: spheres
+    centers: [0, 0, -5,  1, 0, -5,  2, 0, -5]
+    radii: [0.5, 0.25, 0.125]
+  - type: spheres
+    centers: [0, 1, -5,  1, 1, -5]
+    radius: 0.1
+)");
+
+    Scene scene = SceneParser(path.string()).parse();
+    EXPECT_EQ(scene.objectCount(), 5u);
+}
+
+TEST(SceneParserTest, StreamsRawSphereAndTriangleFiles) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+
+    const size_t sphere_count = 10000; // Spans several read chunks
+    {
+        std::ofstream raw(dir / "spheres.bin", std::ios::binary);
+        for (size_t i = 0; i < sphere_count; ++i) {
+            float record[4] = {static_cast<float>(i), 0.0f, -10.0f, 0.5f};
+            raw.write(reinterpret_cast<const char*>(record), sizeof(record));
+        }
+    }
+    {
+        std::ofstream raw(dir / "triangles.bin", std::ios::binary);
+        for (int i = 0; i < 3; ++i) {
+            float record[9] = {0, 0, -1, 1, 0, -1, 0, 1, -1};
+            raw.write(reinterpret_cast<const char*>(record), sizeof(record));
+        }
+    }
+
+    auto path = writeScene("raw.yml", R"(
+objects:
+  - type: spheres
+    file: spheres.bin
+  - type: triangles
+    file: triangles.bin
+    transform:
+      - type: translation
+        vector: [0, 0, -2]
+)");
+
+    Scene scene = SceneParser(path.string()).parse();
+    EXPECT_EQ(scene.objectCount(), sphere_count + 3);
+}
+
+TEST(SceneParserTest, RejectsMalformedPackedArray) {
+    auto path = writeScene("malformed.yml", R"(
+objects:
+  - type: triangles
+    vertices: [0, 0, -1, 1, 0, -1, 0, 1]
+)");
+
+    EXPECT_THROW(SceneParser(path.string()).parse(), std::runtime_error);
+}
+
+TEST(SceneParserTest, RejectsTruncatedRawFile) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream raw(dir / "truncated.bin", std::ios::binary);
+        float record[6] = {0, 0, -5, 1, 1, 0};
+        raw.write(reinterpret_cast<const char*>(record), sizeof(record));
+    }
+
+    auto path = writeScene("truncated.yml", R"(
+objects:
+  - type: spheres
+    file: truncated.bin
+)");
+
+    EXPECT_THROW(SceneParser(path.string()).parse(), std::runtime_error);
+}
+
+TEST(SceneParserTest, RejectsTrailingBytesInRawFile) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream raw(dir / "trailing.bin", std::ios::binary);
+        float record[4] = {0, 0, -5, 1};
+        raw.write(reinterpret_cast<const char*>(record), sizeof(record));
+        raw.write("\0\0", 2); // Half a float
+    }
+
+    auto path = writeScene("trailing.yml", R"(
+objects:
+  - type: spheres
+    file: trailing.bin
+)");
+
+    EXPECT_THROW(SceneParser(path.string()).parse(), std::runtime_error);
+}
+
+TEST(SceneParserTest, RejectsInvalidSphereRadii) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream raw(dir / "nan_radius.bin", std::ios::binary);
+        float records[8] = {0, 0, -5, 1, 1, 0, -5, std::nanf("")};
+        raw.write(reinterpret_cast<const char*>(records), sizeof(records));
+    }
+    auto raw_path = writeScene("nan_radius.yml", R"(
+objects:
+  - type: spheres
+    file: nan_radius.bin
+)");
+    auto packed_path = writeScene("negative_radius.yml", R"(
+objects:
+  - type: spheres
+    centers: [0, 0, -5,  1, 0, -5]
+    radii: [0.5, -0.5]
+)");
+
+    for (const auto& path : {raw_path, packed_path}) {
+        try {
+            SceneParser(path.string()).parse();
+            ADD_FAILURE() << "Expected an invalid radius error for " << path;
+        } catch (const std::runtime_error& error) {
+            EXPECT_NE(std::string(error.what()).find("sphere 1 "), std::string::npos)
+                << error.what();
+        }
+    }
+}
+
+TEST(SceneParserTest, ParsesAnimation) {
+    auto path = writeScene("animation.yml", R"(
+objects:
+  - name: ball
+    type: sphere
+    center: [0, 0, 0]
+    radius: 1
+    transform:
+      - type: translation
+        vector: [0, 0, -5]
+animation:
+  frames: 10
+  camera:
+    - {frame: 0, lookfrom: [0, 0, 0], lookat: [0, 0, -1]}
+    - {frame: 9, lookfrom: [0, 9, 0], lookat: [0, 0, -1]}
+  objects:
+    - name: ball
+      keys:
+        - {frame: 0}
+        - {frame: 10, translate: [10, 0, 0], scale: 2}
+)");
+
+    SceneParser parser(path.string());
+    Scene scene = parser.parse();
+    const Animation& animation = parser.animation();
+    EXPECT_EQ(animation.frameCount(), 10);
+    EXPECT_EQ(scene.getAnimation().frameCount(), 10);
+    ASSERT_EQ(animation.tracks().size(), 1u);
+    EXPECT_EQ(animation.tracks()[0].object, 0u);
+
+    // Halfway, the ball is scaled by 1.5 around the origin, then moved 5 units along x
+    Matrix halfway = Animation::transformAt(animation.tracks()[0], 5);
+    AssertPointAlmostEqual(halfway * Point3(0, 0, 0), Point3(5, 0, -7.5));
+    AssertPointAlmostEqual(animation.cameraAt(scene.getCamera(), 3).pos, Point3(0, 3, 0));
+}
+
+TEST(SceneParserTest, RejectsAnimationOfUnknownObject) {
+    auto path = writeScene("animation_unknown.yml", R"(
+objects:
+  - type: sphere
+    center: [0, 0, -5]
+    radius: 1
+animation:
+  frames: 2
+  objects:
+    - name: missing
+      keys: [{frame: 0}]
+)");
+
+    EXPECT_THROW(SceneParser(path.string()).parse(), std::runtime_error);
+}
+
+TEST(SceneParserTest, ParsesMeshLevelsOfDetail) {
+    // A square of 4 x 4 quads, coarse enough for two simplified levels
+    auto dir = std::filesystem::temp_directory_path() / "prism_scene_parser_test";
+    std::filesystem::create_directories(dir);
+    std::ofstream obj(dir / "grid.obj");
+    for (int j = 0; j <= 4; ++j) {
+        for (int i = 0; i <= 4; ++i) {
+            obj << "v " << i << " " << j << " -5\n";
+        }
+    }
+    obj << "vt 0 0\nvn 0 0 1\n";
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            int a = j * 5 + i + 1;
+            obj << "f " << a << "/1/1 " << a + 1 << "/1/1 " << a + 6 << "/1/1\n";
+            obj << "f " << a << "/1/1 " << a + 6 << "/1/1 " << a + 5 << "/1/1\n";
+        }
+    }
+    obj.close();
+
+    auto path = writeScene("lod.yml", R"(
+objects:
+  - type: mesh
+    path: grid.obj
+    lod: {levels: 2, ratio: 0.5, pin: 1}
+)");
+    Scene scene = SceneParser(path.string()).parse();
+    EXPECT_EQ(scene.objectCount(), 1u);
+    EXPECT_LT(scene.memoryReport().indices, 32 * sizeof(ObjReader::FaceIndices));
+
+    auto lazy = writeScene("lod_lazy.yml", R"(
+objects:
+  - type: mesh
+    path: grid.obj
+    lazy: true
+    lod: {levels: 2}
+)");
+    EXPECT_THROW(SceneParser(lazy.string()).parse(), std::runtime_error);
+}
@@ -0,0 +1,161 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+// Two spheres over a plane, lit by a point light, so both cast shadows on the plane
+Scene makeScene() {
+    Camera camera(Point3(0, 2, 5), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 48, 48);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    auto grey = std::make_shared<Material>(Color(0.6, 0.6, 0.6), Color(0.0, 0.0, 0.0));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), grey));
+    scene.addObject(std::make_unique<Sphere>(Point3(-0.8, 0, 0), 0.6, grey));
+    scene.addObject(std::make_unique<Sphere>(Point3(0.9, -0.3, -0.5), 0.5, grey));
+    scene.addLight(std::make_unique<Light>(Point3(1, 4, 2), Color(1.0, 1.0, 1.0)));
+    return scene;
+}
+
+// Fraction of pixels that differ by more than 0.05 in some channel
+double differingPixels(const Framebuffer& image, const Framebuffer& expected) {
+    size_t differing = 0;
+    for (size_t i = 0; i < image.pixels().size(); ++i) {
+        const Color& a = image.pixels()[i];
+        const Color& b = expected.pixels()[i];
+        if (std::abs(a.r - b.r) > 0.05 || std::abs(a.g - b.g) > 0.05 ||
+            std::abs(a.b - b.b) > 0.05) {
+            differing++;
+        }
+    }
+    return static_cast<double>(differing) / image.pixels().size();
+}
+
+} // namespace
+
+TEST(ShadowMapTest, CubemapMatchesTheShadowOfASphere) {
+    // A sphere of radius 0.5, 2 below the light, shades a disc of radius ~0.77 on the floor
+    Sphere occluder(Point3(0, 1, 0), 0.5, nullptr);
+    Plane floor(Point3(0, 0, 0), Vector3(0, 1, 0), nullptr);
+    auto cast = [&](const Ray& ray) {
+        HitRecord rec;
+        double t = INFINITY;
+        if (occluder.hit(ray, 1e-4, t, rec)) {
+            t = rec.t;
+        }
+        if (floor.hit(ray, 1e-4, t, rec)) {
+            t = rec.t;
+        }
+        return t;
+    };
+    ShadowCubemap map(Point3(0, 3, 0), 128, cast);
+    EXPECT_EQ(map.memoryBytes(), 6u * 128u * 128u * sizeof(float));
+
+    for (double angle = 0.0; angle < 6.28; angle += 0.3) {
+        for (double radius : {0.0, 0.3, 0.6}) {
+            Point3 p(radius * std::cos(angle), 0, radius * std::sin(angle));
+            EXPECT_EQ(map.visibility(p, Vector3(0, 1, 0), 0.005, 1), 0.0)
+                << radius << " " << angle;
+        }
+        for (double radius : {1.0, 2.0, 4.0}) {
+            Point3 p(radius * std::cos(angle), 0, radius * std::sin(angle));
+            EXPECT_EQ(map.visibility(p, Vector3(0, 1, 0), 0.005, 1), 1.0)
+                << radius << " " << angle;
+        }
+    }
+
+    // The lit top of the occluder, and points between it and the light
+    EXPECT_EQ(map.visibility(Point3(0, 1.5, 0), Vector3(0, 1, 0), 0.005, 1), 1.0);
+    EXPECT_EQ(map.visibility(Point3(0.2, 2.0, 0.1), Vector3(0, 1, 0), 0.005, 1), 1.0);
+
+    // Across the edge of the shadow, filtered lookups fall between 0 and 1
+    bool partial = false;
+    for (double radius = 0.6; radius <= 1.0; radius += 0.01) {
+        double visibility = map.visibility(Point3(radius, 0, 0), Vector3(0, 1, 0), 0.005, 2);
+        partial = partial || (visibility > 0.0 && visibility < 1.0);
+    }
+    EXPECT_TRUE(partial);
+}
+
+TEST(ShadowMapTest, RenderIsCloseToTracedShadows) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    Framebuffer exact = scene.renderImage(settings);
+
+    settings.shadow_maps.enabled = true;
+    settings.shadow_maps.resolution = 128;
+    Framebuffer approximate = scene.renderImage(settings);
+    EXPECT_LT(differingPixels(approximate, exact), 0.03);
+
+    // The same maps serve the next render of the unchanged scene
+    const size_t memory = scene.memoryReport().other;
+    Framebuffer again = scene.renderImage(settings);
+    EXPECT_EQ(scene.memoryReport().other, memory);
+    EXPECT_EQ(differingPixels(again, approximate), 0.0);
+}
+
+TEST(ShadowMapTest, MovedObjectsRebuildTheMaps) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    settings.shadow_maps.enabled = true;
+    settings.shadow_maps.resolution = 128;
+    scene.renderImage(settings);
+
+    scene.updateObject(1, [](Object& object) {
+        object.setTransform(Matrix::translation(0.5, 0.0, 1.0));
+    });
+    Framebuffer approximate = scene.renderImage(settings);
+    settings.shadow_maps.enabled = false;
+    Framebuffer exact = scene.renderImage(settings);
+    EXPECT_LT(differingPixels(approximate, exact), 0.03);
+}
+
+TEST(ShadowMapTest, CacheRebuildsOnlyOutdatedMaps) {
+    std::vector<std::unique_ptr<Light>> lights;
+    lights.push_back(std::make_unique<Light>(Point3(0, 2, 0), Color(1.0, 1.0, 1.0)));
+    lights.push_back(std::make_unique<Light>(Point3(3, 2, 0), Color(1.0, 1.0, 1.0)));
+    auto area = std::make_unique<Light>(Point3(0, 5, 0), Color(1.0, 1.0, 1.0));
+    area->shape = LightShape::Sphere;
+    area->sphere_radius = 0.5;
+    lights.push_back(std::move(area));
+
+    std::atomic<size_t> casts{0};
+    auto cast = [&](const Ray&) {
+        casts++;
+        return 1.0;
+    };
+    const size_t per_map = 6 * 8 * 8;
+    ShadowMapSettings settings;
+    settings.resolution = 8;
+    ShadowMapCache cache;
+
+    ShadowMaps maps = cache.prepare(lights, settings, 0, cast);
+    EXPECT_EQ(maps.size(), 2u);
+    EXPECT_EQ(maps.count(lights[2].get()), 0u);
+    EXPECT_EQ(casts, 2 * per_map);
+    EXPECT_EQ(cache.memoryBytes(), 2 * (sizeof(ShadowCubemap) + per_map * sizeof(float)));
+
+    cache.prepare(lights, settings, 0, cast);
+    EXPECT_EQ(casts, 2 * per_map);
+
+    lights[1]->position = Point3(3, 2, 1);
+    ShadowMaps moved = cache.prepare(lights, settings, 0, cast);
+    EXPECT_EQ(casts, 3 * per_map);
+    EXPECT_EQ(moved.at(lights[0].get()), maps.at(lights[0].get()));
+    EXPECT_NE(moved.at(lights[1].get()), maps.at(lights[1].get()));
+
+    cache.prepare(lights, settings, 1, cast);
+    EXPECT_EQ(casts, 5 * per_map);
+
+    settings.resolution = 4;
+    cache.prepare(lights, settings, 1, cast);
+    EXPECT_EQ(casts, 5 * per_map + 2 * 6 * 4 * 4);
+}
@@ -0,0 +1,231 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+std::filesystem::path snapshotPath(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / "prism_snapshot_test";
+    std::filesystem::create_directories(dir);
+    return dir / name;
+}
+
+std::string readBytes(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+Scene makeScene() {
+    Camera camera(Point3(0, 1, 5), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 2.0, 2.0, 24, 32);
+    Scene scene(camera, Color(0.2, 0.2, 0.2));
+
+    auto red = std::make_shared<Material>(Color(1.0, 0.0, 0.0));
+    auto glass = std::make_shared<Material>(Color(1.0, 1.0, 1.0), Color(0.1, 0.1, 0.1),
+                                            Color(0.1, 0.1, 0.1), Color(0, 0, 0), 256, 1.52, 0.05);
+
+    auto sphere = std::make_unique<Sphere>(Point3(0, 0, 0), 1.0, glass);
+    sphere->setTransform(Matrix::translation(1, 0, 0) * Matrix::scaling(1, 2, 1));
+    scene.addObject(std::move(sphere));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), red));
+    scene.addObject(
+        std::make_unique<Triangle>(Point3(0, 0, -1), Point3(1, 0, -1), Point3(0, 1, -1), red));
+
+    std::vector<Point3> vertices = {Point3(0, 0, 0), Point3(1, 0, 0), Point3(0, 1, 0)};
+    std::vector<Vector3> normals = {Vector3(0, 0, 1)};
+    std::vector<ObjReader::FaceIndices> faces = {{{0, 1, 2}, {0, 0, 0}}};
+    auto mesh = std::make_unique<Mesh>(vertices, normals, faces, glass);
+    mesh->setTransform(Matrix::rotation(0.5, Vector3(0, 1, 0)));
+    scene.addObject(std::move(mesh));
+
+    scene.addLight(std::make_unique<Light>(Point3(0, 5, 0), Color(1.0, 1.0, 1.0)));
+    scene.addLight(std::make_unique<Light>(Light::rectangle(
+        Point3(2, 4, 0), Vector3(1, 0, 0), Vector3(0, 0, 1), Color(0.5, 0.5, 0.5), 10.0)));
+    scene.addLight(
+        std::make_unique<Light>(Light::sphere(Point3(-2, 4, 0), 0.5, Color(0.2, 0.2, 0.2))));
+    return scene;
+}
+
+} // namespace
+
+TEST(SnapshotTest, RoundTripIsLossless) {
+    auto first = snapshotPath("first.prsnap");
+    auto second = snapshotPath("second.prsnap");
+
+    makeScene().save_snapshot(first);
+    Scene restored = Scene::load_snapshot(first);
+    restored.save_snapshot(second);
+
+    EXPECT_EQ(restored.objectCount(), 4u);
+    EXPECT_EQ(readBytes(first), readBytes(second));
+
+    const Camera& cam = restored.getCamera();
+    AssertPointAlmostEqual(cam.pos, Point3(0, 1, 5));
+    AssertPointAlmostEqual(cam.aim, Point3(0, 0, 0));
+    EXPECT_EQ(cam.pixel_height, 24);
+    EXPECT_EQ(cam.pixel_width, 32);
+}
+
+TEST(SnapshotTest, RejectsForeignFile) {
+    auto path = snapshotPath("foreign.prsnap");
+    std::ofstream(path) << "this is not a snapshot, just some text long enough to fill a header "
+                           "of a Prism scene snapshot file..........................................";
+
+    EXPECT_THROW(Scene::load_snapshot(path), std::runtime_error);
+}
+
+TEST(SnapshotTest, RejectsTruncatedFile) {
+    auto path = snapshotPath("truncated.prsnap");
+    makeScene().save_snapshot(path);
+    std::string bytes = readBytes(path);
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), static_cast<std::streamsize>(bytes.size() / 2));
+
+    EXPECT_THROW(Scene::load_snapshot(path), std::runtime_error);
+}
+
+TEST(SnapshotTest, RoundTripKeepsRenderSettings) {
+    auto path = snapshotPath("settings.prsnap");
+    RenderSettings settings;
+    settings.max_depth = 2;
+    settings.sampling.min_samples = 2;
+    settings.sampling.max_samples = 8;
+    settings.sampling.contrast_threshold = 0.02;
+    settings.seed = 1234567890123ull;
+    settings.lights.selection = LightSelection::Sample;
+    settings.lights.samples = 2;
+    settings.tile_size = 8;
+    settings.regions = {ImageRegion{2, 3, 10, 12}, ImageRegion{16, 0, 8, 8}};
+    settings.progressive.preview = "preview.ppm";
+    settings.checkpoint.interval = 2.5;
+    Scene scene = makeScene();
+    scene.setRenderSettings(settings);
+    scene.save_snapshot(path);
+
+    Scene restored = Scene::load_snapshot(path);
+    const RenderSettings& loaded = restored.getRenderSettings();
+    EXPECT_EQ(loaded.max_depth, 2);
+    EXPECT_EQ(loaded.sampling.max_samples, 8);
+    EXPECT_EQ(loaded.seed, settings.seed);
+    EXPECT_EQ(loaded.lights.selection, LightSelection::Sample);
+    EXPECT_EQ(loaded.tile_size, 8);
+    ASSERT_EQ(loaded.regions.size(), 2u);
+    EXPECT_EQ(loaded.regions[1].x, 16);
+    EXPECT_EQ(loaded.regions[1].height, 8);
+    EXPECT_EQ(loaded.progressive.preview, settings.progressive.preview);
+    EXPECT_EQ(loaded.checkpoint.interval, 2.5);
+    AssertImageAlmostEqual(restored.renderImage(loaded), scene.renderImage(settings));
+}
+
+TEST(SnapshotTest, RoundTripKeepsNamedCameras) {
+    auto path = snapshotPath("cameras.prsnap");
+    Scene scene = makeScene();
+    scene.addCamera("front", Camera(Point3(0, 1, 5), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 2.0,
+                                    2.0, 24, 32));
+    scene.addCamera("top", Camera(Point3(0, 6, 0.1), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0,
+                                  1.0, 16, 16));
+    scene.save_snapshot(path);
+
+    Scene restored = Scene::load_snapshot(path);
+    EXPECT_EQ(restored.cameraNames(), (std::vector<std::string>{"front", "top"}));
+    const Camera& top = restored.getCamera("top");
+    AssertPointAlmostEqual(top.pos, Point3(0, 6, 0.1));
+    EXPECT_EQ(top.pixel_width, 16);
+    EXPECT_EQ(top.pixel_height, 16);
+}
+
+TEST(SnapshotTest, RoundTripKeepsAnimationAndMemoryBudget) {
+    auto path = snapshotPath("animation.prsnap");
+    Scene scene = makeScene();
+    scene.setMemoryBudget(size_t(64) << 20);
+    Animation animation;
+    animation.setFrameCount(5);
+    animation.setCameraKeys({{0, Point3(0, 1, 5), Point3(0, 0, 0)},
+                             {4, Point3(0, 3, 5), Point3(0, 0, 0)}});
+    TransformKey start;
+    TransformKey end;
+    end.frame = 4;
+    end.translation = Vector3(1, 0, 0);
+    end.angle = M_PI / 2;
+    end.scale = Vector3(2, 2, 2);
+    animation.addTrack(0, Matrix::translation(1, 0, 0), {start, end});
+    scene.setAnimation(animation);
+    scene.save_snapshot(path);
+
+    Scene restored = Scene::load_snapshot(path);
+    EXPECT_EQ(restored.memoryBudget(), size_t(64) << 20);
+    const Animation& loaded = restored.getAnimation();
+    EXPECT_EQ(loaded.frameCount(), 5);
+    AssertPointAlmostEqual(loaded.cameraAt(restored.getCamera(), 2).pos, Point3(0, 2, 5));
+    ASSERT_EQ(loaded.tracks().size(), 1u);
+    EXPECT_EQ(loaded.tracks()[0].object, 0u);
+    AssertPointAlmostEqual(Animation::transformAt(loaded.tracks()[0], 3) * Point3(1, 0, 0),
+                           Animation::transformAt(animation.tracks()[0], 3) * Point3(1, 0, 0));
+}
+
+TEST(SnapshotTest, OutOfCoreMeshIsStoredByItsBackingFile) {
+    auto path = snapshotPath("out_of_core.prsnap");
+    std::vector<Point3> vertices = {Point3(-1, -1, 0), Point3(1, -1, 0), Point3(1, 1, 0),
+                                    Point3(-1, 1, 0)};
+    std::vector<Vector3> normals = {Vector3(0, 0, 1)};
+    std::vector<ObjReader::FaceIndices> faces = {{{0, 1, 2}, {0, 0, 0}}, {{0, 2, 3}, {0, 0, 0}}};
+    Mesh quad(vertices, normals, faces, nullptr);
+    auto paged = OutOfCoreMesh::build(quad, snapshotPath("quad.prclusters"));
+    paged->setMaterial(std::make_shared<Material>(Color(0.2, 0.4, 0.8)));
+    paged->setTransform(Matrix::translation(0, 0.5, -1));
+    Scene scene = makeScene();
+    scene.addObject(std::move(paged));
+    scene.save_snapshot(path);
+
+    Scene restored = Scene::load_snapshot(path);
+    EXPECT_EQ(restored.objectCount(), 5u);
+    AssertImageAlmostEqual(restored.renderImage(RenderSettings()),
+                           scene.renderImage(RenderSettings()));
+}
+
+TEST(SnapshotTest, RoundTripKeepsLevelsOfDetail) {
+    auto path = snapshotPath("lod.prsnap");
+    std::vector<Point3> vertices;
+    std::vector<Vector3> normals;
+    std::vector<ObjReader::FaceIndices> faces;
+    const int n = 16;
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i <= n; ++i) {
+            vertices.emplace_back(i / 8.0 - 1, j / 8.0 - 1, 0.1 * std::sin(i * 0.8 + j * 0.5));
+        }
+    }
+    normals.emplace_back(0, 0, 1);
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            unsigned a = j * (n + 1) + i;
+            faces.push_back({{a, a + 1, a + n + 1}, {0, 0, 0}});
+            faces.push_back({{a + 1, a + n + 2, a + n + 1}, {0, 0, 0}});
+        }
+    }
+    auto mesh = std::make_unique<Mesh>(vertices, normals, faces,
+                                       std::make_shared<Material>(Color(0.2, 0.8, 0.2)));
+    mesh->generateLevels(2);
+    mesh->setLodSettings(LodSettings{40.0, -1});
+    ASSERT_EQ(mesh->levelCount(), 3u);
+    Scene scene = makeScene();
+    scene.addObject(std::move(mesh));
+    scene.save_snapshot(path);
+
+    Scene restored = Scene::load_snapshot(path);
+    auto resaved = snapshotPath("lod_resaved.prsnap");
+    restored.save_snapshot(resaved);
+    EXPECT_EQ(readBytes(path), readBytes(resaved));
+    AssertImageAlmostEqual(restored.renderImage(RenderSettings()),
+                           scene.renderImage(RenderSettings()));
+}
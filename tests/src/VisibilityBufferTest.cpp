@@ -0,0 +1,166 @@
+#include "Prism.hpp"
+
+#include "TestHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Prism;
+
+namespace {
+
+// A unit sphere of stacks x slices quads, with smooth normals
+std::unique_ptr<Mesh> makeSphereMesh(int stacks, int slices, std::shared_ptr<Material> material) {
+    std::vector<Point3> vertices;
+    std::vector<Vector3> normals;
+    for (int i = 0; i <= stacks; ++i) {
+        double theta = M_PI * i / stacks;
+        for (int j = 0; j < slices; ++j) {
+            double phi = 2 * M_PI * j / slices;
+            Vector3 n(std::sin(theta) * std::cos(phi), std::cos(theta),
+                      std::sin(theta) * std::sin(phi));
+            vertices.emplace_back(n.x, n.y, n.z);
+            normals.push_back(n);
+        }
+    }
+    std::vector<ObjReader::FaceIndices> faces;
+    auto index = [&](int i, int j) { return static_cast<unsigned>(i * slices + j % slices); };
+    auto addFace = [&](unsigned a, unsigned b, unsigned c) {
+        ObjReader::FaceIndices face;
+        face.vertex_indices = face.normal_indices = {a, b, c};
+        faces.push_back(face);
+    };
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            if (i > 0) {
+                addFace(index(i, j), index(i, j + 1), index(i + 1, j));
+            }
+            if (i < stacks - 1) {
+                addFace(index(i, j + 1), index(i + 1, j + 1), index(i + 1, j));
+            }
+        }
+    }
+    return std::make_unique<Mesh>(vertices, normals, faces, material);
+}
+
+// A mesh, triangles, spheres and a mirror over a plane, lit by a point light; objects overlap on
+// screen and the mesh pokes through a triangle
+Scene makeScene() {
+    Camera camera(Point3(0, 2, 6), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 40, 40);
+    Scene scene(camera, Color(0.1, 0.1, 0.1));
+    auto red = std::make_shared<Material>(Color(0.8, 0.2, 0.2), Color(0.1, 0.1, 0.1));
+    auto green = std::make_shared<Material>(Color(0.2, 0.8, 0.2), Color(0.1, 0.1, 0.1));
+    auto blue = std::make_shared<Material>(Color(0.2, 0.2, 0.8), Color(0.1, 0.1, 0.1));
+    auto mirror = std::make_shared<Material>(Color(0.1, 0.1, 0.1), Color(0.0, 0.0, 0.0),
+                                             Color(0.9, 0.9, 0.9));
+    scene.addObject(std::make_unique<Plane>(Point3(0, -1, 0), Vector3(0, 1, 0), blue));
+    auto mesh = makeSphereMesh(12, 24, red);
+    mesh->setTransform(Matrix::translation(-0.6, 0.0, 0.0));
+    scene.addObject(std::move(mesh));
+    scene.addObject(std::make_unique<Triangle>(Point3(-2, -1, 0.3), Point3(0.5, -1, 0.3),
+                                               Point3(-0.8, 1.2, 0.3), green));
+    scene.addObject(std::make_unique<Sphere>(Point3(1.0, -0.4, 0.8), 0.6, green));
+    scene.addObject(std::make_unique<Sphere>(Point3(0.6, 0.3, -0.5), 0.5, red));
+    scene.addObject(std::make_unique<Triangle>(Point3(-3, -1, -2), Point3(3, -1, -2),
+                                               Point3(0, 3, -2), mirror));
+    scene.addLight(std::make_unique<Light>(Point3(2, 4, 4), Color(1.0, 1.0, 1.0)));
+    return scene;
+}
+
+} // namespace
+
+TEST(VisibilityBufferTest, ProjectionInvertsCameraRays) {
+    Camera camera(Point3(1, 2, 3), Point3(0, 0, 0), Vector3(0, 1, 0), 1.5, 2.0, 3.0, 60, 90);
+    for (double x : {0.0, 10.5, 45.0, 89.75}) {
+        for (double y : {0.0, 30.25, 59.5}) {
+            Ray ray = camera.rayAt(x, y);
+            double previous = 0.0;
+            for (double t : {0.5, 2.0, 7.0}) {
+                double px = -1.0;
+                double py = -1.0;
+                double depth = camera.project(ray.at(t), px, py);
+                EXPECT_NEAR(px, x, 1e-9);
+                EXPECT_NEAR(py, y, 1e-9);
+                EXPECT_GT(depth, previous);
+                previous = depth;
+            }
+        }
+    }
+    double px = 0.0;
+    double py = 0.0;
+    EXPECT_LT(camera.project(Point3(2, 4, 6), px, py), 0.0);
+}
+
+TEST(VisibilityBufferTest, SamplesMatchRayHits) {
+    Camera camera(Point3(0, 0, 4), Point3(0, 0, 0), Vector3(0, 1, 0), 1.0, 1.0, 1.0, 32, 32);
+    Triangle triangle(Point3(-1, -1, 0), Point3(1.2, -0.5, -1), Point3(-0.2, 1.1, 0.5));
+    Sphere sphere(Point3(0.8, 0.6, 0.5), 0.5, nullptr);
+    Plane plane(Point3(0, 0, -3), Vector3(0, 0, 1), nullptr);
+    VisibilityBuffer buffer(camera, ImageRegion{0, 0, 32, 32});
+    EXPECT_TRUE(buffer.add(0, triangle));
+    EXPECT_TRUE(buffer.add(1, sphere));
+    EXPECT_FALSE(buffer.add(2, plane));
+    EXPECT_TRUE(buffer.covers(0));
+    EXPECT_TRUE(buffer.covers(1));
+    EXPECT_FALSE(buffer.covers(2));
+    EXPECT_GT(buffer.triangleCount(), 1u);
+
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            Ray ray = camera.rayAt(x + 0.5, y + 0.5);
+            const VisibilitySample sample = buffer.at(x, y);
+            HitRecord triangle_hit;
+            HitRecord sphere_hit;
+            bool hits_triangle = triangle.hit(ray, 1e-4, INFINITY, triangle_hit);
+            bool hits_sphere = sphere.hit(ray, 1e-4, INFINITY, sphere_hit);
+            if (hits_sphere) {
+                // Enclosing triangles lie in front of the sphere
+                EXPECT_NE(sample.object, VisibilitySample::kNone) << x << ", " << y;
+                EXPECT_LE(sample.depth, buffer.depthOf(sphere_hit.p) * (1 + 1e-6));
+            }
+            if (!hits_triangle || (hits_sphere && sphere_hit.t < triangle_hit.t)) {
+                continue;
+            }
+            ASSERT_EQ(sample.object, 0u) << x << ", " << y;
+            EXPECT_EQ(sample.primitive, 0u);
+            EXPECT_NEAR(sample.depth, buffer.depthOf(triangle_hit.p), 1e-5);
+            const double b0 = 1.0 - sample.b1 - sample.b2;
+            const Point3 p(-1 * b0 + 1.2 * sample.b1 - 0.2 * sample.b2,
+                           -1 * b0 - 0.5 * sample.b1 + 1.1 * sample.b2,
+                           0 * b0 - 1 * sample.b1 + 0.5 * sample.b2);
+            EXPECT_NEAR(p.x, triangle_hit.p.x, 1e-5) << x << ", " << y;
+            EXPECT_NEAR(p.y, triangle_hit.p.y, 1e-5) << x << ", " << y;
+            EXPECT_NEAR(p.z, triangle_hit.p.z, 1e-5) << x << ", " << y;
+        }
+    }
+
+    // From inside, enclosing triangles would hide the sphere
+    VisibilityBuffer inside(camera, ImageRegion{0, 0, 32, 32});
+    EXPECT_FALSE(inside.add(0, Sphere(Point3(0, 0, 4), 2.0, nullptr)));
+    EXPECT_FALSE(inside.covers(0));
+}
+
+TEST(VisibilityBufferTest, RasterizedRenderMatchesRayTracedRender) {
+    Scene scene = makeScene();
+    RenderSettings settings;
+    settings.tile_size = 8;
+    Framebuffer traced = scene.renderImage(settings);
+    settings.rasterize = true;
+    Framebuffer rasterized = scene.renderImage(settings);
+    AssertImageAlmostEqual(rasterized, traced);
+
+    settings.sampling.min_samples = 1;
+    settings.sampling.max_samples = 4;
+    settings.sampling.contrast_threshold = 0.05;
+    Framebuffer adaptive = scene.renderImage(settings);
+    settings.rasterize = false;
+    AssertImageAlmostEqual(adaptive, scene.renderImage(settings));
+
+    settings.integrator = Integrator::Albedo;
+    Framebuffer albedo = scene.renderImage(settings);
+    settings.rasterize = true;
+    AssertImageAlmostEqual(scene.renderImage(settings), albedo);
+}